@@ -1,21 +1,27 @@
 #include "ada_mounter_helper.h"
+#include "mount_table.h"
+#include "mounter.h"
+#include "mount_scheduler.h"
+#include "mount_options.h"
+#include "unit_generator.h"
+#include "mount_rules.h"
 #include <QFile>
+#include <QFileInfo>
 #include <QTextStream>
-#include <QProcess>
 #include <QSet>
+#include <QRegularExpression>
 #include <QDebug>
 
 // Define the path to manually_enabled.conf
 QString AdaMounterHelper::manuallyEnabledConfPath = "/etc/ada/tolitica/automount/manually_enabled.conf";
 
-// Define the base path for device resolution by UUID
-QString AdaMounterHelper::diskByUUIDPath = "/dev/disk/by-uuid/";
-
 // ----------------------------------------------------------------------------------------------
 // Reads the list of partitions that should be mounted from the config.
-// Expected format: one partition device per line (e.g., "/dev/sda1").
+// Expected format: one partition per line, optionally with a profile:
+//   UUID=<uuid> [options=<opt>,<opt>...] [onaccess [idle=<seconds>]]
+//   FSTYPE=<type> options=<opt>,<opt>...   (applies to every enabled <type>)
 // ----------------------------------------------------------------------------------------------
-QSet<QString> AdaMounterHelper::getManuallyEnabledPartitions() {
+QSet<QString> AdaMounterHelper::getManuallyEnabledPartitions(MountOptions *options) {
     QSet<QString> enabledSet;
     QFile file(manuallyEnabledConfPath);
     if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
@@ -35,9 +41,36 @@ QSet<QString> AdaMounterHelper::getManuallyEnabledPartitions() {
             continue; // Skip empty lines or comments
         }
 
-        // Expect the line to be in the format "UUID=<uuid>"
-        if (line.startsWith("UUID=")) {
-            enabledSet.insert(line);
+        const QStringList fields = line.split(QRegularExpression("\\s+"), Qt::SkipEmptyParts);
+        const QString token = fields.first();
+        QString profile;
+        bool onAccess = false;
+        int idleSeconds = 0;
+        for (int i = 1; i < fields.size(); ++i) {
+            if (fields.at(i).startsWith("options=")) {
+                profile = fields.at(i).mid(8);
+            } else if (fields.at(i) == "onaccess") {
+                onAccess = true;
+            } else if (fields.at(i).startsWith("idle=")) {
+                idleSeconds = fields.at(i).mid(5).toInt();
+            } else {
+                qWarning() << "Ignoring unknown field" << fields.at(i) << "in:" << line;
+            }
+        }
+
+        // Expect the line to be in the format "UUID=<uuid>" or "FSTYPE=<type>"
+        if (token.startsWith("UUID=")) {
+            enabledSet.insert(token);
+            if (options && !profile.isEmpty()) {
+                options->setForUuid(token.mid(5), profile);
+            }
+            if (options && onAccess) {
+                options->setOnAccess(token.mid(5), idleSeconds);
+            }
+        } else if (token.startsWith("FSTYPE=")) {
+            if (options && !profile.isEmpty()) {
+                options->setForFsType(token.mid(7), profile);
+            }
         } else {
             qWarning() << "Invalid configuration format, expected line to start with \"UUID=\": " << line;
         }
@@ -46,158 +79,186 @@ QSet<QString> AdaMounterHelper::getManuallyEnabledPartitions() {
     return enabledSet;
 }
 // ----------------------------------------------------------------------------------------------
-// Uses lsblk to retrieve a set of currently mounted partitions based on UUID.
-// We ask lsblk to output the "UUID", "TYPE", and "MOUNTPOINT" fields.
-// For each partition (type "part") that has a non-empty mountpoint, we store it.
-// - Use "--output" "UUID,TYPE,MOUNTPOINT"
-// - Store mounted partitions as "UUID=<uuid>" for consistency with config.
+// Reads the config once, diffs it against the mount table snapshot (see
+// MountTable; it is kept current from /proc/self/mountinfo) and applies only
+// the resulting mounts and unmounts.
 // ----------------------------------------------------------------------------------------------
-QSet<QString> AdaMounterHelper::getMountedPartitions() {
-    QSet<QString> mountedSet;
-    QProcess process;
-
-    // Use the overload, provide QIODevice::ReadWrite as the third argument.
-    process.start("mount", QStringList(), QIODevice::ReadWrite);
-    process.waitForFinished();
-    QString out = process.readAllStandardOutput();
-
-    // Use the split variant with Qt::SkipEmptyParts
-    QStringList lines = out.split("\n", Qt::SkipEmptyParts);
-
-    for (const QString &line : qAsConst(lines)) {
-        if (!line.contains("/mnt/"))
-            continue;
-        // Expected line format: <device> on <mountpoint> type <fstype> (options)
-        QStringList tokens = line.split(" ", Qt::SkipEmptyParts);
-        if (tokens.size() < 3)
-            continue;
-        QString mountPoint = tokens.at(2);
-        if (mountPoint.startsWith("/mnt/")) {
-            QString rawUUID = mountPoint.section('/', 2, 2);
-            if (!rawUUID.isEmpty()) {
-                mountedSet.insert("UUID=" + rawUUID);
-            }
+void AdaMounterHelper::reconcile(const MountTable &table, MountScheduler &scheduler) {
+    MountOptions options;
+    const QSet<QString> enabled = getManuallyEnabledPartitions(&options);
+    const QSet<QString> mounted = table.managedPartitions();
+
+    // Mounts still queued or in flight for partitions no longer enabled
+    for (const QString &uuid : scheduler.pending()) {
+        if (!enabled.contains("UUID=" + uuid)) {
+            scheduler.cancel(uuid);
         }
     }
-    return mountedSet;
-}
 
+    const QSet<QString> toMount = enabled - mounted;
+    const QSet<QString> toUnmount = mounted - enabled;
+    const QSet<QString> toRemount = changedProfiles(enabled & mounted, options);
+
+    if (toMount.isEmpty() && toUnmount.isEmpty() && toRemount.isEmpty()) {
+        qDebug() << "Mounts already match the configuration";
+        return;
+    }
+    qDebug() << "To mount:" << toMount << "To unmount:" << toUnmount << "To remount:" << toRemount;
 
+    enforceUnmounts(toUnmount);
+    enforceRemounts(toRemount, table, options, scheduler);
+    enforceMounts(toMount, options, scheduler);
+}
 
 // ----------------------------------------------------------------------------------------------
 // Enforces the mounting of partitions using UUID.
-// - For each UUID listed in manually_enabled.conf (e.g., "UUID=<uuid>"):
-//     * If the partition is not mounted, create a mount directory and mount it.
-// - The mount command now dynamically detects the filesystem type using blkid.
+// - Each enabled but unmounted UUID (e.g., "UUID=<uuid>") is queued on the
+//   scheduler, which mounts it on /mnt/<uuid> in parallel with the others,
+//   with the options its profile resolves to.
+// - Device and filesystem type come from DeviceInventory and the mount is done
+//   in-process (see Mounter); no subprocess unless the filesystem needs one.
 // ----------------------------------------------------------------------------------------------
-void AdaMounterHelper::enforceMounts() {
-    QSet<QString> enabled = getManuallyEnabledPartitions();
-    QSet<QString> mounted = getMountedPartitions();
-
-    qDebug() << "Enabled partitions:" << enabled;
-    qDebug() << "Mounted partitions:" << mounted;
-
-    // Iterate over enabled partitions: if not mounted, mount them.
-    for (const QString &uuidLine : qAsConst(enabled)) {
-        if (!mounted.contains(uuidLine)) {
-            // Define a mount directory, e.g., /mnt/ followed by partition identifier.
-            QString uuid = uuidLine.section('=', 1, 1);
-
-            QString mountDir = "/mnt/" + uuid;
-            QProcess mkdirProc, mountProc;
-
-            qDebug() << "Mounting partition with UUID:" << uuidLine << "to" << mountDir;
-
-            // Create the mount directory if it doesn't exist.
-            mkdirProc.start("mkdir", QStringList() << "-p" << mountDir);
-            mkdirProc.waitForFinished();
-
-            // Resolve the actual device path from the UUID using the diskByUUID variable.
-            // Build the symlink path (e.g., "/dev/disk/by-uuid/uuid/dca4b9d7-a0a4-485c-857f-e0b2f2da0206")
-            // Use readlink to resolve the real device path from symlink
-            QString uuidSymlink = diskByUUIDPath + uuid;
-            QProcess readLinkProc;
-            readLinkProc.start("readlink", QStringList() << "-f" << uuidSymlink);
-            readLinkProc.waitForFinished();
-            QString resolvedDevice = QString(readLinkProc.readAllStandardOutput()).trimmed();
-            qDebug() << "Resolved device path:" << resolvedDevice;
-
-            // Detect the filesystem type using blkid:
-            QProcess blkidProc;
-            blkidProc.start("blkid", QStringList() << "-o" << "value" << "-s" << "TYPE" << resolvedDevice);
-            blkidProc.waitForFinished();
-            QString fsType = QString(blkidProc.readAllStandardOutput()).trimmed();
-            if (fsType.isEmpty())
-                fsType = "auto"; // Fallback if detection fails.
-            qDebug() << "Detected filesystem type:" << fsType;
-
-            // Perform the mount using the detected filesystem type.
-            // Note: "UUID=" + uuid produces the proper argument, e.g., "UUID=dca4b9d7"
-            mountProc.start("mount", QStringList() << "-t" << fsType << "UUID=" + uuid << mountDir);
-            mountProc.waitForFinished();
-
-            // Debugging output
-            qDebug() << "Mount command exit code:" << mountProc.exitCode();
-            qDebug() << "Mount stdout:" << mountProc.readAllStandardOutput();
-            qDebug() << "Mount stderr:" << mountProc.readAllStandardError();
-        }
+void AdaMounterHelper::enforceMounts(const QSet<QString> &toMount, const MountOptions &options,
+                                     MountScheduler &scheduler) {
+    for (const QString &uuidLine : toMount) {
+        scheduler.submit(uuidLine.section('=', 1, 1), options);
     }
 }
 
-void AdaMounterHelper::enforceUnmounts() {
-    // Read the current configuration and mounted partitions.
-
-    QSet<QString> enabled = getManuallyEnabledPartitions();
-    QSet<QString> mounted = getMountedPartitions();
-
-    qDebug() << "enforceUnmounts: Enabled partitions:" << enabled;
-    qDebug() << "enforceUnmounts: Mounted partitions" << mounted;
-
+void AdaMounterHelper::enforceUnmounts(const QSet<QString> &toUnmount) {
     // For each mounted partition that is no longer enabled, unmount its mount point.
-    for (const QString &part : qAsConst(mounted)) {
-        if (!enabled.contains(part)) {
-            // Extract the raw UUID from the token (which is stored as "UUID-<rawUUID>")
-            QString rawUUID = part.section('=', 1, 1);
-            // Construct the mount directory (which the mount command uses)
-            QString mountDir = "/mnt/" + rawUUID;
-
-            qDebug() << "Enforcing unmount for:" << mountDir;
-
-            QProcess umountProc;
-            umountProc.start("umount", QStringList() << mountDir);
-            umountProc.waitForFinished();
-            int exitCode = umountProc.exitCode();
-
-            if (exitCode != 0) {
-                qWarning() << "Failed to unmount" << mountDir << "with exit code:" << exitCode;
-            } else {
-                qDebug() << "Successfully unmounted" << mountDir;
-            }
+    for (const QString &part : toUnmount) {
+        // Extract the raw UUID from the token (which is stored as "UUID=<rawUUID>")
+        QString rawUUID = part.section('=', 1, 1);
+        QString mountDir = "/mnt/" + rawUUID;
+
+        qDebug() << "Enforcing unmount for:" << mountDir;
+
+        // An on-access drive is a pair of transient systemd units; stopping
+        // them takes down the trigger along with the mount.
+        QString error;
+        const bool ok = hasAutomount(mountDir) ? Mounter::removeAutomount(mountDir, &error)
+                                               : Mounter::unmount(mountDir, false, &error);
+        if (!ok) {
+            qWarning() << "Failed to unmount" << mountDir << ":" << error;
+        } else {
+            MountRules::forgetApplied(rawUUID.toStdString());
+            qDebug() << "Successfully unmounted" << mountDir;
         }
     }
 }
 
+// ----------------------------------------------------------------------------------------------
+// Profile changes under mounted drives. What each drive was mounted with is
+// recorded (see MountRules::Applied) and compared with what the config
+// resolves to now for the same device: the options, and the mount mode
+// (plain, or on-access with its idle timeout). Without a record only a mode
+// change can be seen, from whether the drive has a trigger.
+// ----------------------------------------------------------------------------------------------
+QSet<QString> AdaMounterHelper::changedProfiles(const QSet<QString> &mounted, const MountOptions &options) {
+    QSet<QString> changed;
+    for (const QString &token : mounted) {
+        const QString uuid = token.section('=', 1, 1);
+        int idleSeconds = 0;
+        const bool onAccess = options.onAccess(uuid, &idleSeconds);
+
+        MountRules::Applied applied;
+        if (!MountRules::readApplied(uuid.toStdString(), &applied)) {
+            if (onAccess != hasAutomount("/mnt/" + uuid)) {
+                changed.insert(token);
+            }
+            continue;
+        }
+        const QString resolved = options.resolve(uuid, QString::fromStdString(applied.device),
+                                                 QString::fromStdString(applied.fsType));
+        if (resolved != QString::fromStdString(applied.options) || onAccess != applied.onAccess
+            || (onAccess && idleSeconds != applied.idleSeconds)) {
+            changed.insert(token);
+        }
+    }
+    return changed;
+}
 
+// ----------------------------------------------------------------------------------------------
+// A change of mount(2) flags only (atime mode, ro, noexec...) on a plain
+// mount is applied in place with MS_REMOUNT. Anything else, a new mount mode
+// or a remount the kernel refuses, takes a fresh mount: the drive is
+// unmounted (or its trigger stopped with systemd-umount) and queued again. A
+// busy drive keeps its old options until the next pass.
+// ----------------------------------------------------------------------------------------------
+void AdaMounterHelper::enforceRemounts(const QSet<QString> &toRemount, const MountTable &table,
+                                       const MountOptions &options, MountScheduler &scheduler) {
+    const QSet<QString> pending = scheduler.pending();
+    for (const QString &token : toRemount) {
+        const QString uuid = token.section('=', 1, 1);
+        const QString mountDir = "/mnt/" + uuid;
+        if (pending.contains(uuid)) {
+            continue;
+        }
+        MountRules::Applied applied;
+        const bool recorded = MountRules::readApplied(uuid.toStdString(), &applied);
+        const QString device = QString::fromStdString(applied.device);
+        const QString resolved = recorded
+            ? options.resolve(uuid, device, QString::fromStdString(applied.fsType)) : QString();
+
+        QString error;
+        if (recorded && !applied.onAccess && !options.onAccess(uuid) && !hasAutomount(mountDir)
+            && MountRules::canRemount(table.entries().value(mountDir).fsType.toStdString(),
+                                      applied.options, resolved.toStdString())) {
+            if (Mounter::remount(device, mountDir, resolved, &error)) {
+                applied.options = resolved.toStdString();
+                MountRules::writeApplied(uuid.toStdString(), applied);
+                continue;
+            }
+            qWarning() << "Failed to remount" << mountDir << ":" << error << "- mounting it afresh";
+        }
 
+        const bool ok = hasAutomount(mountDir) ? Mounter::removeAutomount(mountDir, &error)
+                                               : Mounter::unmount(mountDir, false, &error);
+        if (!ok) {
+            qWarning() << "Cannot apply the new options to" << mountDir << ":" << error;
+            continue;
+        }
+        MountRules::forgetApplied(uuid.toStdString());
+        qDebug() << "Mounting" << mountDir << "again" << (options.onAccess(uuid) ? "on access" : "");
+        scheduler.submit(uuid, options);
+    }
+}
 
+// ----------------------------------------------------------------------------------------------
+// Hotplug. A device that shows up is mounted if its UUID is enabled; one that
+// went away is detached lazily, since its filesystem can't be flushed anyway
+// and a regular unmount would fail on open files.
+// ----------------------------------------------------------------------------------------------
+void AdaMounterHelper::deviceAppeared(const QString &uuid, const QString &device, const QString &fsType,
+                                      const MountTable &table, MountScheduler &scheduler) {
+    const QString mountDir = "/mnt/" + uuid;
+    MountOptions options;
+    if (table.isMounted(mountDir) || !getManuallyEnabledPartitions(&options).contains("UUID=" + uuid)) {
+        return;
+    }
 
+    qDebug() << "Enabled device appeared:" << device << "mounting to" << mountDir;
+    scheduler.submit(uuid, options, device, fsType);
+}
 
+void AdaMounterHelper::deviceRemoved(const QString &uuid, const MountTable &table) {
+    const QString mountDir = "/mnt/" + uuid;
+    // systemd stops an automount along with its device by itself
+    if (!table.managedPartitions().contains("UUID=" + uuid) || hasAutomount(mountDir)) {
+        return;
+    }
 
+    qDebug() << "Device removed, detaching" << mountDir;
 
+    QString error;
+    if (!Mounter::unmount(mountDir, true, &error)) {
+        qWarning() << "Failed to detach" << mountDir << ":" << error;
+    } else {
+        MountRules::forgetApplied(uuid.toStdString());
+    }
+}
 
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
+bool AdaMounterHelper::hasAutomount(const QString &mountDir) {
+    return QFileInfo::exists("/run/systemd/transient/" + UnitGenerator::escapePath(mountDir) + ".automount");
+}
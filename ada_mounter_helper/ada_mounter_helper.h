@@ -4,6 +4,10 @@
 #include <QString>
 #include <QSet>
 
+class MountTable;
+class MountScheduler;
+class MountOptions;
+
 class AdaMounterHelper
 {
 public:
@@ -11,21 +15,35 @@ public:
     static const QString& configPath() { return manuallyEnabledConfPath; }
 
     // Reads the list of partitions that the user explicitly wants mounted
-    // from manually_enabled.conf.
-    static QSet<QString> getManuallyEnabledPartitions();
-
-    // Retrieves a set of currently mounted partitions device names.
-    static QSet<QString> getMountedPartitions();
+    // from manually_enabled.conf. Option profiles found along the way (see
+    // MountOptions) go to options when it's given.
+    static QSet<QString> getManuallyEnabledPartitions(MountOptions *options = nullptr);
 
-    // Enforces the user's desired state:
-    // - Mounts partitions listed in manually_enabled.conf.
+    // Enforces the user's desired state against one mount table snapshot.
+    // The config and the table are diffed once; only the difference is acted on:
+    // - Mounts partitions listed in manually_enabled.conf but not mounted.
     // - Unmounts partitions not listed (but which are currently mounted)
-    static void enforceMounts();
-    static void enforceUnmounts();
+    // - Remounts partitions whose options or mount mode changed since they
+    //   were mounted
+    // Mounts are queued on the scheduler and run in parallel.
+    static void reconcile(const MountTable &table, MountScheduler &scheduler);
+    static void enforceMounts(const QSet<QString> &toMount, const MountOptions &options,
+                              MountScheduler &scheduler);
+    static void enforceUnmounts(const QSet<QString> &toUnmount);
+    static QSet<QString> changedProfiles(const QSet<QString> &mounted, const MountOptions &options);
+    static void enforceRemounts(const QSet<QString> &toRemount, const MountTable &table,
+                                const MountOptions &options, MountScheduler &scheduler);
+
+    // Hotplug: handles just the one device a udev event is about.
+    static void deviceAppeared(const QString &uuid, const QString &device, const QString &fsType,
+                               const MountTable &table, MountScheduler &scheduler);
+    static void deviceRemoved(const QString &uuid, const MountTable &table);
+
+    // Whether mountDir is an on-access drive set up through systemd-mount.
+    static bool hasAutomount(const QString &mountDir);
 
 private:
     static QString manuallyEnabledConfPath;
-    static QString diskByUUIDPath;
 };
 
 #endif // ADA_MOUNTER_HELPER_H
@@ -0,0 +1,61 @@
+#include "block_monitor.h"
+#include <QSocketNotifier>
+#include <QDebug>
+
+#include <libudev.h>
+#include <cstring>
+
+BlockMonitor::BlockMonitor(QObject *parent)
+    : QObject(parent)
+{}
+
+BlockMonitor::~BlockMonitor() {
+    if (m_monitor) {
+        udev_monitor_unref(m_monitor);
+    }
+    if (m_udev) {
+        udev_unref(m_udev);
+    }
+}
+
+bool BlockMonitor::start() {
+    m_udev = udev_new();
+    if (!m_udev) {
+        qWarning() << "Failed to create udev context";
+        return false;
+    }
+
+    // "udev" events are sent once udev has probed the device, so the
+    // filesystem properties (ID_FS_UUID, ID_FS_TYPE) are already attached
+    m_monitor = udev_monitor_new_from_netlink(m_udev, "udev");
+    if (!m_monitor
+        || udev_monitor_filter_add_match_subsystem_devtype(m_monitor, "block", nullptr) < 0
+        || udev_monitor_enable_receiving(m_monitor) < 0) {
+        qWarning() << "Failed to set up the udev block monitor";
+        return false;
+    }
+
+    m_notifier = new QSocketNotifier(udev_monitor_get_fd(m_monitor), QSocketNotifier::Read, this);
+    connect(m_notifier, &QSocketNotifier::activated, this, &BlockMonitor::receive);
+    return true;
+}
+
+void BlockMonitor::receive() {
+    // Drain everything queued on the socket
+    while (struct udev_device *device = udev_monitor_receive_device(m_monitor)) {
+        const char *action = udev_device_get_action(device);
+        const char *uuid = udev_device_get_property_value(device, "ID_FS_UUID");
+        const char *node = udev_device_get_devnode(device);
+
+        if (action && uuid && node) {
+            if (strcmp(action, "add") == 0 || strcmp(action, "change") == 0) {
+                const char *fsType = udev_device_get_property_value(device, "ID_FS_TYPE");
+                emit deviceAppeared(QString::fromLatin1(uuid), QString::fromLocal8Bit(node),
+                                    fsType ? QString::fromLatin1(fsType) : QString());
+            } else if (strcmp(action, "remove") == 0) {
+                emit deviceRemoved(QString::fromLatin1(uuid), QString::fromLocal8Bit(node));
+            }
+        }
+        udev_device_unref(device);
+    }
+}
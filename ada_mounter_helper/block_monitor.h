@@ -0,0 +1,39 @@
+#ifndef BLOCK_MONITOR_H
+#define BLOCK_MONITOR_H
+
+#include <QObject>
+#include <QString>
+
+struct udev;
+struct udev_monitor;
+class QSocketNotifier;
+
+// udev netlink monitor for the "block" subsystem, driven from the event loop
+// through a QSocketNotifier on the monitor's fd. Reports devices carrying a
+// filesystem UUID as they appear and disappear, so a hot-plugged drive is
+// handled on its own without rescanning everything.
+class BlockMonitor : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit BlockMonitor(QObject *parent = nullptr);
+    ~BlockMonitor();
+
+    bool start();
+
+signals:
+    // "add" and "change" (e.g. a filesystem created on the device)
+    void deviceAppeared(const QString &uuid, const QString &device, const QString &fsType);
+    void deviceRemoved(const QString &uuid, const QString &device);
+
+private slots:
+    void receive();
+
+private:
+    struct udev *m_udev = nullptr;
+    struct udev_monitor *m_monitor = nullptr;
+    QSocketNotifier *m_notifier = nullptr;
+};
+
+#endif // BLOCK_MONITOR_H
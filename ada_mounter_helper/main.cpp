@@ -1,43 +1,87 @@
 #include <QCoreApplication>
-#include <QFileSystemWatcher>
+#include <QDBusConnection>
+#include <QDBusError>
 #include <QFileInfo>
 #include <QDebug>
 #include "ada_mounter_helper.h"
+#include "mount_table.h"
+#include "block_monitor.h"
+#include "reconciler.h"
+#include "mount_scheduler.h"
+#include "mounter_service.h"
+#include "unit_generator.h"
 
 int main(int argc, char *argv[])
 {
+    // systemd runs generators with the normal, early and late output
+    // directories, long before there is a bus or anything to watch.
+    if (QFileInfo(QString::fromLocal8Bit(argv[0])).fileName() == "ada-mounter-generator") {
+        if (argc < 2) {
+            return 1;
+        }
+        return UnitGenerator::generate(QString::fromLocal8Bit(argv[1])) ? 0 : 1;
+    }
+
     QCoreApplication a(argc, argv);
 
-    // Get the configuration file path from the helper and its directory.
-    QString configPath = AdaMounterHelper::configPath();
-    QFileInfo configInfo(configPath);
-    QString configDir = configInfo.absolutePath();
-
-    // Set up a file system watcher on the directory.
-    QFileSystemWatcher watcher;
-    watcher.addPath(configDir);
-    qDebug() << "Watching directory:" << configDir;
-
-    // Connect the directoryChanged signal to re-enforce mounts/unmounts.
-    QObject::connect(&watcher, &QFileSystemWatcher::directoryChanged,
-                     [&watcher, configPath](const QString &changedDir) {
-                         Q_UNUSED(changedDir);
-                         qDebug() << "Directory changed. Checking configuration file:" << configPath;
-
-                         // If the configuration file isn't being watched (for example, if it was replaced),
-                         // add it back to the watch list.
-                         if (!watcher.files().contains(configPath)) {
-                             watcher.addPath(configPath);
-                             qDebug() << "Re-added config file to watcher.";
-                         }
-
-                         AdaMounterHelper::enforceMounts();
-                         AdaMounterHelper::enforceUnmounts();
-                     });
+    // Run by ada-mounter-sync.service after the units were regenerated.
+    if (a.arguments().contains("--sync")) {
+        return UnitGenerator::syncUnmounts() ? 0 : 1;
+    }
+
+    if (UnitGenerator::isActive()) {
+        qDebug() << "Managed drives are mounted by the generated systemd units, exiting.";
+        return 0;
+    }
+
+    // Mount table, kept current from /proc/self/mountinfo change events.
+    MountTable mountTable;
+    if (!mountTable.open()) {
+        return 1;
+    }
+
+    // Mounts run in parallel, each with its own deadline and retries.
+    MountScheduler scheduler;
+
+    // Config writes and managed mount table changes are coalesced into one
+    // reconcile pass. A managed drive mounted or unmounted behind our back is
+    // put back in line that way as well.
+    // Without the watch, mount table changes and D-Bus Apply still reconcile.
+    Reconciler reconciler(&mountTable, &scheduler);
+    if (!reconciler.watch(AdaMounterHelper::configPath())) {
+        qWarning() << "Configuration changes are only picked up through D-Bus";
+    }
+
+    // Hot-plugged drives: only the device in the event is looked at.
+    BlockMonitor blockMonitor;
+    if (blockMonitor.start()) {
+        QObject::connect(&blockMonitor, &BlockMonitor::deviceAppeared,
+                         [&mountTable, &scheduler](const QString &uuid, const QString &device, const QString &fsType) {
+                             AdaMounterHelper::deviceAppeared(uuid, device, fsType, mountTable, scheduler);
+                         });
+        QObject::connect(&blockMonitor, &BlockMonitor::deviceRemoved,
+                         [&mountTable, &scheduler](const QString &uuid, const QString &device) {
+                             Q_UNUSED(device);
+                             scheduler.cancel(uuid);
+                             AdaMounterHelper::deviceRemoved(uuid, mountTable);
+                         });
+    }
+
+    // Status and control for the GUI. Mounting doesn't depend on it, so a
+    // missing bus is only worth a warning.
+    MounterService service(&mountTable, &scheduler, &reconciler);
+    QDBusConnection bus = QDBusConnection::systemBus();
+    if (!bus.isConnected()) {
+        qWarning() << "Cannot connect to the system bus:" << bus.lastError().message();
+    } else if (!bus.registerObject(MounterService::objectPath(), &service,
+                                   QDBusConnection::ExportScriptableSlots |
+                                   QDBusConnection::ExportScriptableSignals)
+               || !bus.registerService(MounterService::serviceName())) {
+        qWarning() << "Cannot export" << MounterService::serviceName() << ":" << bus.lastError().message();
+    }
 
     // Enforce the mount/unmount state at startup.
-    AdaMounterHelper::enforceMounts();
-    AdaMounterHelper::enforceUnmounts();
+    AdaMounterHelper::reconcile(mountTable, scheduler);
 
     return a.exec();
 }
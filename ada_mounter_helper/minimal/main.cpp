@@ -0,0 +1,21 @@
+#include "minimal_daemon.h"
+
+#include <unistd.h>
+#include <cstdio>
+
+// Present once the generator of the Qt build has run for this boot
+static const char *const kGeneratedTarget = "/run/systemd/generator/ada-mounts.target";
+
+int main()
+{
+    if (::access(kGeneratedTarget, F_OK) == 0) {
+        fprintf(stderr, "Managed drives are mounted by the generated systemd units, exiting.\n");
+        return 0;
+    }
+
+    MinimalDaemon daemon;
+    if (!daemon.start()) {
+        return 1;
+    }
+    return daemon.run();
+}
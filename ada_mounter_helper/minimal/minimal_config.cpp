@@ -0,0 +1,142 @@
+#include "minimal_config.h"
+#include "mount_rules.h"
+
+#include <cerrno>
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+namespace {
+std::vector<std::string> split(const std::string &text, const char *separators) {
+    std::vector<std::string> parts;
+    size_t start = text.find_first_not_of(separators);
+    while (start != std::string::npos) {
+        const size_t end = text.find_first_of(separators, start);
+        parts.push_back(text.substr(start, end == std::string::npos ? end : end - start));
+        start = text.find_first_not_of(separators, end);
+    }
+    return parts;
+}
+
+bool startsWith(const std::string &text, const char *prefix) {
+    return text.compare(0, strlen(prefix), prefix) == 0;
+}
+
+std::string canonicalPath(const std::string &path) {
+    char resolved[PATH_MAX];
+    return realpath(path.c_str(), resolved) ? std::string(resolved) : std::string();
+}
+}
+
+bool MinimalConfig::load() {
+    m_enabled.clear();
+    m_byFsType.clear();
+    m_byUuid.clear();
+    m_onAccess.clear();
+
+    FILE *file = fopen(path(), "re");
+    if (!file) {
+        fprintf(stderr, "Failed to open %s: %s\n", path(), strerror(errno));
+        return false;
+    }
+
+    char buffer[1024];
+    while (fgets(buffer, sizeof(buffer), file)) {
+        std::string line(buffer);
+        // UTF-8 BOM
+        if (startsWith(line, "\xEF\xBB\xBF")) {
+            line.erase(0, 3);
+        }
+
+        const std::vector<std::string> fields = split(line, " \t\r\n");
+        if (fields.empty() || fields.front()[0] == '#') {
+            continue;
+        }
+
+        const std::string &token = fields.front();
+        std::string profile;
+        bool onAccess = false;
+        int idleSeconds = 0;
+        for (size_t i = 1; i < fields.size(); ++i) {
+            if (startsWith(fields[i], "options=")) {
+                profile = fields[i].substr(8);
+            } else if (fields[i] == "onaccess") {
+                onAccess = true;
+            } else if (startsWith(fields[i], "idle=")) {
+                idleSeconds = atoi(fields[i].c_str() + 5);
+            } else {
+                fprintf(stderr, "Ignoring unknown field %s in: %s\n", fields[i].c_str(), token.c_str());
+            }
+        }
+
+        if (startsWith(token, "UUID=")) {
+            const std::string uuid = token.substr(5);
+            m_enabled.insert(uuid);
+            if (!profile.empty()) {
+                m_byUuid[uuid] = profile;
+            }
+            if (onAccess) {
+                m_onAccess[uuid] = idleSeconds;
+            }
+        } else if (startsWith(token, "FSTYPE=")) {
+            if (!profile.empty()) {
+                m_byFsType[token.substr(7)] = profile;
+            }
+        } else {
+            fprintf(stderr, "Invalid configuration format, expected line to start with \"UUID=\": %s\n",
+                    token.c_str());
+        }
+    }
+    fclose(file);
+    return true;
+}
+
+bool MinimalConfig::onAccess(const std::string &uuid, int *idleSeconds) const {
+    const auto it = m_onAccess.find(uuid);
+    if (it == m_onAccess.end()) {
+        return false;
+    }
+    if (idleSeconds) {
+        *idleSeconds = it->second;
+    }
+    return true;
+}
+
+std::string MinimalConfig::resolve(const std::string &uuid, const std::string &device,
+                                   const std::string &fsType) const {
+    const auto byFsType = m_byFsType.find(fsType);
+    const auto byUuid = m_byUuid.find(uuid);
+    return MountRules::resolve(fsType, rotational(device),
+                               byFsType != m_byFsType.end() ? byFsType->second : std::string(),
+                               byUuid != m_byUuid.end() ? byUuid->second : std::string());
+}
+
+int MinimalConfig::rotational(const std::string &device) {
+    const std::string node = canonicalPath(device);
+    if (node.empty()) {
+        return -1;
+    }
+
+    // /sys/class/block/sda1 links into .../sda/sda1; only the disk has a queue
+    std::string sysPath = canonicalPath("/sys/class/block/" + node.substr(node.rfind('/') + 1));
+    if (sysPath.empty()) {
+        return -1;
+    }
+    FILE *file = fopen((sysPath + "/queue/rotational").c_str(), "re");
+    if (!file) {
+        sysPath.erase(sysPath.rfind('/'));
+        file = fopen((sysPath + "/queue/rotational").c_str(), "re");
+    }
+    if (!file) {
+        return -1;
+    }
+
+    int value = -1;
+    if (fscanf(file, "%d", &value) != 1) {
+        value = -1;
+    }
+    fclose(file);
+    return value;
+}
@@ -0,0 +1,35 @@
+#ifndef MINIMAL_CONFIG_H
+#define MINIMAL_CONFIG_H
+
+#include <map>
+#include <set>
+#include <string>
+
+// manually_enabled.conf for the Qt-free daemon, in the format
+// AdaMounterHelper::getManuallyEnabledPartitions() reads. Options resolve
+// through MountRules like MountOptions does.
+class MinimalConfig
+{
+public:
+    static const char *path() { return "/etc/ada/tolitica/automount/manually_enabled.conf"; }
+
+    // Re-reads the file. A missing file leaves nothing enabled.
+    bool load();
+
+    // Raw UUIDs of the enabled partitions.
+    const std::set<std::string> &enabled() const { return m_enabled; }
+
+    bool onAccess(const std::string &uuid, int *idleSeconds = nullptr) const;
+    std::string resolve(const std::string &uuid, const std::string &device, const std::string &fsType) const;
+
+    // /sys/class/block/<dev>/queue/rotational, -1 when it can't be told.
+    static int rotational(const std::string &device);
+
+private:
+    std::set<std::string> m_enabled;
+    std::map<std::string, std::string> m_byFsType;
+    std::map<std::string, std::string> m_byUuid;
+    std::map<std::string, int> m_onAccess;   // uuid -> idle seconds
+};
+
+#endif // MINIMAL_CONFIG_H
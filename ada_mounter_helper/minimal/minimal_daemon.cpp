@@ -0,0 +1,274 @@
+#include "minimal_daemon.h"
+#include "minimal_config.h"
+#include "minimal_mounter.h"
+#include "mount_rules.h"
+
+#include <sys/epoll.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <sys/timerfd.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+namespace {
+const char *const kMountInfo = "/proc/self/mountinfo";
+const char *const kByUuid = "/dev/disk/by-uuid";
+
+// Same debounce as Reconciler
+const long kDebounceMs = 150;
+
+// mkdir -p
+bool makePath(const std::string &path) {
+    for (size_t slash = path.find('/', 1); ; slash = path.find('/', slash + 1)) {
+        const std::string prefix = path.substr(0, slash);
+        if (::mkdir(prefix.c_str(), 0755) < 0 && errno != EEXIST) {
+            return false;
+        }
+        if (slash == std::string::npos) {
+            return true;
+        }
+    }
+}
+
+bool addToEpoll(int epollFd, int fd, uint32_t events) {
+    struct epoll_event event = {};
+    event.events = events;
+    event.data.fd = fd;
+    return ::epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event) == 0;
+}
+}
+
+MinimalDaemon::~MinimalDaemon() {
+    for (int fd : {m_epollFd, m_inotifyFd, m_mountInfoFd, m_timerFd}) {
+        if (fd >= 0) {
+            ::close(fd);
+        }
+    }
+}
+
+bool MinimalDaemon::start() {
+    m_epollFd = ::epoll_create1(EPOLL_CLOEXEC);
+    m_timerFd = ::timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    m_inotifyFd = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    m_mountInfoFd = ::open(kMountInfo, O_RDONLY | O_CLOEXEC);
+    if (m_epollFd < 0 || m_timerFd < 0 || m_inotifyFd < 0 || m_mountInfoFd < 0) {
+        fprintf(stderr, "Failed to set up the event loop: %s\n", strerror(errno));
+        return false;
+    }
+
+    // The directory is watched, not the file, so a config replaced by
+    // rename() is still seen. On a fresh install Tolitica hasn't written it
+    // yet, so it is made here; without the watch mount table changes still
+    // reconcile.
+    const std::string configPath = MinimalConfig::path();
+    const std::string configDir = configPath.substr(0, configPath.rfind('/'));
+    m_configName = configPath.substr(configPath.rfind('/') + 1);
+    if (!makePath(configDir)) {
+        fprintf(stderr, "Failed to create %s: %s\n", configDir.c_str(), strerror(errno));
+    }
+    m_configWatch = ::inotify_add_watch(m_inotifyFd, configDir.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+    if (m_configWatch < 0) {
+        fprintf(stderr, "Failed to watch %s: %s\n", configDir.c_str(), strerror(errno));
+    }
+
+    // Hotplug works without it, just not until the next config change
+    m_deviceWatch = ::inotify_add_watch(m_inotifyFd, kByUuid, IN_CREATE | IN_MOVED_TO | IN_DELETE);
+    if (m_deviceWatch < 0) {
+        fprintf(stderr, "Failed to watch %s: %s\n", kByUuid, strerror(errno));
+    }
+
+    readMountInfo();
+
+    // The kernel flags mountinfo with POLLPRI|POLLERR when the table changes
+    if (!addToEpoll(m_epollFd, m_mountInfoFd, EPOLLPRI)
+        || !addToEpoll(m_epollFd, m_inotifyFd, EPOLLIN)
+        || !addToEpoll(m_epollFd, m_timerFd, EPOLLIN)) {
+        fprintf(stderr, "epoll_ctl failed: %s\n", strerror(errno));
+        return false;
+    }
+
+    reconcile();
+    return true;
+}
+
+int MinimalDaemon::run() {
+    for (;;) {
+        struct epoll_event events[4];
+        const int count = ::epoll_wait(m_epollFd, events, 4, -1);
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        if (count < 0) {
+            fprintf(stderr, "epoll_wait failed: %s\n", strerror(errno));
+            return 1;
+        }
+
+        for (int i = 0; i < count; ++i) {
+            const int fd = events[i].data.fd;
+            if (fd == m_mountInfoFd) {
+                // Our own mounts land here too; the pass they trigger finds
+                // nothing left to do
+                if (readMountInfo()) {
+                    schedule();
+                }
+            } else if (fd == m_inotifyFd) {
+                readInotify();
+            } else if (fd == m_timerFd) {
+                uint64_t expirations;
+                if (::read(m_timerFd, &expirations, sizeof(expirations)) == sizeof(expirations)) {
+                    reconcile();
+                }
+            }
+        }
+    }
+}
+
+// ----------------------------------------------------------------------------------------------
+// Reading from offset 0 both fetches the table and re-arms the event.
+// Returns whether anything under /mnt/<uuid> changed.
+// ----------------------------------------------------------------------------------------------
+bool MinimalDaemon::readMountInfo() {
+    std::string data;
+    char buffer[16384];
+    off_t offset = 0;
+    ssize_t count;
+    while ((count = ::pread(m_mountInfoFd, buffer, sizeof(buffer), offset)) > 0) {
+        data.append(buffer, size_t(count));
+        offset += count;
+    }
+    if (count < 0) {
+        fprintf(stderr, "Failed to read %s: %s\n", kMountInfo, strerror(errno));
+        return false;
+    }
+
+    std::map<std::string, std::string> mounted = MinimalMounter::managedMounts(data);
+    if (mounted == m_mounted) {
+        return false;
+    }
+    m_mounted.swap(mounted);
+    return true;
+}
+
+void MinimalDaemon::readInotify() {
+    alignas(struct inotify_event) char buffer[4096];
+    ssize_t length;
+
+    while ((length = ::read(m_inotifyFd, buffer, sizeof(buffer))) > 0) {
+        for (char *ptr = buffer; ptr < buffer + length;) {
+            const struct inotify_event *event = reinterpret_cast<const struct inotify_event *>(ptr);
+            ptr += sizeof(struct inotify_event) + event->len;
+            if (event->len == 0) {
+                continue;
+            }
+
+            const std::string name = event->name;
+            if (event->wd == m_configWatch && name == m_configName) {
+                fprintf(stderr, "Configuration file written: %s\n", name.c_str());
+                schedule();
+            } else if (event->wd == m_deviceWatch && !(event->mask & IN_DELETE)) {
+                schedule();
+            } else if (event->wd == m_deviceWatch) {
+                // A device that went away is detached lazily, since its
+                // filesystem can't be flushed anyway. systemd stops an
+                // automount along with its device by itself.
+                const std::string link = std::string(kByUuid) + "/" + name;
+                if (m_mounted.count(name) == 0 || MinimalMounter::hasAutomount(name)
+                    || ::access(link.c_str(), F_OK) == 0) {
+                    continue;
+                }
+                fprintf(stderr, "Device removed, detaching /mnt/%s\n", name.c_str());
+                std::string error;
+                if (!MinimalMounter::unmount(name, true, &error)) {
+                    fprintf(stderr, "Failed to detach /mnt/%s: %s\n", name.c_str(), error.c_str());
+                }
+            }
+        }
+    }
+}
+
+void MinimalDaemon::schedule() {
+    // Re-arming the timer pushes the pass back until events stop arriving
+    struct itimerspec delay = {};
+    delay.it_value.tv_nsec = kDebounceMs * 1000000;
+    ::timerfd_settime(m_timerFd, 0, &delay, nullptr);
+}
+
+// ----------------------------------------------------------------------------------------------
+// See AdaMounterHelper::reconcile(): the config is diffed once against the
+// mount table and only the difference is acted on.
+// ----------------------------------------------------------------------------------------------
+void MinimalDaemon::reconcile() {
+    MinimalConfig config;
+    config.load();
+
+    for (const auto &mount : m_mounted) {
+        if (config.enabled().count(mount.first) != 0) {
+            continue;
+        }
+        fprintf(stderr, "Enforcing unmount for: /mnt/%s\n", mount.first.c_str());
+        std::string error;
+        if (!MinimalMounter::unmount(mount.first, false, &error)) {
+            fprintf(stderr, "Failed to unmount /mnt/%s: %s\n", mount.first.c_str(), error.c_str());
+        }
+    }
+
+    for (const std::string &uuid : config.enabled()) {
+        const auto mounted = m_mounted.find(uuid);
+        if (mounted != m_mounted.end() && applyProfile(uuid, mounted->second, config)) {
+            continue;
+        }
+        std::string error;
+        if (!MinimalMounter::mount(uuid, config, &error)) {
+            fprintf(stderr, "Failed to mount %s: %s\n", uuid.c_str(), error.c_str());
+        }
+    }
+}
+
+// ----------------------------------------------------------------------------------------------
+// See AdaMounterHelper::changedProfiles() and enforceRemounts(): a mounted
+// drive whose options or mount mode changed is remounted in place when only
+// mount(2) flags of a plain mount differ, and is otherwise unmounted (or its
+// trigger stopped) for a fresh mount. Returns whether the drive stays as it
+// is mounted now.
+// ----------------------------------------------------------------------------------------------
+bool MinimalDaemon::applyProfile(const std::string &uuid, const std::string &mountedFsType,
+                                 const MinimalConfig &config) {
+    int idleSeconds = 0;
+    const bool onAccess = config.onAccess(uuid, &idleSeconds);
+    const bool triggered = MinimalMounter::hasAutomount(uuid);
+
+    MountRules::Applied applied;
+    const bool recorded = MountRules::readApplied(uuid, &applied);
+    std::string options;
+    if (recorded) {
+        options = config.resolve(uuid, applied.device, applied.fsType);
+        if (options == applied.options && onAccess == applied.onAccess
+            && (!onAccess || idleSeconds == applied.idleSeconds)) {
+            return true;
+        }
+    } else if (onAccess == triggered) {
+        return true;
+    }
+
+    std::string error;
+    if (recorded && !applied.onAccess && !onAccess && !triggered
+        && MountRules::canRemount(mountedFsType, applied.options, options)) {
+        if (MinimalMounter::remount(uuid, applied.device, options, &error)) {
+            applied.options = options;
+            MountRules::writeApplied(uuid, applied);
+            return true;
+        }
+        fprintf(stderr, "Failed to remount /mnt/%s: %s - mounting it afresh\n", uuid.c_str(), error.c_str());
+    }
+
+    if (!MinimalMounter::unmount(uuid, false, &error)) {
+        fprintf(stderr, "Cannot apply the new options to /mnt/%s: %s\n", uuid.c_str(), error.c_str());
+        return true;
+    }
+    fprintf(stderr, "Mounting /mnt/%s again%s\n", uuid.c_str(), onAccess ? " on access" : "");
+    return false;
+}
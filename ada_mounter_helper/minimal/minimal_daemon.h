@@ -0,0 +1,46 @@
+#ifndef MINIMAL_DAEMON_H
+#define MINIMAL_DAEMON_H
+
+#include <map>
+#include <string>
+
+class MinimalConfig;
+
+// The Qt-free ada_mounter_helper: one epoll loop over four descriptors.
+//  - inotify on the config's directory (IN_CLOSE_WRITE / IN_MOVED_TO) and on
+//    /dev/disk/by-uuid, where udev adds and removes a link per filesystem,
+//    which stands in for the libudev monitor
+//  - /proc/self/mountinfo, which raises EPOLLPRI on every mount or unmount
+//  - a timerfd that coalesces all of the above into one reconcile pass
+//
+// Behavior matches the Qt daemon minus its extras: no D-Bus interface and no
+// generator mode, and mounts run one after the other instead of on a worker
+// pool. A mount that fails is retried on the next pass.
+class MinimalDaemon
+{
+public:
+    ~MinimalDaemon();
+
+    // Opens and registers all descriptors and does the startup pass.
+    bool start();
+    int run();
+
+private:
+    bool readMountInfo();
+    void readInotify();
+    void schedule();
+    void reconcile();
+    static bool applyProfile(const std::string &uuid, const std::string &mountedFsType,
+                             const MinimalConfig &config);
+
+    int m_epollFd = -1;
+    int m_inotifyFd = -1;
+    int m_mountInfoFd = -1;
+    int m_timerFd = -1;
+    int m_configWatch = -1;
+    int m_deviceWatch = -1;
+    std::string m_configName;
+    std::map<std::string, std::string> m_mounted;   // uuid -> fs type
+};
+
+#endif // MINIMAL_DAEMON_H
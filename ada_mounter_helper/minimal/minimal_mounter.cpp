@@ -0,0 +1,346 @@
+#include "minimal_mounter.h"
+#include "minimal_config.h"
+#include "mount_info.h"
+#include "mount_rules.h"
+
+#include <sys/mount.h>
+#include <sys/stat.h>
+#include <sys/sysmacros.h>
+#include <sys/wait.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <spawn.h>
+#include <unistd.h>
+#include <cerrno>
+#include <climits>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <strings.h>
+
+extern char **environ;
+
+namespace {
+// A helper (FUSE mount, systemd-mount) that hasn't finished by then is killed
+const int kHelperTimeoutMs = 15000;
+
+std::string systemError(const char *call) {
+    return std::string(call) + ": " + strerror(errno);
+}
+
+bool exists(const std::string &path) {
+    return ::access(path.c_str(), F_OK) == 0;
+}
+
+long elapsedMs(const struct timespec &start) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (now.tv_sec - start.tv_sec) * 1000 + (now.tv_nsec - start.tv_nsec) / 1000000;
+}
+}
+
+// ----------------------------------------------------------------------------------------------
+// Only /mnt/<uuid> itself is kept, and for stacked mounts the last one listed
+// (the visible one) wins.
+// ----------------------------------------------------------------------------------------------
+std::map<std::string, std::string> MinimalMounter::managedMounts(const std::string &mountinfo) {
+    std::map<std::string, std::string> mounts;
+    for (const MountInfo::Entry &entry : MountInfo::parse(mountinfo)) {
+        const std::string uuid = MountRules::managedUuid(entry.mountPoint);
+        if (uuid.empty()) {
+            continue;
+        }
+        if (isManaged(uuid, entry.fsType, entry.source)) {
+            mounts[uuid] = entry.fsType;
+        } else {
+            mounts.erase(uuid);
+        }
+    }
+    return mounts;
+}
+
+// ----------------------------------------------------------------------------------------------
+// Same rules as MountTable::isManaged(): /mnt/<uuid> is ours when it holds
+// the filesystem with that UUID or an on-access trigger, or when its device
+// node is gone (the stale mount is still cleaned up).
+// ----------------------------------------------------------------------------------------------
+bool MinimalMounter::isManaged(const std::string &uuid, const std::string &fsType, const std::string &source) {
+    if (fsType == "autofs") {
+        return true;
+    }
+    if (source.compare(0, 5, "/dev/") != 0) {
+        return false;
+    }
+
+    struct stat sourceInfo;
+    if (::stat(source.c_str(), &sourceInfo) < 0) {
+        return errno == ENOENT;
+    }
+    if (!S_ISBLK(sourceInfo.st_mode)) {
+        return false;
+    }
+
+    // The by-uuid link, or else the UUID udev recorded for the source
+    struct stat linkInfo;
+    if (::stat(("/dev/disk/by-uuid/" + uuid).c_str(), &linkInfo) == 0) {
+        return S_ISBLK(linkInfo.st_mode) && linkInfo.st_rdev == sourceInfo.st_rdev;
+    }
+    char dataPath[64];
+    snprintf(dataPath, sizeof(dataPath), "/run/udev/data/b%u:%u",
+             major(sourceInfo.st_rdev), minor(sourceInfo.st_rdev));
+    FILE *file = fopen(dataPath, "re");
+    if (!file) {
+        return false;
+    }
+    bool matches = false;
+    char line[512];
+    while (fgets(line, sizeof(line), file)) {
+        if (strncmp(line, "E:ID_FS_UUID=", 13) == 0) {
+            const std::string recorded(line + 13, strcspn(line + 13, "\n"));
+            matches = strcasecmp(recorded.c_str(), uuid.c_str()) == 0;
+            break;
+        }
+    }
+    fclose(file);
+    return matches;
+}
+
+// ----------------------------------------------------------------------------------------------
+// UUID -> device node through its by-uuid link, filesystem type from the
+// E:ID_FS_TYPE= line udev keeps for the device (b<major>:<minor>).
+// ----------------------------------------------------------------------------------------------
+bool MinimalMounter::resolve(const std::string &uuid, std::string *device, std::string *fsType) {
+    char resolved[PATH_MAX];
+    struct stat info;
+    if (!realpath(("/dev/disk/by-uuid/" + uuid).c_str(), resolved) || ::stat(resolved, &info) < 0
+        || !S_ISBLK(info.st_mode)) {
+        return false;
+    }
+    *device = resolved;
+    fsType->clear();
+
+    char dataPath[64];
+    snprintf(dataPath, sizeof(dataPath), "/run/udev/data/b%u:%u", major(info.st_rdev), minor(info.st_rdev));
+    FILE *file = fopen(dataPath, "re");
+    if (!file) {
+        return true;
+    }
+    char line[512];
+    while (fgets(line, sizeof(line), file)) {
+        if (strncmp(line, "E:ID_FS_TYPE=", 13) == 0) {
+            *fsType = std::string(line + 13, strcspn(line + 13, "\n"));
+            break;
+        }
+    }
+    fclose(file);
+    return true;
+}
+
+bool MinimalMounter::makeMountDir(const std::string &mountDir, std::string *error) {
+    const std::string parent = mountDir.substr(0, mountDir.rfind('/'));
+    if ((::mkdir(parent.c_str(), 0755) < 0 && errno != EEXIST)
+        || (::mkdir(mountDir.c_str(), 0755) < 0 && errno != EEXIST)) {
+        *error = systemError("mkdir");
+        return false;
+    }
+    return true;
+}
+
+// ----------------------------------------------------------------------------------------------
+// Runs a helper with posix_spawn, its stderr becoming the error message.
+// Killed once kHelperTimeoutMs is up.
+// ----------------------------------------------------------------------------------------------
+bool MinimalMounter::runHelper(const std::vector<std::string> &arguments, std::string *error) {
+    int pipeFds[2];
+    if (::pipe2(pipeFds, O_CLOEXEC) < 0) {
+        *error = systemError("pipe2");
+        return false;
+    }
+
+    std::vector<char *> argv;
+    for (const std::string &argument : arguments) {
+        argv.push_back(const_cast<char *>(argument.c_str()));
+    }
+    argv.push_back(nullptr);
+
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_adddup2(&actions, pipeFds[1], STDERR_FILENO);
+
+    pid_t pid;
+    const int result = posix_spawnp(&pid, argv[0], &actions, nullptr, argv.data(), environ);
+    posix_spawn_file_actions_destroy(&actions);
+    ::close(pipeFds[1]);
+    if (result != 0) {
+        ::close(pipeFds[0]);
+        *error = arguments.front() + ": " + strerror(result);
+        return false;
+    }
+
+    // Collect stderr while waiting. The exit is polled for as well, since a
+    // FUSE helper may leave a daemon behind that still holds the pipe.
+    std::string output;
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    int status = 0;
+    bool timedOut = false;
+    bool pipeOpen = true;
+    for (;;) {
+        char buffer[512];
+        // poll() ignores a negative fd, which makes it a plain sleep after EOF
+        struct pollfd pollFd = {pipeOpen ? pipeFds[0] : -1, POLLIN, 0};
+        if (::poll(&pollFd, 1, 100) > 0) {
+            const ssize_t count = ::read(pipeFds[0], buffer, sizeof(buffer));
+            if (count > 0) {
+                output.append(buffer, size_t(count));
+                continue;
+            }
+            pipeOpen = count < 0 && errno == EINTR;
+        }
+        if (::waitpid(pid, &status, WNOHANG) == pid) {
+            break;
+        }
+        if (elapsedMs(start) >= kHelperTimeoutMs) {
+            timedOut = true;
+            ::kill(pid, SIGKILL);
+            while (::waitpid(pid, &status, 0) < 0 && errno == EINTR) {
+            }
+            break;
+        }
+    }
+    ::close(pipeFds[0]);
+
+    if (timedOut) {
+        *error = arguments.front() + " timed out";
+        return false;
+    }
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+        *error = output.substr(0, output.find_last_not_of(" \n") + 1);
+        return false;
+    }
+    return true;
+}
+
+bool MinimalMounter::hasAutomount(const std::string &uuid) {
+    return exists("/run/systemd/transient/" + MountRules::escapePath("/mnt/" + uuid) + ".automount");
+}
+
+// ----------------------------------------------------------------------------------------------
+// Mirrors Mounter::mountDevice() and Mounter::automount(): mount(2) with the
+// resolved profile, ntfs3 in preference to ntfs-3g, helpers only for
+// filesystems that have one, and systemd-mount for on-access drives.
+// ----------------------------------------------------------------------------------------------
+bool MinimalMounter::mount(const std::string &uuid, const MinimalConfig &config, std::string *error) {
+    std::string device, fsType;
+    if (!resolve(uuid, &device, &fsType)) {
+        *error = "No device with UUID " + uuid;
+        return false;
+    }
+    if (fsType.empty()) {
+        *error = "Unknown filesystem on " + device;
+        return false;
+    }
+    const std::string options = config.resolve(uuid, device, fsType);
+    if (!mountDevice(uuid, device, fsType, options, config, error)) {
+        return false;
+    }
+
+    MountRules::Applied applied;
+    applied.device = device;
+    applied.fsType = fsType;
+    applied.options = options;
+    applied.onAccess = config.onAccess(uuid, &applied.idleSeconds);
+    if (!MountRules::writeApplied(uuid, applied)) {
+        fprintf(stderr, "Failed to record the options of %s\n", uuid.c_str());
+    }
+    return true;
+}
+
+bool MinimalMounter::mountDevice(const std::string &uuid, const std::string &device, const std::string &fsType,
+                                 const std::string &options, const MinimalConfig &config, std::string *error) {
+    const std::string mountDir = "/mnt/" + uuid;
+    int idleSeconds = 0;
+    if (config.onAccess(uuid, &idleSeconds)) {
+        std::vector<std::string> arguments = {"systemd-mount", "--automount=yes", "--collect", "--fsck=no"};
+        arguments.push_back("--type=" + MountRules::kernelType(fsType));
+        if (!options.empty()) {
+            arguments.push_back("--options=" + options);
+        }
+        if (idleSeconds > 0) {
+            arguments.push_back("--timeout-idle-sec=" + std::to_string(idleSeconds));
+        }
+        arguments.push_back("/dev/disk/by-uuid/" + uuid);
+        arguments.push_back(mountDir);
+        return runHelper(arguments, error);
+    }
+
+    if (!makeMountDir(mountDir, error)) {
+        return false;
+    }
+
+    std::string data;
+    const unsigned long flags = MountRules::toFlags(options, &data);
+    const char *dataArg = data.empty() ? nullptr : data.c_str();
+
+    std::string helperType = fsType;
+    if (fsType == "ntfs") {
+        if (::mount(device.c_str(), mountDir.c_str(), "ntfs3", flags, dataArg) == 0) {
+            fprintf(stderr, "Mounted %s with ntfs3, options %s\n", device.c_str(), options.c_str());
+            return true;
+        }
+        if (errno != ENODEV) {
+            *error = systemError("mount");
+            return false;
+        }
+        helperType = "ntfs-3g";
+    }
+
+    if (helperType != fsType || MountRules::needsHelper(fsType)) {
+        std::vector<std::string> arguments = {"mount", "-t", helperType};
+        if (!options.empty()) {
+            arguments.push_back("-o");
+            arguments.push_back(options);
+        }
+        arguments.push_back(device);
+        arguments.push_back(mountDir);
+        return runHelper(arguments, error);
+    }
+
+    if (::mount(device.c_str(), mountDir.c_str(), fsType.c_str(), flags, dataArg) < 0) {
+        *error = systemError("mount");
+        return false;
+    }
+    fprintf(stderr, "Mounted %s with options %s\n", device.c_str(), options.c_str());
+    return true;
+}
+
+bool MinimalMounter::remount(const std::string &uuid, const std::string &device, const std::string &options,
+                             std::string *error) {
+    const std::string mountDir = "/mnt/" + uuid;
+    std::string data;
+    const unsigned long flags = MountRules::toFlags(options, &data);
+    if (::mount(device.c_str(), mountDir.c_str(), nullptr, MS_REMOUNT | flags,
+                data.empty() ? nullptr : data.c_str()) < 0) {
+        *error = systemError("mount");
+        return false;
+    }
+    fprintf(stderr, "Remounted %s with options %s\n", mountDir.c_str(), options.c_str());
+    return true;
+}
+
+bool MinimalMounter::unmount(const std::string &uuid, bool lazy, std::string *error) {
+    const std::string mountDir = "/mnt/" + uuid;
+    // Stopping the transient units takes down the trigger along with the mount
+    if (hasAutomount(uuid)) {
+        if (!runHelper({"systemd-umount", mountDir}, error)) {
+            return false;
+        }
+    } else if (::umount2(mountDir.c_str(), lazy ? MNT_DETACH : 0) < 0) {
+        *error = systemError("umount2");
+        return false;
+    }
+    MountRules::forgetApplied(uuid);
+    return true;
+}
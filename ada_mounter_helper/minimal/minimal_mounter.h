@@ -0,0 +1,46 @@
+#ifndef MINIMAL_MOUNTER_H
+#define MINIMAL_MOUNTER_H
+
+#include <map>
+#include <string>
+#include <vector>
+
+class MinimalConfig;
+
+// Mounting for the Qt-free daemon, the counterpart of Mounter and MountTable.
+// Devices are found through udev's /dev/disk/by-uuid links and the
+// filesystem type through udev's database in /run/udev/data, which is where
+// blkid's probe results end up anyway, so neither libblkid nor libudev is
+// linked in.
+class MinimalMounter
+{
+public:
+    // uuid -> filesystem type for everything the daemon mounted on
+    // /mnt/<uuid>, read from a /proc/self/mountinfo snapshot; other mounts
+    // there are left alone. An on-access drive shows up as "autofs" until it
+    // is accessed.
+    static std::map<std::string, std::string> managedMounts(const std::string &mountinfo);
+
+    static bool resolve(const std::string &uuid, std::string *device, std::string *fsType);
+
+    // Mounts uuid on /mnt/<uuid>, or sets up its on-access trigger.
+    static bool mount(const std::string &uuid, const MinimalConfig &config, std::string *error);
+    static bool unmount(const std::string &uuid, bool lazy, std::string *error);
+
+    // MS_REMOUNT of /mnt/<uuid> with a new option list that differs from the
+    // mounted one in mount(2) flags only (see MountRules::canRemount()).
+    static bool remount(const std::string &uuid, const std::string &device, const std::string &options,
+                        std::string *error);
+
+    // Whether /mnt/<uuid> is an on-access drive set up through systemd-mount.
+    static bool hasAutomount(const std::string &uuid);
+
+private:
+    static bool isManaged(const std::string &uuid, const std::string &fsType, const std::string &source);
+    static bool mountDevice(const std::string &uuid, const std::string &device, const std::string &fsType,
+                            const std::string &options, const MinimalConfig &config, std::string *error);
+    static bool makeMountDir(const std::string &mountDir, std::string *error);
+    static bool runHelper(const std::vector<std::string> &arguments, std::string *error);
+};
+
+#endif // MINIMAL_MOUNTER_H
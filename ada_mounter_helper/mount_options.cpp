@@ -0,0 +1,74 @@
+#include "mount_options.h"
+#include "device_inventory.h"
+#include "mount_rules.h"
+
+void MountOptions::setForFsType(const QString &fsType, const QString &options) {
+    m_byFsType.insert(fsType, options);
+}
+
+void MountOptions::setForUuid(const QString &uuid, const QString &options) {
+    m_byUuid.insert(uuid, options);
+}
+
+void MountOptions::setOnAccess(const QString &uuid, int idleSeconds) {
+    m_onAccess.insert(uuid, idleSeconds);
+}
+
+bool MountOptions::onAccess(const QString &uuid, int *idleSeconds) const {
+    const auto it = m_onAccess.constFind(uuid);
+    if (it == m_onAccess.cend()) {
+        return false;
+    }
+    if (idleSeconds) {
+        *idleSeconds = it.value();
+    }
+    return true;
+}
+
+int MountOptions::rotational(const QString &device) {
+    return DeviceInventory::rotational(device);
+}
+
+QString MountOptions::resolve(const QString &uuid, const QString &device, const QString &fsType) const {
+    return QString::fromStdString(MountRules::resolve(fsType.toStdString(), rotational(device),
+                                                      m_byFsType.value(fsType).toStdString(),
+                                                      m_byUuid.value(uuid).toStdString()));
+}
+
+unsigned long MountOptions::toFlags(const QString &options, QByteArray *data) {
+    std::string rest;
+    const unsigned long flags = MountRules::toFlags(options.toStdString(), &rest);
+    *data = QByteArray::fromStdString(rest);
+    return flags;
+}
+QString MountOptions::resolve(const QString &uuid, const QString &device, const QString &fsType) const {
+    QStringList options;
+    merge(&options, builtinOptions(fsType));
+    merge(&options, mediaOptions(fsType, rotational(device)));
+    merge(&options, m_byFsType.value(fsType));
+    merge(&options, m_byUuid.value(uuid));
+    return options.join(',');
+}
+
+unsigned long MountOptions::toFlags(const QString &options, QByteArray *data) {
+    unsigned long flags = 0;
+    QStringList rest;
+
+    const QStringList list = options.split(',', Qt::SkipEmptyParts);
+    for (const QString &option : list) {
+        bool isFlag = false;
+        for (const FlagOption &flagOption : kFlagOptions) {
+            if (option == QLatin1String(flagOption.name)) {
+                flags = flagOption.clear ? flags & ~flagOption.flag : flags | flagOption.flag;
+                isFlag = true;
+                break;
+            }
+        }
+        if (!isFlag) {
+            rest.append(option);
+        }
+    }
+
+    *data = rest.join(',').toLatin1();
+    return flags;
+}
@@ -0,0 +1,50 @@
+#ifndef MOUNT_OPTIONS_H
+#define MOUNT_OPTIONS_H
+
+#include <QString>
+#include <QHash>
+#include <QByteArray>
+
+// Mount option profiles. manually_enabled.conf may carry options for one
+// partition or for every partition of a filesystem type:
+//   UUID=<uuid> options=noatime,compress=zstd:3
+//   FSTYPE=btrfs options=noatime,compress=zstd
+// A plain "UUID=<uuid>" line gets the automatic profile: built-in defaults
+// for its filesystem plus discard/commit tuning picked from the device's
+// rotational flag. FSTYPE options override those and UUID options override
+// both, option by option (so "relatime" replaces "noatime", "nodiscard"
+// replaces "discard=async", and so on).
+//
+// A UUID line may also ask for on-access mounting, optionally unmounting
+// again after some idle seconds so the drive can spin down:
+//   UUID=<uuid> onaccess idle=600
+class MountOptions
+{
+public:
+    void setForFsType(const QString &fsType, const QString &options);
+    void setForUuid(const QString &uuid, const QString &options);
+    void setOnAccess(const QString &uuid, int idleSeconds);
+
+    // Whether uuid gets an automount trigger instead of a mount; idleSeconds
+    // is 0 when it stays mounted once accessed.
+    bool onAccess(const QString &uuid, int *idleSeconds = nullptr) const;
+
+    // The option list a device gets mounted with, comma separated (see
+    // MountRules::resolve()).
+    QString resolve(const QString &uuid, const QString &device, const QString &fsType) const;
+
+    // Splits an option list into mount(2) flags and the filesystem specific
+    // data string.
+    static unsigned long toFlags(const QString &options, QByteArray *data);
+
+    // The device's rotational flag from sysfs (see DeviceInventory);
+    // partitions use their disk's. Returns -1 when it can't be told.
+    static int rotational(const QString &device);
+
+private:
+    QHash<QString, QString> m_byFsType;
+    QHash<QString, QString> m_byUuid;
+    QHash<QString, int> m_onAccess;     // uuid -> idle seconds
+};
+
+#endif // MOUNT_OPTIONS_H
@@ -0,0 +1,310 @@
+#include "mount_rules.h"
+
+#include <sys/mount.h>
+#include <sys/stat.h>
+#include <sys/utsname.h>
+#include <unistd.h>
+#include <cctype>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#ifndef MS_LAZYTIME
+#define MS_LAZYTIME (1 << 25)
+#endif
+
+namespace {
+const char *const kManagedRoot = "/mnt/";
+const char *const kAppliedDir = "/run/ada-mounter";
+
+std::vector<std::string> split(const std::string &text, char separator) {
+    std::vector<std::string> parts;
+    size_t start = text.find_first_not_of(separator);
+    while (start != std::string::npos) {
+        const size_t end = text.find(separator, start);
+        parts.push_back(text.substr(start, end == std::string::npos ? end : end - start));
+        start = text.find_first_not_of(separator, end);
+    }
+    return parts;
+}
+
+std::string appliedPath(const std::string &uuid) {
+    return std::string(kAppliedDir) + "/" + uuid;
+}
+
+bool exists(const std::string &path) {
+    return ::access(path.c_str(), F_OK) == 0;
+}
+
+// Options that differ only in their value (or a "no" prefix) replace each
+// other; the atime modes are one choice too.
+std::string optionKey(const std::string &option) {
+    const std::string name = option.substr(0, option.find('='));
+    if (name == "noatime" || name == "relatime" || name == "strictatime" || name == "atime") {
+        return "atime";
+    }
+    if (option.find('=') == std::string::npos && name.compare(0, 2, "no") == 0) {
+        return name.substr(2);
+    }
+    return name;
+}
+
+void merge(std::vector<std::string> *options, const std::string &overrides) {
+    for (const std::string &option : split(overrides, ',')) {
+        const std::string key = optionKey(option);
+        for (size_t i = options->size(); i > 0; --i) {
+            if (optionKey(options->at(i - 1)) == key) {
+                options->erase(options->begin() + long(i - 1));
+            }
+        }
+        options->push_back(option);
+    }
+}
+
+// Built-in defaults per filesystem: no atime writes anywhere, lazytime where
+// the filesystem journals inode timestamps, and zstd for btrfs.
+const char *builtinOptions(const std::string &fsType) {
+    if (fsType == "btrfs") {
+        return "noatime,lazytime,compress=zstd";
+    }
+    if (fsType == "ext4" || fsType == "xfs" || fsType == "f2fs") {
+        return "noatime,lazytime";
+    }
+    if (fsType == "ntfs" || fsType == "ntfs3" || fsType == "exfat" || fsType == "vfat") {
+        return "noatime";
+    }
+    return "";
+}
+
+// Media tuning. On SSDs btrfs gets asynchronous discard, which batches trims
+// off the write path (ext4/xfs are left to fstrim.timer, their discard is
+// synchronous). On spinning disks journal commits are spaced out so writes
+// are merged into fewer seeks.
+const char *mediaOptions(const std::string &fsType, int rotational) {
+    if (rotational == 0 && fsType == "btrfs") {
+        return "ssd,discard=async";
+    }
+    if (rotational == 1 && (fsType == "ext4" || fsType == "btrfs")) {
+        return "commit=30";
+    }
+    return "";
+}
+
+struct FlagOption {
+    const char *name;
+    unsigned long flag;
+    bool clear;
+};
+
+const FlagOption kFlagOptions[] = {
+    {"ro", MS_RDONLY, false},       {"rw", MS_RDONLY, true},
+    {"nosuid", MS_NOSUID, false},   {"suid", MS_NOSUID, true},
+    {"nodev", MS_NODEV, false},     {"dev", MS_NODEV, true},
+    {"noexec", MS_NOEXEC, false},   {"exec", MS_NOEXEC, true},
+    {"sync", MS_SYNCHRONOUS, false}, {"async", MS_SYNCHRONOUS, true},
+    {"dirsync", MS_DIRSYNC, false},
+    {"noatime", MS_NOATIME, false},
+    {"relatime", MS_RELATIME, false},
+    {"strictatime", MS_STRICTATIME, false},
+    {"atime", 0, false},
+    {"nodiratime", MS_NODIRATIME, false},
+    {"lazytime", MS_LAZYTIME, false}, {"nolazytime", MS_LAZYTIME, true},
+    {"defaults", 0, false},
+};
+}
+
+std::string MountRules::resolve(const std::string &fsType, int rotational,
+                                const std::string &fsTypeProfile, const std::string &uuidProfile) {
+    std::vector<std::string> options;
+    merge(&options, builtinOptions(fsType));
+    merge(&options, mediaOptions(fsType, rotational));
+    merge(&options, fsTypeProfile);
+    merge(&options, uuidProfile);
+
+    std::string joined;
+    for (const std::string &option : options) {
+        joined += (joined.empty() ? "" : ",") + option;
+    }
+    return joined;
+}
+
+unsigned long MountRules::toFlags(const std::string &options, std::string *data) {
+    unsigned long flags = 0;
+    data->clear();
+
+    for (const std::string &option : split(options, ',')) {
+        bool isFlag = false;
+        for (const FlagOption &flagOption : kFlagOptions) {
+            if (option == flagOption.name) {
+                flags = flagOption.clear ? flags & ~flagOption.flag : flags | flagOption.flag;
+                isFlag = true;
+                break;
+            }
+        }
+        if (!isFlag) {
+            *data += (data->empty() ? "" : ",") + option;
+        }
+    }
+    return flags;
+}
+
+// ----------------------------------------------------------------------------------------------
+// Hex groups joined by dashes, at least 8 characters: ext4/btrfs 8-4-4-4-12,
+// FAT ABCD-1234, NTFS 16 digits.
+// ----------------------------------------------------------------------------------------------
+bool MountRules::isUuidName(const std::string &name) {
+    if (name.size() < 8 || name.front() == '-' || name.back() == '-'
+        || name.find("--") != std::string::npos) {
+        return false;
+    }
+    for (char c : name) {
+        if (!isxdigit(static_cast<unsigned char>(c)) && c != '-') {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::string MountRules::managedUuid(const std::string &mountPoint) {
+    const size_t rootLength = strlen(kManagedRoot);
+    if (mountPoint.compare(0, rootLength, kManagedRoot) != 0
+        || mountPoint.find('/', rootLength) != std::string::npos) {
+        return std::string();
+    }
+    const std::string name = mountPoint.substr(rootLength);
+    return isUuidName(name) ? name : std::string();
+}
+
+// ----------------------------------------------------------------------------------------------
+// Same as systemd-escape --path: slashes trimmed and collapsed, then turned
+// into dashes; anything outside [A-Za-z0-9:_.] (and a leading dot) becomes
+// \xNN, byte by byte.
+// ----------------------------------------------------------------------------------------------
+std::string MountRules::escapePath(const std::string &path) {
+    std::string joined;
+    for (const std::string &part : split(path, '/')) {
+        joined += (joined.empty() ? "" : "/") + part;
+    }
+
+    std::string escaped;
+    for (size_t i = 0; i < joined.size(); ++i) {
+        const unsigned char c = static_cast<unsigned char>(joined[i]);
+        if (c == '/') {
+            escaped += '-';
+        } else if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9')
+                   || c == ':' || c == '_' || (c == '.' && i > 0)) {
+            escaped += char(c);
+        } else {
+            char hex[5];
+            snprintf(hex, sizeof(hex), "\\x%02x", c);
+            escaped += hex;
+        }
+    }
+    return escaped.empty() ? std::string("-") : escaped;
+}
+
+std::string MountRules::kernelType(const std::string &fsType) {
+    return fsType == "ntfs" && kernelHasNtfs3() ? std::string("ntfs3") : fsType;
+}
+
+bool MountRules::kernelHasNtfs3() {
+    FILE *filesystems = fopen("/proc/filesystems", "re");
+    if (filesystems) {
+        char line[128];
+        bool found = false;
+        while (!found && fgets(line, sizeof(line), filesystems)) {
+            found = strstr(line, "\tntfs3\n") != nullptr;
+        }
+        fclose(filesystems);
+        if (found) {
+            return true;
+        }
+    }
+
+    struct utsname system;
+    return ::uname(&system) == 0
+        && exists(std::string("/usr/lib/modules/") + system.release + "/kernel/fs/ntfs3");
+}
+
+bool MountRules::needsHelper(const std::string &fsType) {
+    if (fsType == "ntfs-3g" || fsType.compare(0, 4, "fuse") == 0) {
+        return true;
+    }
+    return exists("/usr/bin/mount." + fsType) || exists("/sbin/mount." + fsType);
+}
+
+bool MountRules::canRemount(const std::string &mountedFsType, const std::string &oldOptions,
+                            const std::string &newOptions) {
+    if (mountedFsType == "autofs" || mountedFsType.compare(0, 4, "fuse") == 0) {
+        return false;
+    }
+    std::string oldData, newData;
+    toFlags(oldOptions, &oldData);
+    toFlags(newOptions, &newData);
+    return oldData == newData;
+}
+
+// ----------------------------------------------------------------------------------------------
+// One line, "device=<node> fstype=<type> options=<list>", followed by
+// "onaccess=<idle seconds>" for an on-access drive; none of the values can
+// hold a space.
+// ----------------------------------------------------------------------------------------------
+bool MountRules::writeApplied(const std::string &uuid, const Applied &applied) {
+    if (::mkdir(kAppliedDir, 0755) < 0 && errno != EEXIST) {
+        return false;
+    }
+    const std::string path = appliedPath(uuid);
+    const std::string temp = path + ".new";
+    FILE *file = fopen(temp.c_str(), "we");
+    if (!file) {
+        return false;
+    }
+    std::string line = "device=" + applied.device + " fstype=" + applied.fsType
+        + " options=" + applied.options;
+    if (applied.onAccess) {
+        line += " onaccess=" + std::to_string(applied.idleSeconds);
+    }
+    const bool written = fprintf(file, "%s\n", line.c_str()) > 0;
+    if (fclose(file) != 0 || !written || ::rename(temp.c_str(), path.c_str()) < 0) {
+        ::unlink(temp.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool MountRules::readApplied(const std::string &uuid, Applied *applied) {
+    FILE *file = fopen(appliedPath(uuid).c_str(), "re");
+    if (!file) {
+        return false;
+    }
+    char line[1024];
+    const bool read = fgets(line, sizeof(line), file) != nullptr;
+    fclose(file);
+    if (!read) {
+        return false;
+    }
+
+    *applied = Applied();
+    for (const std::string &field : split(std::string(line, strcspn(line, "\n")), ' ')) {
+        const size_t equals = field.find('=');
+        const std::string key = field.substr(0, equals);
+        const std::string value = equals == std::string::npos ? std::string() : field.substr(equals + 1);
+        if (key == "device") {
+            applied->device = value;
+        } else if (key == "fstype") {
+            applied->fsType = value;
+        } else if (key == "options") {
+            applied->options = value;
+        } else if (key == "onaccess") {
+            applied->onAccess = true;
+            applied->idleSeconds = atoi(value.c_str());
+        }
+    }
+    return !applied->device.empty();
+}
+
+void MountRules::forgetApplied(const std::string &uuid) {
+    ::unlink(appliedPath(uuid).c_str());
+}
@@ -0,0 +1,64 @@
+#ifndef MOUNT_RULES_H
+#define MOUNT_RULES_H
+
+#include <string>
+
+// The decisions both daemons make the same way: option profiles, mount(2)
+// flags, which /mnt entries are ours, unit names and when a mount goes
+// through a helper. Standard library only, so ada_mounter_minimal compiles
+// it as is; MountOptions, MountTable, Mounter and UnitGenerator wrap it.
+class MountRules
+{
+public:
+    // Built-in defaults for fsType, then media tuning for the rotational
+    // flag (-1 when unknown), then the FSTYPE and UUID profiles, option by
+    // option. Comma separated.
+    static std::string resolve(const std::string &fsType, int rotational,
+                               const std::string &fsTypeProfile, const std::string &uuidProfile);
+
+    // Splits an option list into mount(2) flags and the filesystem specific
+    // data string.
+    static unsigned long toFlags(const std::string &options, std::string *data);
+
+    // Whether name looks like a filesystem UUID as blkid prints it.
+    static bool isUuidName(const std::string &name);
+
+    // The UUID of a /mnt/<uuid> mount point, empty for anything else
+    // (nested mounts, other names under /mnt).
+    static std::string managedUuid(const std::string &mountPoint);
+
+    // systemd-escape --path
+    static std::string escapePath(const std::string &path);
+
+    // The type to ask the kernel or systemd for: blkid's "ntfs" becomes the
+    // in-kernel ntfs3 where the kernel has it.
+    static std::string kernelType(const std::string &fsType);
+    static bool kernelHasNtfs3();
+
+    // Whether a mount of mountedFsType (as mountinfo shows it) can move from
+    // oldOptions to newOptions in place with MS_REMOUNT: only mount(2) flags
+    // differ and the kernel driver itself, not a FUSE helper, holds it.
+    static bool canRemount(const std::string &mountedFsType, const std::string &oldOptions,
+                           const std::string &newOptions);
+
+    // What a UUID was last mounted with, kept under /run so that either
+    // daemon, after a restart too, can tell that the config moved on under a
+    // mounted drive. A mount without a record is taken as up to date, save
+    // for its mode, which shows in whether it has a trigger.
+    struct Applied {
+        std::string device;
+        std::string fsType;     // as blkid reports it
+        std::string options;    // resolved
+        bool onAccess = false;
+        int idleSeconds = 0;    // on-access only
+    };
+    static bool writeApplied(const std::string &uuid, const Applied &applied);
+    static bool readApplied(const std::string &uuid, Applied *applied);
+    static void forgetApplied(const std::string &uuid);
+
+    // Whether fsType is mounted through mount(8) and its mount.<type> helper
+    // (FUSE filesystems) rather than with mount(2).
+    static bool needsHelper(const std::string &fsType);
+};
+
+#endif // MOUNT_RULES_H
@@ -0,0 +1,150 @@
+#include "mount_scheduler.h"
+#include "mounter.h"
+#include <QTimer>
+#include <QMetaObject>
+#include <QDebug>
+
+namespace {
+const int kMaxWorkers = 6;
+const int kDeadlineMs = 20000;
+const int kMaxAttempts = 3;
+const int kBackoffMs = 1000;   // doubled after every failed attempt
+}
+
+MountScheduler::MountScheduler(QObject *parent)
+    : QObject(parent)
+{
+    m_pool.setMaxThreadCount(kMaxWorkers);
+}
+
+MountScheduler::~MountScheduler() {
+    m_jobs.clear();
+    // A mount(2) stuck in the kernel can't be interrupted, so this waits for
+    // it as long as it takes (the pool's destructor would anyway); the
+    // results are dropped since no job is left
+    m_pool.waitForDone();
+}
+
+void MountScheduler::submit(const QString &uuid, const MountOptions &options,
+                            const QString &device, const QString &fsType) {
+    if (m_jobs.contains(uuid)) {
+        return; // already on its way
+    }
+
+    Job job;
+    job.device = device;
+    job.fsType = fsType;
+    job.options = options;
+    m_jobs.insert(uuid, job);
+    emit queued(uuid);
+    startAttempt(uuid);
+}
+
+void MountScheduler::cancel(const QString &uuid) {
+    if (m_jobs.remove(uuid)) {
+        qDebug() << "Cancelled mount of" << uuid;
+    }
+}
+
+QSet<QString> MountScheduler::pending() const {
+    QSet<QString> uuids;
+    for (auto it = m_jobs.cbegin(); it != m_jobs.cend(); ++it) {
+        uuids.insert(it.key());
+    }
+    return uuids;
+}
+
+void MountScheduler::startAttempt(const QString &uuid) {
+    Job &job = m_jobs[uuid];
+    job.attempt++;
+    job.generation = ++m_generation;
+
+    const quint64 generation = job.generation;
+    const QString device = job.device;
+    const QString fsType = job.fsType;
+    const MountOptions options = job.options;
+    const QString mountDir = "/mnt/" + uuid;
+
+    qDebug() << "Mounting" << uuid << "to" << mountDir << "attempt" << job.attempt;
+
+    m_pool.start([this, uuid, generation, device, fsType, options, mountDir]() {
+        QString error;
+        const bool ok = options.onAccess(uuid)
+            ? Mounter::automount(uuid, mountDir, options, &error)
+            : device.isEmpty()
+            ? Mounter::mountUuid(uuid, mountDir, options, &error)
+            : Mounter::mountDevice(device, fsType, mountDir,
+                                   options.resolve(uuid, device, fsType), &error);
+        if (ok) {
+            Mounter::recordApplied(uuid, device, fsType, options);
+        }
+
+        QMetaObject::invokeMethod(this, [this, uuid, generation, ok, error]() {
+            attemptFinished(uuid, generation, ok, error);
+        }, Qt::QueuedConnection);
+    });
+
+    // Deadline for this attempt; a result makes it moot. An overdue mount(2)
+    // can't be interrupted and a retry would race it for the same mount
+    // point, so it is only reported and left to finish.
+    QTimer::singleShot(kDeadlineMs, this, [this, uuid, generation]() {
+        auto it = m_jobs.find(uuid);
+        if (it != m_jobs.end() && it->generation == generation) {
+            it->overdue = true;
+            const QString error = QString("Timed out after %1 s").arg(kDeadlineMs / 1000);
+            qWarning() << "Mount of" << uuid << "is still in flight:" << error;
+            emit failed(uuid, error);
+        }
+    });
+}
+
+void MountScheduler::attemptFinished(const QString &uuid, quint64 generation, bool ok, const QString &error) {
+    auto it = m_jobs.find(uuid);
+    if (it == m_jobs.end() || it->generation != generation) {
+        // Cancelled meanwhile
+        qDebug() << "Ignoring late result for" << uuid << (ok ? "(mounted)" : error);
+        return;
+    }
+
+    if (it->overdue) {
+        // Already reported as failed; no retry for an attempt that hung once
+        m_jobs.erase(it);
+        if (ok) {
+            qDebug() << "Overdue mount of" << uuid << "landed after all";
+            emit mounted(uuid, "/mnt/" + uuid);
+        } else {
+            qWarning() << "Overdue mount of" << uuid << "failed:" << error;
+        }
+        return;
+    }
+
+    if (ok) {
+        m_jobs.erase(it);
+        qDebug() << "Successfully mounted" << uuid;
+        emit mounted(uuid, "/mnt/" + uuid);
+        return;
+    }
+    retryOrFail(uuid, error);
+}
+
+void MountScheduler::retryOrFail(const QString &uuid, const QString &error) {
+    Job &job = m_jobs[uuid];
+    if (job.attempt >= kMaxAttempts) {
+        m_jobs.remove(uuid);
+        qWarning() << "Failed to mount" << uuid << ":" << error;
+        emit failed(uuid, error);
+        return;
+    }
+
+    const int delay = kBackoffMs << (job.attempt - 1);
+    qDebug() << "Mount of" << uuid << "failed (" << error << "), retrying in" << delay << "ms";
+
+    const int attempt = job.attempt;
+    QTimer::singleShot(delay, this, [this, uuid, attempt]() {
+        // Skip if cancelled (or cancelled and resubmitted) while waiting
+        auto it = m_jobs.find(uuid);
+        if (it != m_jobs.end() && it->attempt == attempt) {
+            startAttempt(uuid);
+        }
+    });
+}
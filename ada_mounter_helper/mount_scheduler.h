@@ -0,0 +1,59 @@
+#ifndef MOUNT_SCHEDULER_H
+#define MOUNT_SCHEDULER_H
+
+#include <QObject>
+#include <QString>
+#include <QSet>
+#include <QHash>
+#include <QThreadPool>
+#include "mount_options.h"
+
+// Mounts independent devices in parallel on a bounded pool, so one slow or
+// hung drive no longer holds up the others. A failed attempt is retried with
+// exponential backoff; one past its deadline is reported as failed but left
+// to finish, never raced by a retry. The outcome is reported per UUID through
+// mounted() / failed(). cancel() drops a UUID that is no longer wanted; a late
+// result for it is ignored (and the reconciler unmounts it if the mount did
+// land).
+class MountScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit MountScheduler(QObject *parent = nullptr);
+    ~MountScheduler();
+
+    // device/fsType may be passed when already known (udev events); otherwise
+    // they are resolved from the UUID on the worker. options are the profiles
+    // from the config the mount was decided on.
+    void submit(const QString &uuid, const MountOptions &options,
+                const QString &device = QString(), const QString &fsType = QString());
+    void cancel(const QString &uuid);
+
+    QSet<QString> pending() const;
+
+signals:
+    void queued(const QString &uuid);
+    void mounted(const QString &uuid, const QString &mountDir);
+    void failed(const QString &uuid, const QString &error);
+
+private:
+    struct Job {
+        QString device;
+        QString fsType;
+        MountOptions options;
+        int attempt = 0;
+        quint64 generation = 0;   // identifies the attempt in flight
+        bool overdue = false;     // past its deadline, failed() already sent
+    };
+
+    void startAttempt(const QString &uuid);
+    void attemptFinished(const QString &uuid, quint64 generation, bool ok, const QString &error);
+    void retryOrFail(const QString &uuid, const QString &error);
+
+    QThreadPool m_pool;
+    QHash<QString, Job> m_jobs;
+    quint64 m_generation = 0;
+};
+
+#endif // MOUNT_SCHEDULER_H
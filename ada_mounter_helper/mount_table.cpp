@@ -0,0 +1,127 @@
+#include "mount_table.h"
+#include "device_inventory.h"
+#include "mount_info.h"
+#include "mount_rules.h"
+#include <QSocketNotifier>
+#include <QFileInfo>
+#include <QDebug>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+
+namespace {
+const char *const kMountInfo = "/proc/self/mountinfo";
+}
+
+MountTable::MountTable(QObject *parent)
+    : QObject(parent)
+{}
+
+MountTable::~MountTable() {
+    if (m_fd >= 0) {
+        ::close(m_fd);
+    }
+}
+
+bool MountTable::open() {
+    m_fd = ::open(kMountInfo, O_RDONLY | O_CLOEXEC);
+    if (m_fd < 0) {
+        qWarning() << "Failed to open" << kMountInfo << ":" << strerror(errno);
+        return false;
+    }
+
+    m_entries = parse(readAll());
+    m_managed = managed(m_entries);
+
+    // The kernel flags mountinfo with POLLPRI|POLLERR when the table changes
+    m_notifier = new QSocketNotifier(m_fd, QSocketNotifier::Exception, this);
+    connect(m_notifier, &QSocketNotifier::activated, this, &MountTable::reload);
+    return true;
+}
+
+QByteArray MountTable::readAll() const {
+    // Reading from offset 0 both fetches the table and re-arms the event
+    QByteArray data;
+    char buffer[16384];
+    off_t offset = 0;
+    ssize_t count;
+    while ((count = ::pread(m_fd, buffer, sizeof(buffer), offset)) > 0) {
+        data.append(buffer, int(count));
+        offset += count;
+    }
+    if (count < 0) {
+        qWarning() << "Failed to read" << kMountInfo << ":" << strerror(errno);
+    }
+    return data;
+}
+
+void MountTable::reload() {
+    QHash<QString, Entry> fresh = parse(readAll());
+
+    bool same = fresh.size() == m_entries.size();
+    for (auto it = fresh.cbegin(); it != fresh.cend() && same; ++it) {
+        auto old = m_entries.constFind(it.key());
+        same = old != m_entries.cend() && old->source == it->source
+            && old->fsType == it->fsType && old->options == it->options;
+    }
+    if (same) {
+        return;
+    }
+
+    m_entries = fresh;
+    m_managed = managed(m_entries);
+    emit changed();
+}
+
+QHash<QString, MountTable::Entry> MountTable::parse(const QByteArray &mountinfo) {
+    QHash<QString, Entry> entries;
+
+    for (const MountInfo::Entry &line : MountInfo::parse(mountinfo.toStdString())) {
+        Entry entry;
+        entry.device = QString::fromStdString(line.device);
+        entry.mountPoint = QString::fromStdString(line.mountPoint);
+        entry.options = QString::fromStdString(line.options);
+        entry.fsType = QString::fromStdString(line.fsType);
+        entry.source = QString::fromStdString(line.source);
+        entry.superOptions = QString::fromStdString(line.superOptions);
+
+        // Stacked mounts: the last one listed is the visible one
+        entries.insert(entry.mountPoint, entry);
+    }
+    return entries;
+}
+
+QSet<QString> MountTable::managed(const QHash<QString, Entry> &entries) {
+    QSet<QString> mounted;
+    for (auto it = entries.cbegin(); it != entries.cend(); ++it) {
+        // Only /mnt/<uuid> itself, not mounts nested below it
+        const QString uuid = QString::fromStdString(MountRules::managedUuid(it.key().toStdString()));
+        if (!uuid.isEmpty() && isManaged(uuid, it.value())) {
+            mounted.insert("UUID=" + uuid);
+        }
+    }
+    return mounted;
+}
+
+// ----------------------------------------------------------------------------------------------
+// /mnt/<uuid> (a UUID-shaped name, see MountRules::managedUuid()) is ours when it holds the filesystem with that UUID, or the
+// autofs trigger systemd-mount puts there for an on-access drive. A device
+// node that is gone can't be checked; its mount is kept as ours so the
+// stale mount is still cleaned up.
+// ----------------------------------------------------------------------------------------------
+bool MountTable::isManaged(const QString &uuid, const Entry &entry) {
+    if (entry.fsType == "autofs") {
+        return true;
+    }
+    if (!entry.source.startsWith("/dev/")) {
+        return false;
+    }
+    if (!QFileInfo::exists(entry.source)) {
+        return true;
+    }
+    BlockDevice device;
+    return DeviceInventory::find(entry.source, &device)
+        && device.uuid.compare(uuid, Qt::CaseInsensitive) == 0;
+}
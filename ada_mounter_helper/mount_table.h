@@ -0,0 +1,63 @@
+#ifndef MOUNT_TABLE_H
+#define MOUNT_TABLE_H
+
+#include <QObject>
+#include <QString>
+#include <QHash>
+#include <QSet>
+
+class QSocketNotifier;
+
+// In-memory copy of /proc/self/mountinfo keyed by mount point. The file is
+// kept open and watched for POLLPRI (a QSocketNotifier of type Exception),
+// which the kernel raises on every mount or unmount in our namespace, so the
+// table is re-read only when it actually changed and never via `mount`.
+class MountTable : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Entry {
+        QString source;       // e.g. /dev/sdb1
+        QString mountPoint;
+        QString fsType;
+        QString options;      // per-mount options
+        QString superOptions; // per-superblock options
+        QString device;       // major:minor
+    };
+
+    explicit MountTable(QObject *parent = nullptr);
+    ~MountTable();
+
+    // Opens mountinfo, reads it and starts watching it.
+    bool open();
+
+    const QHash<QString, Entry> &entries() const { return m_entries; }
+    bool isMounted(const QString &mountPoint) const { return m_entries.contains(mountPoint); }
+
+    // "UUID=<uuid>" for everything the daemon mounted under /mnt/<uuid>, the
+    // same tokens manually_enabled.conf uses. Other mounts there (a user's
+    // /mnt/usb, or a device mounted on another one's directory) aren't ours
+    // and are left alone.
+    QSet<QString> managedPartitions() const { return m_managed; }
+
+    static QHash<QString, Entry> parse(const QByteArray &mountinfo);
+
+signals:
+    void changed();
+
+private slots:
+    void reload();
+
+private:
+    QByteArray readAll() const;
+    static QSet<QString> managed(const QHash<QString, Entry> &entries);
+    static bool isManaged(const QString &uuid, const Entry &entry);
+
+    int m_fd = -1;
+    QSocketNotifier *m_notifier = nullptr;
+    QHash<QString, Entry> m_entries;
+    QSet<QString> m_managed;
+};
+
+#endif // MOUNT_TABLE_H
@@ -0,0 +1,220 @@
+#include "mounter.h"
+#include "mount_options.h"
+#include "device_inventory.h"
+#include "mount_rules.h"
+#include <QProcess>
+#include <QFileInfo>
+#include <QDebug>
+
+#include <sys/mount.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+
+namespace {
+// A helper (FUSE mount, systemd-mount) that hasn't finished by then is killed
+const int kHelperTimeoutMs = 15000;
+
+QString systemError(const char *call) {
+    return QString("%1: %2").arg(call, strerror(errno));
+}
+}
+
+bool Mounter::resolve(const QString &uuid, QString *device, QString *fsType) {
+    BlockDevice blockDevice;
+    if (!DeviceInventory::findByUuid(uuid, &blockDevice)) {
+        return false;
+    }
+    *device = blockDevice.path;
+    *fsType = blockDevice.fsType;
+    return true;
+}
+
+void Mounter::recordApplied(const QString &uuid, QString device, QString fsType,
+                            const MountOptions &options) {
+    if (device.isEmpty() && !resolve(uuid, &device, &fsType)) {
+        return;
+    }
+    MountRules::Applied applied;
+    applied.device = device.toStdString();
+    applied.fsType = fsType.toStdString();
+    applied.options = options.resolve(uuid, device, fsType).toStdString();
+    applied.onAccess = options.onAccess(uuid, &applied.idleSeconds);
+    if (!MountRules::writeApplied(uuid.toStdString(), applied)) {
+        qWarning() << "Failed to record the options of" << uuid;
+    }
+}
+
+// ----------------------------------------------------------------------------------------------
+// mkdir -p for /mnt/<uuid>: the parent is opened once and the leaf created
+// relative to it.
+// ----------------------------------------------------------------------------------------------
+bool Mounter::makeMountDir(const QString &mountDir, QString *error) {
+    const QFileInfo info(mountDir);
+    const QByteArray parent = info.absolutePath().toLocal8Bit();
+    const QByteArray name = info.fileName().toLocal8Bit();
+
+    int parentFd = ::open(parent.constData(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (parentFd < 0 && errno == ENOENT && ::mkdir(parent.constData(), 0755) == 0) {
+        parentFd = ::open(parent.constData(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    }
+    if (parentFd < 0) {
+        *error = systemError("open");
+        return false;
+    }
+
+    const int result = ::mkdirat(parentFd, name.constData(), 0755);
+    const int savedErrno = errno;
+    ::close(parentFd);
+
+    if (result < 0 && savedErrno != EEXIST) {
+        errno = savedErrno;
+        *error = systemError("mkdirat");
+        return false;
+    }
+    return true;
+}
+
+bool Mounter::mountWithHelper(const QString &device, const QString &fsType,
+                              const QString &mountDir, const QString &options, QString *error) {
+    QStringList arguments;
+    arguments << "-t" << fsType;
+    if (!options.isEmpty()) {
+        arguments << "-o" << options;
+    }
+    arguments << device << mountDir;
+    return runHelper("mount", arguments, error);
+}
+
+bool Mounter::runHelper(const QString &program, const QStringList &arguments, QString *error) {
+    QProcess helperProc;
+    helperProc.start(program, arguments);
+    if (!helperProc.waitForFinished(kHelperTimeoutMs)) {
+        helperProc.kill();
+        helperProc.waitForFinished();
+        *error = program + " timed out";
+        return false;
+    }
+
+    if (helperProc.exitStatus() != QProcess::NormalExit || helperProc.exitCode() != 0) {
+        *error = QString::fromLocal8Bit(helperProc.readAllStandardError()).trimmed();
+        return false;
+    }
+    return true;
+}
+
+bool Mounter::mountUuid(const QString &uuid, const QString &mountDir,
+                        const MountOptions &options, QString *error) {
+    QString device, fsType;
+    if (!resolve(uuid, &device, &fsType)) {
+        *error = "No device with UUID " + uuid;
+        return false;
+    }
+    qDebug() << "Resolved" << uuid << "to" << device << "type" << fsType;
+    return mountDevice(device, fsType, mountDir, options.resolve(uuid, device, fsType), error);
+}
+
+bool Mounter::mountDevice(const QString &device, const QString &fsType,
+                          const QString &mountDir, const QString &options, QString *error) {
+    if (fsType.isEmpty()) {
+        *error = "Unknown filesystem on " + device;
+        return false;
+    }
+
+    if (!makeMountDir(mountDir, error)) {
+        return false;
+    }
+
+    QByteArray data;
+    const unsigned long flags = MountOptions::toFlags(options, &data);
+    const QByteArray source = device.toLocal8Bit();
+    const QByteArray target = mountDir.toLocal8Bit();
+
+    // blkid reports NTFS as "ntfs". The in-kernel ntfs3 driver is much faster
+    // than FUSE ntfs-3g; the kernel loads it on demand, and ENODEV means the
+    // kernel has none, so ntfs-3g is used after all.
+    if (fsType == "ntfs") {
+        if (::mount(source.constData(), target.constData(), "ntfs3", flags,
+                    data.isEmpty() ? nullptr : data.constData()) == 0) {
+            qDebug() << "Mounted" << device << "with ntfs3, options" << options;
+            return true;
+        }
+        if (errno != ENODEV) {
+            *error = systemError("mount");
+            return false;
+        }
+        return mountWithHelper(device, "ntfs-3g", mountDir, options, error);
+    }
+
+    // Filesystems that only mount through a userspace helper (mount.<type>),
+    // typically FUSE drivers such as ntfs-3g, keep going through `mount`
+    if (MountRules::needsHelper(fsType.toStdString())) {
+        return mountWithHelper(device, fsType, mountDir, options, error);
+    }
+
+    if (::mount(source.constData(), target.constData(), fsType.toLatin1().constData(), flags,
+                data.isEmpty() ? nullptr : data.constData()) < 0) {
+        *error = systemError("mount");
+        return false;
+    }
+    qDebug() << "Mounted" << device << "with options" << options;
+    return true;
+}
+
+bool Mounter::remount(const QString &device, const QString &mountDir, const QString &options,
+                      QString *error) {
+    QByteArray data;
+    const unsigned long flags = MountOptions::toFlags(options, &data);
+    if (::mount(device.toLocal8Bit().constData(), mountDir.toLocal8Bit().constData(), nullptr,
+                MS_REMOUNT | flags, data.isEmpty() ? nullptr : data.constData()) < 0) {
+        *error = systemError("mount");
+        return false;
+    }
+    qDebug() << "Remounted" << mountDir << "with options" << options;
+    return true;
+}
+
+bool Mounter::unmount(const QString &mountDir, bool lazy, QString *error) {
+    if (::umount2(mountDir.toLocal8Bit().constData(), lazy ? MNT_DETACH : 0) < 0) {
+        *error = systemError("umount2");
+        return false;
+    }
+    return true;
+}
+
+// ----------------------------------------------------------------------------------------------
+// On-access drives. The device is named by its /dev/disk/by-uuid link so the
+// transient units are bound to it and go away when it is unplugged.
+// ----------------------------------------------------------------------------------------------
+bool Mounter::automount(const QString &uuid, const QString &mountDir,
+                        const MountOptions &options, QString *error) {
+    QString device, fsType;
+    if (!resolve(uuid, &device, &fsType)) {
+        *error = "No device with UUID " + uuid;
+        return false;
+    }
+
+    int idleSeconds = 0;
+    options.onAccess(uuid, &idleSeconds);
+    const QString mountOptions = options.resolve(uuid, device, fsType);
+
+    QStringList arguments;
+    arguments << "--automount=yes" << "--collect" << "--fsck=no";
+    arguments << "--type=" + QString::fromStdString(MountRules::kernelType(fsType.toStdString()));
+    if (!mountOptions.isEmpty()) {
+        arguments << "--options=" + mountOptions;
+    }
+    if (idleSeconds > 0) {
+        arguments << QString("--timeout-idle-sec=%1").arg(idleSeconds);
+    }
+    arguments << "/dev/disk/by-uuid/" + uuid << mountDir;
+
+    qDebug() << "Setting up on-access mount of" << device << "on" << mountDir << "idle" << idleSeconds;
+    return runHelper("systemd-mount", arguments, error);
+}
+
+bool Mounter::removeAutomount(const QString &mountDir, QString *error) {
+    return runHelper("systemd-umount", QStringList() << mountDir, error);
+}
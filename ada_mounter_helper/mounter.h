@@ -0,0 +1,57 @@
+#ifndef MOUNTER_H
+#define MOUNTER_H
+
+#include <QString>
+
+class MountOptions;
+
+// Mounting without subprocesses. The device and filesystem type for a UUID
+// come from DeviceInventory, the mount directory is made with mkdirat and
+// the mount itself is a mount(2) call. Filesystems whose driver lives in a
+// userspace mount helper (FUSE ones such as ntfs-3g) are handed to `mount`;
+// NTFS goes to the kernel ntfs3 driver when there is one.
+class Mounter
+{
+public:
+    // Resolves the device for uuid and mounts it on mountDir with the options
+    // its profile resolves to. On failure returns false and fills error.
+    static bool mountUuid(const QString &uuid, const QString &mountDir,
+                          const MountOptions &options, QString *error);
+
+    // Mounts an already identified device (e.g. from a udev event) with a
+    // comma separated option list.
+    static bool mountDevice(const QString &device, const QString &fsType,
+                            const QString &mountDir, const QString &options, QString *error);
+
+    // MS_REMOUNT of a kernel mount with a new option list; only its mount(2)
+    // flags may differ from what it was mounted with (see
+    // MountRules::canRemount()).
+    static bool remount(const QString &device, const QString &mountDir, const QString &options,
+                        QString *error);
+
+    // umount2(); with lazy, a busy filesystem is detached instead of failing.
+    static bool unmount(const QString &mountDir, bool lazy, QString *error);
+
+    // On-access mounting: systemd-mount sets up a transient .automount on
+    // mountDir and the real mount happens on first access (and is undone
+    // after the profile's idle timeout). removeAutomount() stops both units.
+    static bool automount(const QString &uuid, const QString &mountDir,
+                          const MountOptions &options, QString *error);
+    static bool removeAutomount(const QString &mountDir, QString *error);
+
+    // Keeps what uuid was just mounted with for the next reconcile pass (see
+    // MountRules::Applied); device and fsType are resolved when empty.
+    static void recordApplied(const QString &uuid, QString device, QString fsType,
+                              const MountOptions &options);
+
+    // Device node and filesystem type for uuid (see DeviceInventory::findByUuid()).
+    static bool resolve(const QString &uuid, QString *device, QString *fsType);
+
+private:
+    static bool makeMountDir(const QString &mountDir, QString *error);
+    static bool mountWithHelper(const QString &device, const QString &fsType,
+                                const QString &mountDir, const QString &options, QString *error);
+    static bool runHelper(const QString &program, const QStringList &arguments, QString *error);
+};
+
+#endif // MOUNTER_H
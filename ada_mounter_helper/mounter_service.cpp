@@ -0,0 +1,195 @@
+#include "mounter_service.h"
+#include "ada_mounter_helper.h"
+#include "mount_table.h"
+#include "mount_scheduler.h"
+#include "reconciler.h"
+#include "polkit_authority.h"
+#include <QDBusConnection>
+#include <QDBusMessage>
+#include <QDBusPendingCallWatcher>
+#include <QRegularExpression>
+#include <QSaveFile>
+#include <QDebug>
+#include <utility>
+
+namespace {
+const char *kApplyAction = "org.xray.ada.mounterhelper.apply";
+
+// How long CheckAuthorization may wait for the user to type a password.
+const int kAuthTimeoutMs = 5 * 60 * 1000;
+
+// "UUID=<uuid>" or "FSTYPE=<type>", optionally followed by " options=<list>"
+// and " onaccess [idle=<seconds>]"
+const QRegularExpression kConfigLine(QRegularExpression::anchoredPattern(
+    "(UUID|FSTYPE)=[A-Za-z0-9_-]+( options=[A-Za-z0-9_.:+=,-]+)?( onaccess( idle=[0-9]+)?)?"));
+}
+
+MounterService::MounterService(MountTable *table, MountScheduler *scheduler, Reconciler *reconciler,
+                               QObject *parent)
+    : QObject(parent)
+    , m_table(table)
+    , m_scheduler(scheduler)
+    , m_reconciler(reconciler)
+{
+    PolkitAuthority::registerTypes();
+
+    m_lastMounted = mountedStates(*m_table);
+    connect(m_table, &MountTable::changed, this, &MounterService::mountTableChanged);
+    connect(m_scheduler, &MountScheduler::queued, this, &MounterService::mountQueued);
+    connect(m_scheduler, &MountScheduler::failed, this, &MounterService::mountFailed);
+}
+
+QHash<QString, QString> MounterService::mountedStates(const MountTable &table) {
+    QHash<QString, QString> states;
+    const QSet<QString> managed = table.managedPartitions();
+    for (const QString &token : managed) {
+        const QString uuid = token.mid(5); // "UUID=<uuid>"
+        // A drive mounted on access sits on top of its trigger; the table
+        // keeps the topmost one
+        const bool trigger = table.entries().value("/mnt/" + uuid).fsType == "autofs";
+        states.insert(uuid, trigger ? "automount" : "mounted");
+    }
+    return states;
+}
+
+// ----------------------------------------------------------------------------------------------
+// State tracking. Mounts and unmounts are read off the mount table, so ones
+// done behind the daemon's back are reported as well.
+// ----------------------------------------------------------------------------------------------
+void MounterService::mountTableChanged() {
+    const QHash<QString, QString> mounted = mountedStates(*m_table);
+
+    for (auto it = mounted.cbegin(); it != mounted.cend(); ++it) {
+        if (m_lastMounted.value(it.key()) != it.value()) {
+            m_errors.remove(it.key());
+            emit MountChanged(it.key(), it.value());
+        }
+    }
+    for (auto it = m_lastMounted.cbegin(); it != m_lastMounted.cend(); ++it) {
+        if (!mounted.contains(it.key())) {
+            emit MountChanged(it.key(), "unmounted");
+        }
+    }
+    m_lastMounted = mounted;
+}
+
+void MounterService::mountQueued(const QString &uuid) {
+    emit MountChanged(uuid, "pending");
+}
+
+void MounterService::mountFailed(const QString &uuid, const QString &error) {
+    m_errors.insert(uuid, error);
+    emit MountFailed(uuid, error);
+}
+
+QVariantMap MounterService::stateOf(const QString &uuid) const {
+    const QString mountDir = "/mnt/" + uuid;
+    QVariantMap state;
+
+    const auto entry = m_table->entries().constFind(mountDir);
+    if (entry != m_table->entries().cend() && entry->fsType == "autofs") {
+        state.insert("state", "automount");
+        state.insert("mountPoint", mountDir);
+    } else if (entry != m_table->entries().cend()) {
+        state.insert("state", "mounted");
+        state.insert("mountPoint", mountDir);
+        state.insert("fsType", entry->fsType);
+        state.insert("options", entry->options + "," + entry->superOptions);
+    } else if (m_scheduler->pending().contains(uuid)) {
+        state.insert("state", "pending");
+    } else if (m_errors.contains(uuid)) {
+        state.insert("state", "failed");
+        state.insert("error", m_errors.value(uuid));
+    } else {
+        state.insert("state", "unmounted");
+    }
+    return state;
+}
+
+QVariantMap MounterService::MountState(const QString &uuid) {
+    return stateOf(uuid);
+}
+
+QVariantMap MounterService::ListManaged() {
+    QSet<QString> uuids = m_scheduler->pending();
+    for (auto it = m_lastMounted.cbegin(); it != m_lastMounted.cend(); ++it) {
+        uuids.insert(it.key());
+    }
+    const QSet<QString> enabled = AdaMounterHelper::getManuallyEnabledPartitions();
+    for (const QString &token : enabled) {
+        uuids.insert(token.mid(5));
+    }
+
+    QVariantMap list;
+    for (const QString &uuid : std::as_const(uuids)) {
+        list.insert(uuid, stateOf(uuid));
+    }
+    return list;
+}
+
+// ----------------------------------------------------------------------------------------------
+// Apply. The reply is delayed until polkit has answered, so a password
+// prompt doesn't hold up the event loop (and with it mounting).
+// ----------------------------------------------------------------------------------------------
+bool MounterService::validLine(const QString &line) {
+    return kConfigLine.match(line).hasMatch();
+}
+
+bool MounterService::writeConfig(const QStringList &lines, QString *error) {
+    // QSaveFile writes a temporary file next to the config and renames it
+    // over on commit, so the watcher only ever sees the finished file.
+    QSaveFile file(AdaMounterHelper::configPath());
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        *error = file.errorString();
+        return false;
+    }
+    file.write("# list of enabled automount partitions\n");
+    for (const QString &line : lines) {
+        file.write(line.toUtf8() + '\n');
+    }
+    if (!file.commit()) {
+        *error = file.errorString();
+        return false;
+    }
+    return true;
+}
+
+void MounterService::Apply(const QStringList &desired) {
+    for (const QString &line : desired) {
+        if (!validLine(line)) {
+            sendErrorReply(QDBusError::InvalidArgs, "Invalid configuration line: " + line);
+            return;
+        }
+    }
+
+    setDelayedReply(true);
+    const QDBusMessage request = message();
+
+    const QDBusMessage check = PolkitAuthority::checkAuthorization(request.service(), kApplyAction);
+    QDBusPendingCallWatcher *watcher =
+        new QDBusPendingCallWatcher(connection().asyncCall(check, kAuthTimeoutMs), this);
+    connect(watcher, &QDBusPendingCallWatcher::finished, this,
+            [this, watcher, request, desired](QDBusPendingCallWatcher *) {
+        watcher->deleteLater();
+        QDBusConnection bus = QDBusConnection::systemBus();
+
+        // Only a refusal is AccessDenied; clients take that for a dismissed
+        // prompt, so a check that failed mustn't look like one
+        QString error;
+        bool denied = false;
+        if (!PolkitAuthority::isAuthorized(watcher->reply(), kApplyAction, &error, &denied)) {
+            bus.send(request.createErrorReply(denied ? QDBusError::AccessDenied : QDBusError::Failed, error));
+            return;
+        }
+
+        if (!writeConfig(desired, &error)) {
+            qWarning() << "Failed to write" << AdaMounterHelper::configPath() << ":" << error;
+            bus.send(request.createErrorReply(QDBusError::Failed, error));
+            return;
+        }
+
+        qDebug() << "Desired set applied over D-Bus:" << desired;
+        m_reconciler->schedule();
+        bus.send(request.createReply());
+    });
+}
@@ -0,0 +1,68 @@
+#ifndef MOUNTER_SERVICE_H
+#define MOUNTER_SERVICE_H
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QVariantMap>
+#include <QHash>
+#include <QSet>
+#include <QDBusContext>
+
+class MountTable;
+class MountScheduler;
+class Reconciler;
+
+// The daemon on the system bus as org.xray.ada.MounterHelper, so the GUI can
+// ask what was actually done instead of guessing from lsblk and the config.
+//
+// A state is one of "mounted", "automount" (an on-access trigger waiting for
+// its first access, or unmounted again after the idle timeout), "pending"
+// (queued or being mounted), "failed" or "unmounted". MountState() and
+// ListManaged() return it in a map with "state", "mountPoint", "fsType",
+// "options" and "error"; MountChanged / MountFailed push every transition.
+// Apply() replaces the desired set (config lines, see MountOptions for the
+// format) after a polkit check and reconciles right away.
+class MounterService : public QObject, protected QDBusContext
+{
+    Q_OBJECT
+    Q_CLASSINFO("D-Bus Interface", "org.xray.ada.MounterHelper")
+
+public:
+    MounterService(MountTable *table, MountScheduler *scheduler, Reconciler *reconciler,
+                   QObject *parent = nullptr);
+
+    static const char *serviceName() { return "org.xray.ada.MounterHelper"; }
+    static const char *objectPath() { return "/org/xray/ada/MounterHelper"; }
+
+public slots:
+    Q_SCRIPTABLE QVariantMap MountState(const QString &uuid);
+    // uuid -> state map, for every enabled or mounted managed partition.
+    Q_SCRIPTABLE QVariantMap ListManaged();
+    Q_SCRIPTABLE void Apply(const QStringList &desired);
+
+signals:
+    Q_SCRIPTABLE void MountChanged(const QString &uuid, const QString &state);
+    Q_SCRIPTABLE void MountFailed(const QString &uuid, const QString &error);
+
+private slots:
+    void mountTableChanged();
+    void mountQueued(const QString &uuid);
+    void mountFailed(const QString &uuid, const QString &error);
+
+private:
+    QVariantMap stateOf(const QString &uuid) const;
+    // uuid -> "mounted" or "automount" for everything under /mnt/<uuid>
+    static QHash<QString, QString> mountedStates(const MountTable &table);
+    static bool validLine(const QString &line);
+    static bool writeConfig(const QStringList &lines, QString *error);
+
+    MountTable *m_table;
+    MountScheduler *m_scheduler;
+    Reconciler *m_reconciler;
+
+    QHash<QString, QString> m_lastMounted;
+    QHash<QString, QString> m_errors;   // last failure per UUID, until it mounts
+};
+
+#endif // MOUNTER_SERVICE_H
@@ -0,0 +1,101 @@
+#include "reconciler.h"
+#include "ada_mounter_helper.h"
+#include "mount_table.h"
+#include <QSocketNotifier>
+#include <QFileInfo>
+#include <QDir>
+#include <QDebug>
+
+#include <sys/inotify.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+
+namespace {
+// Long enough to swallow a burst of writes, short enough to feel immediate
+const int kDebounceMs = 150;
+}
+
+Reconciler::Reconciler(MountTable *table, MountScheduler *scheduler, QObject *parent)
+    : QObject(parent)
+    , m_table(table)
+    , m_scheduler(scheduler)
+{
+    m_debounce.setSingleShot(true);
+    m_debounce.setInterval(kDebounceMs);
+    connect(&m_debounce, &QTimer::timeout, this, &Reconciler::reconcile);
+
+    m_lastManaged = m_table->managedPartitions();
+    connect(m_table, &MountTable::changed, this, &Reconciler::mountTableChanged);
+}
+
+Reconciler::~Reconciler() {
+    if (m_inotifyFd >= 0) {
+        ::close(m_inotifyFd);
+    }
+}
+
+bool Reconciler::watch(const QString &configPath) {
+    const QFileInfo configInfo(configPath);
+    m_configName = configInfo.fileName();
+
+    m_inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (m_inotifyFd < 0) {
+        qWarning() << "inotify_init1 failed:" << strerror(errno);
+        return false;
+    }
+
+    // The directory is watched, not the file, so a config replaced by
+    // rename() is still seen (as IN_MOVED_TO). On a fresh install Tolitica
+    // hasn't written it yet, so it is made here.
+    if (!QDir().mkpath(configInfo.absolutePath())) {
+        qWarning() << "Failed to create" << configInfo.absolutePath();
+    }
+    const QByteArray dir = configInfo.absolutePath().toLocal8Bit();
+    if (inotify_add_watch(m_inotifyFd, dir.constData(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0) {
+        qWarning() << "Failed to watch" << configInfo.absolutePath() << ":" << strerror(errno);
+        return false;
+    }
+    qDebug() << "Watching directory:" << configInfo.absolutePath();
+
+    m_notifier = new QSocketNotifier(m_inotifyFd, QSocketNotifier::Read, this);
+    connect(m_notifier, &QSocketNotifier::activated, this, &Reconciler::readEvents);
+    return true;
+}
+
+void Reconciler::readEvents() {
+    alignas(struct inotify_event) char buffer[4096];
+    ssize_t length;
+
+    while ((length = ::read(m_inotifyFd, buffer, sizeof(buffer))) > 0) {
+        for (char *ptr = buffer; ptr < buffer + length;) {
+            const struct inotify_event *event = reinterpret_cast<const struct inotify_event *>(ptr);
+            if (event->len > 0 && m_configName == QString::fromLocal8Bit(event->name)) {
+                qDebug() << "Configuration file written:" << m_configName;
+                schedule();
+            }
+            ptr += sizeof(struct inotify_event) + event->len;
+        }
+    }
+}
+
+void Reconciler::mountTableChanged() {
+    // Only mounts under /mnt/<uuid> matter here. Our own mounts land here
+    // too; the pass they trigger finds nothing left to do.
+    const QSet<QString> managed = m_table->managedPartitions();
+    if (managed == m_lastManaged) {
+        return;
+    }
+    qDebug() << "Mount table changed. Managed partitions:" << managed;
+    m_lastManaged = managed;
+    schedule();
+}
+
+void Reconciler::schedule() {
+    // Restarting the timer pushes the pass back until events stop arriving
+    m_debounce.start();
+}
+
+void Reconciler::reconcile() {
+    AdaMounterHelper::reconcile(*m_table, *m_scheduler);
+}
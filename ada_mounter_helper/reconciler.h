@@ -0,0 +1,46 @@
+#ifndef RECONCILER_H
+#define RECONCILER_H
+
+#include <QObject>
+#include <QString>
+#include <QSet>
+#include <QTimer>
+
+class MountTable;
+class MountScheduler;
+class QSocketNotifier;
+
+// Decides when to reconcile. The config directory is watched with inotify for
+// IN_CLOSE_WRITE / IN_MOVED_TO of manually_enabled.conf itself, so a file
+// still being written (or a sibling temp file) never triggers a pass, and
+// managed mount table changes are folded in too. Everything arriving within
+// the debounce window collapses into one AdaMounterHelper::reconcile().
+class Reconciler : public QObject
+{
+    Q_OBJECT
+
+public:
+    Reconciler(MountTable *table, MountScheduler *scheduler, QObject *parent = nullptr);
+    ~Reconciler();
+
+    bool watch(const QString &configPath);
+
+public slots:
+    void schedule();
+
+private slots:
+    void readEvents();
+    void mountTableChanged();
+    void reconcile();
+
+private:
+    MountTable *m_table;
+    MountScheduler *m_scheduler;
+    QString m_configName;
+    int m_inotifyFd = -1;
+    QSocketNotifier *m_notifier = nullptr;
+    QTimer m_debounce;
+    QSet<QString> m_lastManaged;
+};
+
+#endif // RECONCILER_H
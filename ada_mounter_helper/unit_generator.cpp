@@ -0,0 +1,140 @@
+#include "unit_generator.h"
+#include "ada_mounter_helper.h"
+#include "mount_options.h"
+#include "mount_table.h"
+#include "mounter.h"
+#include "mount_rules.h"
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QTextStream>
+#include <QDebug>
+
+namespace {
+const char *const kTarget = "ada-mounts.target";
+const char *const kDeviceTimeout = "10s";
+
+// Present once the generator has run for this boot
+const char *const kGeneratedTarget = "/run/systemd/generator/ada-mounts.target";
+
+const char *const kHeader = "# Automatically generated by ada_mounter_helper from manually_enabled.conf\n\n";
+}
+
+QString UnitGenerator::escapePath(const QString &path) {
+    return QString::fromStdString(MountRules::escapePath(path.toStdString()));
+}
+
+bool UnitGenerator::writeFile(const QString &path, const QString &content) {
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) {
+        qWarning() << "Failed to write" << path << ":" << file.errorString();
+        return false;
+    }
+    file.write(content.toUtf8());
+    return true;
+}
+
+bool UnitGenerator::wantedBy(const QString &dir, const QString &target, const QString &unit) {
+    const QString wantsDir = dir + "/" + target + ".wants";
+    if (!QDir().mkpath(wantsDir)) {
+        qWarning() << "Failed to create" << wantsDir;
+        return false;
+    }
+    return QFile::link("../" + unit, wantsDir + "/" + unit);
+}
+
+// ----------------------------------------------------------------------------------------------
+// One .mount per enabled UUID, plus a drop-in on its device for the timeout.
+// Options are resolved as the daemon would (see MountOptions); the
+// filesystem type comes from blkid when the device is already there, and a
+// device that isn't is simply left to the nofail mount.
+// ----------------------------------------------------------------------------------------------
+bool UnitGenerator::generate(const QString &dir) {
+    MountOptions options;
+    const QSet<QString> enabled = AdaMounterHelper::getManuallyEnabledPartitions(&options);
+    const QString configPath = AdaMounterHelper::configPath();
+
+    // Not waited for by local-fs.target (no default dependencies, so no
+    // implicit After= on the mounts it wants)
+    bool ok = writeFile(dir + "/" + kTarget,
+                        QString(kHeader)
+                        + "[Unit]\n"
+                        + "Description=Drives managed by ada_mounter_helper\n"
+                        + "SourcePath=" + configPath + "\n"
+                        + "DefaultDependencies=no\n")
+              && wantedBy(dir, "local-fs.target", kTarget);
+
+    for (const QString &token : enabled) {
+        const QString uuid = token.mid(5);
+        const QString what = "/dev/disk/by-uuid/" + uuid;
+        const QString where = "/mnt/" + uuid;
+        const QString mountUnit = escapePath(where) + ".mount";
+        const QString deviceUnit = escapePath(what) + ".device";
+
+        QString device, fsType;
+        Mounter::resolve(uuid, &device, &fsType);
+
+        // blkid says "ntfs"; ask for the in-kernel driver rather than letting
+        // mount pick the FUSE helper
+        const QString type = QString::fromStdString(MountRules::kernelType(fsType.toStdString()));
+
+        QString unitOptions = QString("nofail,x-systemd.device-timeout=") + kDeviceTimeout;
+        const QString resolved = options.resolve(uuid, device.isEmpty() ? what : device, fsType);
+        if (!resolved.isEmpty()) {
+            unitOptions += "," + resolved;
+        }
+
+        QString unit = QString(kHeader)
+                       + "[Unit]\n"
+                       + "Description=Managed drive " + uuid + "\n"
+                       + "SourcePath=" + configPath + "\n"
+                       + "\n[Mount]\n"
+                       + "What=" + what + "\n"
+                       + "Where=" + where + "\n";
+        if (!type.isEmpty()) {
+            unit += "Type=" + type + "\n";
+        }
+        unit += "Options=" + unitOptions + "\n";
+
+        // On-access drives: the target wants the trigger, which pulls in
+        // the mount on first access
+        QString triggerUnit = mountUnit;
+        int idleSeconds = 0;
+        if (options.onAccess(uuid, &idleSeconds)) {
+            triggerUnit = escapePath(where) + ".automount";
+            QString automount = QString(kHeader)
+                                + "[Unit]\n"
+                                + "Description=Managed drive " + uuid + " (on access)\n"
+                                + "SourcePath=" + configPath + "\n"
+                                + "\n[Automount]\n"
+                                + "Where=" + where + "\n";
+            if (idleSeconds > 0) {
+                automount += QString("TimeoutIdleSec=%1\n").arg(idleSeconds);
+            }
+            ok = writeFile(dir + "/" + triggerUnit, automount) && ok;
+        }
+
+        const QString dropInDir = dir + "/" + deviceUnit + ".d";
+        ok = writeFile(dir + "/" + mountUnit, unit)
+             && wantedBy(dir, kTarget, triggerUnit)
+             && QDir().mkpath(dropInDir)
+             && writeFile(dropInDir + "/50-ada-device-timeout.conf",
+                          QString(kHeader) + "[Unit]\nJobRunningTimeoutSec=" + kDeviceTimeout + "\n")
+             && ok;
+    }
+    return ok;
+}
+
+bool UnitGenerator::syncUnmounts() {
+    MountTable table;
+    if (!table.open()) {
+        return false;
+    }
+    AdaMounterHelper::enforceUnmounts(table.managedPartitions()
+                                      - AdaMounterHelper::getManuallyEnabledPartitions());
+    return true;
+}
+
+bool UnitGenerator::isActive() {
+    return QFileInfo::exists(kGeneratedTarget);
+}
@@ -0,0 +1,40 @@
+#ifndef UNIT_GENERATOR_H
+#define UNIT_GENERATOR_H
+
+#include <QString>
+
+// systemd generator mode. Invoked as ada-mounter-generator (a symlink in
+// /usr/lib/systemd/system-generators), the binary reads manually_enabled.conf
+// and writes one native .mount unit per enabled UUID (plus an .automount for
+// on-access ones), so systemd mounts the drives in parallel with the rest of
+// boot and no daemon stays resident.
+//
+// The units hang off ada-mounts.target, which local-fs.target wants but does
+// not wait for: every mount is nofail and its device gets a short
+// JobRunningTimeoutSec (what fstab's x-systemd.device-timeout turns into),
+// so a missing drive never holds up boot. ada-mounter-sync.path re-runs the
+// generator on config changes through ada-mounter-sync.service, which also
+// calls syncUnmounts() for drives that were disabled.
+class UnitGenerator
+{
+public:
+    // Writes the units into dir (the generator's "normal" directory).
+    static bool generate(const QString &dir);
+
+    // Unmounts managed drives that are no longer enabled; their units are
+    // gone after the reload but the filesystems stay mounted.
+    static bool syncUnmounts();
+
+    // True when the running system's units come from the generator, in which
+    // case the daemon has nothing to do.
+    static bool isActive();
+
+    // systemd-escape --path
+    static QString escapePath(const QString &path);
+
+private:
+    static bool writeFile(const QString &path, const QString &content);
+    static bool wantedBy(const QString &dir, const QString &target, const QString &unit);
+};
+
+#endif // UNIT_GENERATOR_H
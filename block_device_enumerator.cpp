@@ -0,0 +1,82 @@
+#include "block_device_enumerator.h"
+
+#include <QSocketNotifier>
+#include <QtConcurrent/QtConcurrent>
+#include <QDebug>
+
+#include <libudev.h>
+
+namespace {
+// How long udev events are collected before a rescan
+const int kEventSettleMs = 250;
+}
+
+BlockDeviceEnumerator::BlockDeviceEnumerator(QObject *parent)
+    : QObject(parent)
+{
+    connect(&m_watcher, &QFutureWatcherBase::finished, this, &BlockDeviceEnumerator::scanFinished);
+
+    m_eventTimer.setSingleShot(true);
+    m_eventTimer.setInterval(kEventSettleMs);
+    connect(&m_eventTimer, &QTimer::timeout, this, &BlockDeviceEnumerator::enumerate);
+}
+
+BlockDeviceEnumerator::~BlockDeviceEnumerator() {
+    if (m_monitor) {
+        udev_monitor_unref(m_monitor);
+    }
+    if (m_udev) {
+        udev_unref(m_udev);
+    }
+}
+
+bool BlockDeviceEnumerator::startMonitoring() {
+    if (m_notifier) {
+        return true;
+    }
+    m_udev = udev_new();
+    if (!m_udev) {
+        qWarning() << "Failed to create udev context";
+        return false;
+    }
+
+    // "udev" events come after the device was probed, so a scan started by
+    // one finds the filesystem properties in udev's database
+    m_monitor = udev_monitor_new_from_netlink(m_udev, "udev");
+    if (!m_monitor
+        || udev_monitor_filter_add_match_subsystem_devtype(m_monitor, "block", nullptr) < 0
+        || udev_monitor_enable_receiving(m_monitor) < 0) {
+        qWarning() << "Failed to set up the udev block monitor";
+        return false;
+    }
+
+    m_notifier = new QSocketNotifier(udev_monitor_get_fd(m_monitor), QSocketNotifier::Read, this);
+    connect(m_notifier, &QSocketNotifier::activated, this, &BlockDeviceEnumerator::receiveEvents);
+    return true;
+}
+
+void BlockDeviceEnumerator::receiveEvents() {
+    // Drain the socket; which device it was doesn't matter, the scan sees all
+    while (struct udev_device *device = udev_monitor_receive_device(m_monitor)) {
+        udev_device_unref(device);
+    }
+    m_eventTimer.start();
+}
+
+void BlockDeviceEnumerator::enumerate() {
+    if (m_watcher.isRunning()) {
+        m_rescan = true;
+        return;
+    }
+    m_watcher.setFuture(QtConcurrent::run(&DeviceInventory::scan));
+}
+
+void BlockDeviceEnumerator::scanFinished() {
+    m_snapshot = m_watcher.result();
+    emit snapshotReady(m_snapshot);
+
+    if (m_rescan) {
+        m_rescan = false;
+        enumerate();
+    }
+}
@@ -0,0 +1,59 @@
+#ifndef BLOCK_DEVICE_ENUMERATOR_H
+#define BLOCK_DEVICE_ENUMERATOR_H
+
+#include <QObject>
+#include <QSharedPointer>
+#include <QFutureWatcher>
+#include <QTimer>
+
+#include "device_inventory.h"
+
+struct udev;
+struct udev_monitor;
+class QSocketNotifier;
+
+// Block device enumeration off the GUI thread. Each scan is a
+// DeviceInventory::scan() on a pool thread (see device_inventory/ for where
+// the data comes from).
+//
+// A sleeping or hung disk can take long to probe; it only holds up the pool
+// thread, and the list is drawn when snapshotReady() arrives.
+//
+// With startMonitoring() udev's block events trigger the scans: a burst of
+// them (a disk and its partitions showing up) is collected for a moment and
+// answered with one scan, and nothing runs while nothing changes.
+class BlockDeviceEnumerator : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit BlockDeviceEnumerator(QObject *parent = nullptr);
+    ~BlockDeviceEnumerator();
+
+    // Starts a scan. Asking again while one is running queues one more.
+    void enumerate();
+
+    // Rescans whenever a block device is added, removed or changed.
+    bool startMonitoring();
+
+    // Latest published snapshot; null before the first scan finished.
+    QSharedPointer<const BlockDeviceSnapshot> snapshot() const { return m_snapshot; }
+
+signals:
+    void snapshotReady(QSharedPointer<const BlockDeviceSnapshot> snapshot);
+
+private:
+    void scanFinished();
+    void receiveEvents();
+
+    QFutureWatcher<QSharedPointer<const BlockDeviceSnapshot>> m_watcher;
+    QSharedPointer<const BlockDeviceSnapshot> m_snapshot;
+    bool m_rescan = false;
+
+    struct udev *m_udev = nullptr;
+    struct udev_monitor *m_monitor = nullptr;
+    QSocketNotifier *m_notifier = nullptr;
+    QTimer m_eventTimer;
+};
+
+#endif // BLOCK_DEVICE_ENUMERATOR_H
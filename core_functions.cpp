@@ -1,5 +1,9 @@
 #include "core_functions.h"
 #include "connectivityChecker.h"
+#include "package_database.h"
+#include "system_facts.h"
+#include "systemd_units.h"
+#include "progress_model.h"
 
 #include <QMessageBox>
 #include <QStackedWidget>
@@ -11,7 +15,6 @@
 #include <QDir>
 #include <QDebug>
 #include <QProgressDialog>
-#include <QTimer>
 #include <QFile>
 #include <QTextStream>
 #include <QComboBox>
@@ -28,7 +31,7 @@
 #include <QDebug>
 #include <QDesktopServices>
 #include <QUrl>
-#include "widget.h"
+#include "core_services.h"
 
 #include <QJsonDocument>
 #include <QJsonObject>
@@ -47,18 +50,7 @@
 /// TERMINAL: GET THE CURRENT SHELL
 //////////////////////////////////////////////////
 QString CoreFunctions::getCurrentShell() {
-    QProcess process;
-    process.start("getent", QStringList() << "passwd" << qgetenv("USER"));
-    process.waitForFinished();
-    QString output = process.readAllStandardOutput().trimmed();
-
-    if (output.isEmpty()) {
-        qDebug() << "Failed to fetch current shell";
-        return "Unknown";
-    }
-
-    QStringList fields = output.split(":");
-    return fields.last(); // Extracts shell from passwd entry
+    return SystemFacts::snapshot()->loginShell();
 }
 
 ///////////////////////////////////////////////////
@@ -99,6 +91,7 @@ void CoreFunctions::changeShell(QWidget *parent, const QString &selectedShell) {
     QProcess process;
     process.start("pkexec", QStringList() << "chsh" << "-s" << selectedShell << username); // Use `pkexec` for permissions
     process.waitForFinished();
+    SystemFacts::gather(SystemFacts::Shell);
 
     if (process.exitCode() == 0) {
         QMessageBox::information(parent, "Shell Change", "Shell changed successfully to: " + selectedShell + ". Please reboot your system to see the changes");
@@ -115,14 +108,9 @@ void CoreFunctions::changeShell(QWidget *parent, const QString &selectedShell) {
 /// TWEAKS: BLUETOOTH STATUS
 /////////////////////////////////////////////////
 int CoreFunctions::bluetoothStatus() {
-    QProcess bluetoothService;
-    bluetoothService.start("bash", QStringList() << "-c" << "systemctl is-enabled bluetooth.service");
-    bluetoothService.waitForFinished();
-    bool bluetoothEnabled = (bluetoothService.exitCode() == 0);
-
-    bluetoothService.start("bash", QStringList() << "-c" << "systemctl is-active bluetooth.service");
-    bluetoothService.waitForFinished();
-    bool bluetoothActive = (bluetoothService.exitCode() == 0);
+    SystemdUnits::UnitState bluetoothService = SystemdUnits::instance().state("bluetooth.service");
+    bool bluetoothEnabled = bluetoothService.isEnabled();
+    bool bluetoothActive = bluetoothService.isActive();
 
     if (bluetoothEnabled && bluetoothActive) {
         return 0;
@@ -191,40 +179,26 @@ int CoreFunctions::apparmorStatus() {
     }
 
     // Check if the AppArmor package is installed.
-    process.start("bash", QStringList() << "-c" << "pacman -Q apparmor");
-    process.waitForFinished();
-    bool pkgInstalled = (process.exitCode() == 0);
+    bool pkgInstalled = PackageDatabase::instance().isInstalled("apparmor");
 
     // Check if the AppArmor service is enabled.
-    process.start("bash", QStringList() << "-c" << "systemctl is-enabled apparmor.service");
-    process.waitForFinished();
-    bool isEnabled = (process.exitCode() == 0);
+    bool isEnabled = SystemdUnits::instance().state("apparmor.service").isEnabled();
 
     // Check if GRUB includes the necessary AppArmor parameters.
-    QFile grubFile("/etc/default/grub");
+    QString grubParams = SystemFacts::snapshot()->grubCmdlineDefault();
     bool grubSet = false;
 
-    if(grubFile.open(QIODevice::ReadOnly | QIODevice::Text)) {
-        QString grubContent = QTextStream(&grubFile).readAll();
-        grubFile.close();
-
-        // Regular expression to capture the GRUB_CMDLINE_LINUX_DEFAULT contents:
-        static const QRegularExpression grubRegex(R"(GRUB_CMDLINE_LINUX_DEFAULT=(['\"])(.*?)\1)");
-        QRegularExpressionMatch match = grubRegex.match(grubContent);
-
-        if (match.hasMatch()) {
-            QString grubParams = match.captured(2); // Extract the command line parameters.
-            qDebug() << "Extracted GRUB parameters:" << grubParams;
-
-            // Check for each individual required token.
-            QStringList requiredParams = {"landlock", "lockdown", "yama", "integrity", "apparmor", "bpf"};
-            grubSet = true;
-            for (const QString &token : requiredParams) {
-                if (!grubParams.contains(token)) {
-                    grubSet = false;
-                    qDebug() << "Missing GRUB parameter:" << token;
-                    break;
-                }
+    if (!grubParams.isEmpty()) {
+        qDebug() << "Extracted GRUB parameters:" << grubParams;
+
+        // Check for each individual required token.
+        QStringList requiredParams = {"landlock", "lockdown", "yama", "integrity", "apparmor", "bpf"};
+        grubSet = true;
+        for (const QString &token : requiredParams) {
+            if (!grubParams.contains(token)) {
+                grubSet = false;
+                qDebug() << "Missing GRUB parameter:" << token;
+                break;
             }
         }
     }
@@ -278,7 +252,6 @@ void CoreFunctions::enableAppArmor(QWidget *parent, QCheckBox *apparmorToggle) {
 
     // Prepare asynchronous progress reporting.
     QProcess *process = new QProcess(parent);
-    QTimer *monitorTimer = new QTimer(parent);
     QProgressDialog *progress = new QProgressDialog(
         currentlyEnabled ? "Disabling AppArmor..." : "Enabling AppArmor...",
         nullptr, 0, 100, parent
@@ -287,16 +260,14 @@ void CoreFunctions::enableAppArmor(QWidget *parent, QCheckBox *apparmorToggle) {
     progress->setCancelButton(nullptr);
     progress->show();
 
-    int progressValue = 0;
-    connect(process, &QProcess::readyReadStandardOutput, parent, [=]() mutable {
-        progressValue += 5;
-        progress->setValue(qMin(progressValue, 95));
-        QCoreApplication::processEvents();
-    });
+    ProgressModel *model = new ProgressModel(progress);
+    model->attach(progress);
+    model->follow(process);
 
     connect(process, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished),
             parent, [=]() mutable {
-                progress->setValue(100);
+                model->finish();
+                SystemFacts::gather(SystemFacts::Grub);
                 if (process->exitCode() == 0) {
                     // Toggle the current state.
                     bool newState = !currentlyEnabled;
@@ -316,7 +287,6 @@ void CoreFunctions::enableAppArmor(QWidget *parent, QCheckBox *apparmorToggle) {
                 }
                 progress->deleteLater();
                 process->deleteLater();
-                monitorTimer->deleteLater();
             });
 
     // Our AppArmor parameter (note the leading space)
@@ -334,7 +304,7 @@ void CoreFunctions::enableAppArmor(QWidget *parent, QCheckBox *apparmorToggle) {
     } else {
         // Command to enable AppArmor.
         command = QString(
-                      "pacman -Q apparmor || pacman -S --noconfirm apparmor; "
+                      "pacman -Q apparmor || " + ProgressModel::pacmanCommand("-S --noconfirm apparmor") + "; "
                       "systemctl enable apparmor.service; "
                       "systemctl start apparmor.service; "
                       "sed -Ei \"s/%1//g\" /etc/default/grub; "
@@ -347,7 +317,6 @@ void CoreFunctions::enableAppArmor(QWidget *parent, QCheckBox *apparmorToggle) {
     }
 
     process->start("pkexec", QStringList() << "bash" << "-c" << command);
-    monitorTimer->start(250);
 }
 
 ///////////////////////////////////////////////////
@@ -518,11 +487,9 @@ void CoreFunctions::rankMirrors(QWidget *parent, int mirrorCount) {
 /// ADDONS: CHECK FLATPAK STATUS
 //////////////////////////////////////////////////
 int CoreFunctions::flatpakStatus() {
-    QProcess flatpakStatus;
-    flatpakStatus.start("bash", QStringList() << "-c" << "pacman -Q flatpak");
-    flatpakStatus.waitForFinished();
-    bool pkgInstalled = (flatpakStatus.exitCode() == 0);
+    bool pkgInstalled = PackageDatabase::instance().isInstalled("flatpak");
 
+    QProcess flatpakStatus;
     flatpakStatus.start("bash", QStringList() << "-c" << "flatpak remotes | grep -q flathub");
     flatpakStatus.waitForFinished();
     bool repoSet = (flatpakStatus.exitCode() == 0);
@@ -561,7 +528,6 @@ void CoreFunctions::enableFlatpak(QWidget *parent, QCheckBox *flatpakToggle, std
     }
 
     QProcess *process = new QProcess(parent);
-    QTimer *monitorTimer = new QTimer(parent);
 
     QProgressDialog *progress = new QProgressDialog(
         status == 0 ? "Removing Flatpak..." : "Installing Flatpak...", nullptr, 0, 100, parent);
@@ -570,38 +536,23 @@ void CoreFunctions::enableFlatpak(QWidget *parent, QCheckBox *flatpakToggle, std
     progress->setValue(0);
     progress->show();
 
-    QCoreApplication::processEvents(); // forcing immediate rendering before the process starts
-
-    int progressValue = 0;
-
-    // **Real-Time progress update using process output**
-    connect(process, &QProcess::readyReadStandardOutput, parent, [=]() mutable {
-        progressValue += 5;
-        progress->setValue(qMin(progressValue, 95));
-        QCoreApplication::processEvents();
-    });
-
-    // Using monitorTimer to simulate progress updates if process output is insufficient
-    connect(monitorTimer, &QTimer::timeout, parent, [=]() mutable {
-        if (progressValue < 0) {
-            progressValue += 2;
-            progress->setValue(qMin(progressValue, 95));
-        }
-    });
-    monitorTimer->start(250);
+    // **Real-Time progress from pacman's output**
+    ProgressModel *model = new ProgressModel(progress);
+    model->attach(progress);
+    model->follow(process);
 
     // **Update the button immediately when installation is completed**
     connect(process, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished),
     parent, [=]() mutable {
-        monitorTimer->stop();
+        model->finish();
+        qDebug() << "PROCESS-OUTPUT: " << process->exitCode();
 
-        if (process->exitCode() == 0){
-            progress->setValue(100);
+        bool success = (process->exitCode() == 0);
+        if (success) {
             flatpakToggle->setChecked(status != 0);
             flatpakToggle->setText(flatpakToggle->isChecked() ? "Disable/Remove Flatpak"
                                                               : "Enable/Install Flatpak");
         } else {
-            progress->setValue(100);
             QMessageBox::warning(parent, "Error", "Failed performing operations with Flatpak:\n"
                                  + process->readAllStandardError());
         }
@@ -609,11 +560,12 @@ void CoreFunctions::enableFlatpak(QWidget *parent, QCheckBox *flatpakToggle, std
         // Cleanup
         progress->deleteLater();
         process->deleteLater();
-        monitorTimer->deleteLater();
+
+        if (onComplete) onComplete(success);
     });
 
-    QString enableCommand = "pacman -S --noconfirm flatpak && flatpak remote-add --if-not-exists flathub https://flathub.org/repo/flathub.flatpakrepo";
-    QString disableCommand = "flatpak uninstall --all --assumeyes && flatpak remotes | grep -q flathub && flatpak remote-delete flathub && sudo pacman -Rcns --noconfirm flatpak";
+    QString enableCommand = ProgressModel::pacmanCommand("-S --noconfirm flatpak") + " && flatpak remote-add --if-not-exists flathub https://flathub.org/repo/flathub.flatpakrepo";
+    QString disableCommand = "flatpak uninstall --all --assumeyes && flatpak remotes | grep -q flathub && flatpak remote-delete flathub && " + ProgressModel::pacmanCommand("-Rcns --noconfirm flatpak");
     QString command = (status == 0) ? disableCommand : enableCommand;
 
     // Steps to verify offline installation integrity
@@ -644,53 +596,35 @@ void CoreFunctions::enableFlatpak(QWidget *parent, QCheckBox *flatpakToggle, std
     // * Check for Internet
     ConnectivityChecker *internetChecker = new ConnectivityChecker(parent);
     connect(internetChecker, &ConnectivityChecker::connectivityChecked,
-        parent, [internetChecker, command, offlinePath, process, flatpakToggle,
-        status, onComplete](bool isConnected) {
+        parent, [internetChecker, command, offlinePath, process, status](bool isConnected) {
             qDebug() << "OUTPUT: isConnected =" << isConnected;
             QString cmdToRun;
             if (!isConnected && status != 0) {
-                cmdToRun = QString("sudo pacman -U --noconfirm %1/*.zst && "
-                "flatpak remote-add --if-not-exists flathub %1/flathub.flatpakrepo"
+                cmdToRun = ProgressModel::pacmanCommand(QString("-U --noconfirm %1/*.zst").arg(offlinePath))
+                    + QString(" && flatpak remote-add --if-not-exists flathub %1/flathub.flatpakrepo"
                 ).arg(offlinePath);
             } else {
                 cmdToRun = command;
             }
             qDebug() << "CMD_TO_RUN: " << cmdToRun;
 
-        // now actually run it
+        // now actually run it; the finished handler reports the outcome
         process->start("pkexec", QStringList() << "bash" << "-c" << cmdToRun);
-        qDebug() << "PROCESS-OUTPUT: " << process;
-        process->waitForFinished();
-
-        bool success = (process->exitCode() == 0);
-        if (success && flatpakToggle) {
-            flatpakToggle->setChecked(status != 0);
-            flatpakToggle->setText(flatpakToggle->isChecked() ?
-                "Disable/Remove Flatpak" : "Enable/Install Flatpak");
-        }
-
-        if (onComplete) onComplete(success);
         internetChecker->deleteLater();
     });
     // Kick off the check
     internetChecker->checkConnectivity();
-
-    monitorTimer->start(250);
 }
 
 ///////////////////////////////////////////////////
 /// ADDONS: SNAPD-STATUS
 //////////////////////////////////////////////////
 int CoreFunctions::snapdStatus() {
-    QProcess process;
-    process.start("bash", QStringList() << "-c" << "pacman -Q snapd");
-    process.waitForFinished();
-    bool pkgInstalled = (process.exitCode() == 0);
+    bool pkgInstalled = PackageDatabase::instance().isInstalled("snapd");
 
-    process.start("bash", QStringList() << "-c" << "systemctl is-enabled snapd.socket");
-    process.waitForFinished();
-    bool isEnabled = (process.exitCode() == 0);
+    bool isEnabled = SystemdUnits::instance().state("snapd.socket").isEnabled();
 
+    QProcess process;
     process.start("bash", QStringList() << "-c" << "readlink /snap");
     process.waitForFinished();
     bool linkExist = (QString(process.readAllStandardOutput()).trimmed() == "/var/lib/snapd/snap");
@@ -730,7 +664,6 @@ void CoreFunctions::enableSnapd(QWidget *parent, QCheckBox *snapdToggle,
     }
 
     QProcess *process = new QProcess(parent);
-    QTimer *monitorTimer = new QTimer(parent);
 
     QProgressDialog *progress = new QProgressDialog(
         status == 0 ? "Removing Snapd..." : "Installing Snapd...", nullptr, 0, 100, parent);
@@ -739,46 +672,48 @@ void CoreFunctions::enableSnapd(QWidget *parent, QCheckBox *snapdToggle,
     progress->setValue(0);
     progress->show();
 
-    QCoreApplication::processEvents(); // forcing rendering before the process starts
-    int progressValue = 0;
-
-    connect(process, &QProcess::readyReadStandardOutput, parent, [=]() mutable {
-        progressValue += 5;
-        progress->setValue(qMin(progressValue, 95));
-        QCoreApplication::processEvents();
-    });
+    ProgressModel *model = new ProgressModel(progress);
+    model->attach(progress);
+    model->follow(process);
 
-    connect(monitorTimer, &QTimer::timeout, parent, [=]() mutable {
-        if (progressValue < 0) {
-            progressValue += 2;
-            progress->setValue(qMin(progressValue, 95));
-        }
-    });
-    monitorTimer->start(250);
+    // The command is filled in once connectivity is known; failed runs are
+    // retried after cleaning the package cache.
+    QString *cmdToRun = new QString;
+    int attempts = 1;
 
     connect(process, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished),
         parent, [=]() mutable {
-        monitorTimer->stop();
+        qDebug() << "PROCESS-OUTPUT: " << process->exitCode();
 
-        if (process->exitCode() == 0){
-            progress->setValue(100);
+        if (process->exitCode() != 0 && attempts < 3) {
+            attempts++;
+            CoreServices::cleanCache();
+            model->reset();
+            process->start("pkexec", QStringList() << "bash" << "-c" << *cmdToRun);
+            return;
+        }
+        model->finish();
+
+        bool success = (process->exitCode() == 0);
+        if (success) {
             snapdToggle->setChecked(status != 0);
             snapdToggle->setText(snapdToggle->isChecked() ?
-                "Disable/Remove SNAPD" : "Enable/Install SNAPD");
+                "Disable/Remove Snapd" : "Enable/Install Snapd");
         } else {
-            progress->setValue(100);
             QMessageBox::warning(parent, "Error", "Failed performing operations with Snapd:\n"
                 + process->readAllStandardError());
         }
 
         progress->deleteLater();
         process->deleteLater();
-        monitorTimer->deleteLater();
+        delete cmdToRun;
+
+        if (onComplete) onComplete(success);
     });
 
-    QString enableCommand = "pacman -S --noconfirm snapd && systemctl enable --now snapd.socket && "
+    QString enableCommand = ProgressModel::pacmanCommand("-S --noconfirm snapd") + " && systemctl enable --now snapd.socket && "
                             "ln -s /var/lib/snapd/snap /snap";
-    QString disableCommand = "pacman -Rcns --noconfirm snapd && sudo rm -rf /snap && rm -rf /var/lib/snapd";
+    QString disableCommand = ProgressModel::pacmanCommand("-Rcns --noconfirm snapd") + " && sudo rm -rf /snap && rm -rf /var/lib/snapd";
     QString command = (status == 0) ? disableCommand : enableCommand;
 
     // Verify if theres online connection
@@ -797,48 +732,22 @@ void CoreFunctions::enableSnapd(QWidget *parent, QCheckBox *snapdToggle,
 
     ConnectivityChecker *internetChecker = new ConnectivityChecker(parent);
     connect(internetChecker, &ConnectivityChecker::connectivityChecked,
-        parent, [internetChecker, command, offlinePath, process, snapdToggle,
-        status, onComplete](bool isConnected) {
+        parent, [internetChecker, command, offlinePath, process, cmdToRun,
+        status](bool isConnected) {
             qDebug() << "OUTPUT: isConnected =" << isConnected;
-            QString cmdToRun;
             if (!isConnected && status != 0) {
-                cmdToRun = QString("sudo pacman -U --noconfirm %1/*.zst && "
-                    "ln -s /var/lib/snapd/snap /snap").arg(offlinePath);
+                *cmdToRun = ProgressModel::pacmanCommand(QString("-U --noconfirm %1/*.zst").arg(offlinePath))
+                    + " && ln -s /var/lib/snapd/snap /snap";
             } else {
-                cmdToRun = command;
-            }
-            qDebug() << "CMD_TO_RUN: " << cmdToRun;
-
-        int attempts = 0;
-        do {
-            process->start("pkexec", QStringList() << "bash" << "-c" << cmdToRun);
-            process->waitForFinished();
-
-            if (process->exitCode() != 0 && attempts < 2) {
-                Widget tempWidget;
-                tempWidget.cleanCache();
-                attempts++;
+                *cmdToRun = command;
             }
-        } while (process->exitCode() != 0 && attempts < 3);
-
+            qDebug() << "CMD_TO_RUN: " << *cmdToRun;
 
-        qDebug() << "PROCESS-OUTPUT: " << process;
-        process->waitForFinished();
-
-        bool success = (process->exitCode() == 0);
-        if (success && snapdToggle) {
-            snapdToggle->setChecked(status != 0);
-            snapdToggle->setText(snapdToggle->isChecked() ?
-                "Disable/Remove Snapd" : "Enable/Install Snapd");
-        }
-
-        if (onComplete) onComplete(success);
+        process->start("pkexec", QStringList() << "bash" << "-c" << *cmdToRun);
         internetChecker->deleteLater();
     });
     // Kick off the check
     internetChecker->checkConnectivity();
-
-    monitorTimer->start(250);
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
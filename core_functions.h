@@ -30,7 +30,7 @@ public:
     // ADDONS
     static int flatpakStatus();
     static void enableFlatpak(QWidget *parent, QCheckBox *flatpakToggle, std::function<void(bool)> onComplete = nullptr);
-    int snapdStatus();
+    static int snapdStatus();
     void enableSnapd(QWidget *parent, QCheckBox *snapdToggle, std::function<void(bool)> onComplete = nullptr);
 
     // SOCIAL MEDIA
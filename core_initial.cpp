@@ -1,5 +1,9 @@
 #include "core_initial.h"
 #include "connectivityChecker.h"
+#include "package_database.h"
+#include "system_facts.h"
+#include "privileged_helper.h"
+#include "progress_model.h"
 
 #include <QProcess>
 #include <QDBusInterface>
@@ -14,43 +18,57 @@
 
 // for progress bar
 #include <QProgressDialog>
-#include <QTimer>
 #include <cstddef>
 
 CoreInitial::CoreInitial(QObject *parent)
     : QObject(parent)
 {}
 
-bool CoreInitial::themeStatus()
-{
-    const QString configDir = QStandardPaths::writableLocation(
-        QStandardPaths::ConfigLocation
-    );
-    const QString cfgFile = QDir(configDir).filePath("kdeglobals");
+namespace {
+const int kPackageAttempts = 3;
+
+// Runs "pacman <arguments>" as root with its real progress on the dialog.
+// A failed run is retried, with beforeRetry (a shell prefix) run first.
+void runPackageCommand(QProgressDialog *progress, const QString &arguments,
+                       const QString &beforeRetry, std::function<void(bool)> done) {
+    QProcess *process = new QProcess(progress);
+    ProgressModel *model = new ProgressModel(progress);
+    model->attach(progress);
+    model->follow(process);
+
+    const QString command = ProgressModel::pacmanCommand(arguments);
+    qDebug() << "CMD_TO_RUN: " << command;
+    int attempts = 1;
+
+    QObject::connect(process, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished),
+                     progress, [=](int exitCode, QProcess::ExitStatus status) mutable {
+        qDebug() << "PROCESS-OUTPUT: " << exitCode;
+        const bool success = (status == QProcess::NormalExit && exitCode == 0);
+
+        if (!success && attempts < kPackageAttempts) {
+            attempts++;
+            model->reset();
+            process->start("pkexec", QStringList() << "bash" << "-c" << beforeRetry + command);
+            return;
+        }
 
-    QSettings settings(cfgFile, QSettings::IniFormat);
+        model->finish();
+        progress->deleteLater();
+        if (done) done(success);
+    });
 
-    settings.beginGroup("KDE");
-    const QString current = settings.value("LookAndFeelPackage", QString()).toString();
-    settings.endGroup();
+    process->start("pkexec", QStringList() << "bash" << "-c" << command);
+}
+}
 
-    return (current == "org.kde.breezedark.desktop");
+bool CoreInitial::themeStatus()
+{
+    return (SystemFacts::snapshot()->lookAndFeelPackage() == "org.kde.breezedark.desktop");
 }
 
 bool CoreInitial::xrayThemeStatus()
 {
-    const QString configDir = QStandardPaths::writableLocation(
-        QStandardPaths::ConfigLocation
-    );
-    const QString cfgFile = QDir(configDir).filePath("kdeglobals");
-
-    QSettings settings(cfgFile, QSettings::IniFormat);
-
-    settings.beginGroup("KDE");
-    const QString current = settings.value("LookAndFeelPackage", QString()).toString();
-    settings.endGroup();
-
-    return (current == "XRAY-DARK.desktop");
+    return (SystemFacts::snapshot()->lookAndFeelPackage() == "XRAY-DARK.desktop");
 }
 
 void CoreInitial::applyGlobalTheme(const QString &themeId)
@@ -59,6 +77,7 @@ void CoreInitial::applyGlobalTheme(const QString &themeId)
 
     // Use lookandfeeltool exactly like systemsettings does
     QProcess::execute("lookandfeeltool", {"--apply", themeId});
+    SystemFacts::gather(SystemFacts::KdeGlobals);
 
     emit themeApplied(themeId);
 }
@@ -88,9 +107,9 @@ void CoreInitial::reloadPlasmaByDBus()
 }
 
 bool CoreInitial::osreleaseStatus() {
-    QFile configFile("/usr/lib/os-release");
+    QSharedPointer<const SystemFacts> facts = SystemFacts::snapshot();
 
-    if (!configFile.open(QIODevice::ReadOnly | QIODevice::Text)) {
+    if (!facts->hasOsRelease()) {
         return false;
     }
 
@@ -110,34 +129,12 @@ bool CoreInitial::osreleaseStatus() {
     };
 
     // Get IMAGE_VERSION from tolitica.conf
-    QString homeDir = QDir::homePath();
-    QFile confFile(homeDir+"/tolitica-home-settings/tolitica.conf");
-    QString imageVersion;
-    if (confFile.open(QIODevice::ReadOnly | QIODevice::Text)) {
-        QTextStream confIn(&confFile);
-        while (!confIn.atEnd()) {
-            QString line = confIn.readLine();
-            if (line.startsWith("xrayos_img_ver = ")) {
-                imageVersion = line.split(" = ")[1];
-                break;
-            }
-        }
-    }
-    expected["IMAGE_VERSION"] = imageVersion;
+    expected["IMAGE_VERSION"] = facts->xrayImageVersion();
 
-    QTextStream in(&configFile);
     int matches = 0;
-
-    while (!in.atEnd()) {
-        QString line = in.readLine();
-        qDebug() << "Line:" << line;
-        QStringList parts = line.split('=', Qt::KeepEmptyParts);
-        if (parts.size() == 2) {
-            QString key = parts[0];
-            QString value = parts[1];
-            if (expected.contains(key) && expected[key] == value) {
-                matches++;
-            }
+    for (auto it = expected.cbegin(); it != expected.cend(); ++it) {
+        if (facts->osRelease().contains(it.key()) && facts->osReleaseValue(it.key()) == it.value()) {
+            matches++;
         }
     }
 
@@ -146,121 +143,73 @@ bool CoreInitial::osreleaseStatus() {
 }
 
 void CoreInitial::setOSrelease() {
+    const QString osRelease = "/usr/lib/os-release";
+    QList<QVariantMap> steps;
+
     if (osreleaseStatus()) {
         // Get version from tolitica.conf first
-        QString homeDir = QDir::homePath();
-        QFile confFile(homeDir + "/tolitica-home-settings/tolitica.conf");
-        QString imageVersion = "v25.07.18.01"; // default arch fallback
-
-        if (confFile.open(QIODevice::ReadOnly | QIODevice::Text)) {
-            QTextStream confIn(&confFile);
-            while (!confIn.atEnd()) {
-                QString line = confIn.readLine();
-                if (line.startsWith("arch_img_ver = ")) {
-                    imageVersion = line.split(" = ")[1];
-                    break;
-                }
-            }
+        QString imageVersion = SystemFacts::snapshot()->archImageVersion();
+        if (imageVersion.isEmpty()) {
+            imageVersion = "v25.07.18.01"; // default arch fallback
         }
 
         // Convert to ArchLinux
-        QStringList commands = {
-            "sudo sed -i 's/\"Xray_OS\"/\"Arch Linux\"/g' /usr/lib/os-release",
-            "sudo sed -i 's/ID=xray_os/ID=arch/g' /usr/lib/os-release",
-            "sudo sed -i 's|https://xray-os.github.io/xray_os-website/index.html|https://archlinux.org/|g' /usr/lib/os-release",
-            "sudo sed -i 's|https://xray-os.github.io/xray_os-website/get-started.html|https://wiki.archlinux.org/|g' /usr/lib/os-release",
-            "sudo sed -i 's|https://discord.com/invite/dBR7wR3ABk/|https://bbs.archlinux.org/|g' /usr/lib/os-release",
-            "sudo sed -i 's|https://github.com/Xray-OS/Xray_OS/issues|https://gitlab.archlinux.org/groups/archlinux/-/issues|g' /usr/lib/os-release",
-            "sudo sed -i 's|https://xray-os.github.io/xray_os-website/index.html#about-xray-os|https://terms.archlinux.org/docs/privacy-policy/|g' /usr/lib/os-release",
-            "sudo sed -i 's/xray-logo/archlinux-logo/g' /usr/lib/os-release",
-            "sudo sed -i 's/IMAGE_ID=xray_os/IMAGE_ID=archlinux/g' /usr/lib/os-release",
-            QString("sudo sed -i 's/^IMAGE_VERSION=.*/IMAGE_VERSION=%1/' /usr/lib/os-release").arg(imageVersion)
-        };
-
-        for (const QString &cmd : commands) {
-            QProcess::execute("pkexec", QStringList() << "bash" << "-c" << cmd);
-        }
+        steps << PrivilegedHelper::replaceTextStep(osRelease, "\"Xray_OS\"", "\"Arch Linux\"")
+              << PrivilegedHelper::replaceTextStep(osRelease, "ID=xray_os", "ID=arch")
+              << PrivilegedHelper::replaceTextStep(osRelease, "https://xray-os.github.io/xray_os-website/index.html", "https://archlinux.org/")
+              << PrivilegedHelper::replaceTextStep(osRelease, "https://xray-os.github.io/xray_os-website/get-started.html", "https://wiki.archlinux.org/")
+              << PrivilegedHelper::replaceTextStep(osRelease, "https://discord.com/invite/dBR7wR3ABk/", "https://bbs.archlinux.org/")
+              << PrivilegedHelper::replaceTextStep(osRelease, "https://github.com/Xray-OS/Xray_OS/issues", "https://gitlab.archlinux.org/groups/archlinux/-/issues")
+              << PrivilegedHelper::replaceTextStep(osRelease, "https://xray-os.github.io/xray_os-website/index.html#about-xray-os", "https://terms.archlinux.org/docs/privacy-policy/")
+              << PrivilegedHelper::replaceTextStep(osRelease, "xray-logo", "archlinux-logo")
+              << PrivilegedHelper::replaceTextStep(osRelease, "IMAGE_ID=xray_os", "IMAGE_ID=archlinux")
+              << PrivilegedHelper::setKeyStep(osRelease, "IMAGE_VERSION", imageVersion);
     } else {
-        QString homeDir = QDir::homePath();
-        QFile confFile(homeDir + "/tolitica-home-settings/tolitica.conf");
-        QString imageVersion = "v17"; // default xray fallback
-
-        if (confFile.open(QIODevice::ReadOnly | QIODevice::Text)) {
-            QTextStream confIn(&confFile);
-            while (!confIn.atEnd()) {
-                QString line = confIn.readLine();
-                if (line.startsWith("xrayos_img_ver = ")) {
-                    imageVersion = line.split(" = ")[1];
-                    break;
-                }
-            }
+        QString imageVersion = SystemFacts::snapshot()->xrayImageVersion();
+        if (imageVersion.isEmpty()) {
+            imageVersion = "v17"; // default xray fallback
         }
 
         // Force set to Xray_OS values regardless of current content
-        QStringList commands = {
-            "sudo sed -i 's/^NAME=.*/NAME=\"Xray_OS\"/' /usr/lib/os-release",
-            "sudo sed -i 's/^PRETTY_NAME=.*/PRETTY_NAME=\"Xray_OS\"/' /usr/lib/os-release",
-            "sudo sed -i 's/^ID=.*/ID=xray_os/' /usr/lib/os-release",
-            "sudo sed -i 's/^BUILD_ID=.*/BUILD_ID=rolling/' /usr/lib/os-release",
-            "sudo sed -i 's/^ANSI_COLOR=.*/ANSI_COLOR=\"38;2;23;147;209\"/' /usr/lib/os-release",
-            "sudo sed -i 's|^HOME_URL=.*|HOME_URL=\"https://xray-os.github.io/xray_os-website/index.html\"|' /usr/lib/os-release",
-            "sudo sed -i 's|^DOCUMENTATION_URL=.*|DOCUMENTATION_URL=\"https://xray-os.github.io/xray_os-website/get-started.html\"|' /usr/lib/os-release",
-            "sudo sed -i 's|^SUPPORT_URL=.*|SUPPORT_URL=\"https://discord.com/invite/dBR7wR3ABk/\"|' /usr/lib/os-release",
-            "sudo sed -i 's|^BUG_REPORT_URL=.*|BUG_REPORT_URL=\"https://github.com/Xray-OS/Xray_OS/issues\"|' /usr/lib/os-release",
-            "sudo sed -i 's|^PRIVACY_POLICY_URL=.*|PRIVACY_POLICY_URL=\"https://xray-os.github.io/xray_os-website/index.html#about-xray-os\"|' /usr/lib/os-release",
-            "sudo sed -i 's/^LOGO=.*/LOGO=xray-logo/' /usr/lib/os-release",
-            "sudo sed -i 's/^IMAGE_ID=.*/IMAGE_ID=xray_os/' /usr/lib/os-release",
-            QString("sudo sed -i 's/^IMAGE_VERSION=.*/IMAGE_VERSION=%1/' /usr/lib/os-release").arg(imageVersion)
-        };
-
-        for (const QString &cmd : commands) {
-            QProcess::execute("pkexec", QStringList() << "bash" << "-c" << cmd);
-        }
+        steps << PrivilegedHelper::setKeyStep(osRelease, "NAME", "\"Xray_OS\"")
+              << PrivilegedHelper::setKeyStep(osRelease, "PRETTY_NAME", "\"Xray_OS\"")
+              << PrivilegedHelper::setKeyStep(osRelease, "ID", "xray_os")
+              << PrivilegedHelper::setKeyStep(osRelease, "BUILD_ID", "rolling")
+              << PrivilegedHelper::setKeyStep(osRelease, "ANSI_COLOR", "\"38;2;23;147;209\"")
+              << PrivilegedHelper::setKeyStep(osRelease, "HOME_URL", "\"https://xray-os.github.io/xray_os-website/index.html\"")
+              << PrivilegedHelper::setKeyStep(osRelease, "DOCUMENTATION_URL", "\"https://xray-os.github.io/xray_os-website/get-started.html\"")
+              << PrivilegedHelper::setKeyStep(osRelease, "SUPPORT_URL", "\"https://discord.com/invite/dBR7wR3ABk/\"")
+              << PrivilegedHelper::setKeyStep(osRelease, "BUG_REPORT_URL", "\"https://github.com/Xray-OS/Xray_OS/issues\"")
+              << PrivilegedHelper::setKeyStep(osRelease, "PRIVACY_POLICY_URL", "\"https://xray-os.github.io/xray_os-website/index.html#about-xray-os\"")
+              << PrivilegedHelper::setKeyStep(osRelease, "LOGO", "xray-logo")
+              << PrivilegedHelper::setKeyStep(osRelease, "IMAGE_ID", "xray_os")
+              << PrivilegedHelper::setKeyStep(osRelease, "IMAGE_VERSION", imageVersion);
     }
-}
 
-bool CoreInitial::konsoleProfStatus() {
-    QString homeDir = QDir::homePath();
-    QFile configFile(homeDir + "/.config/konsolerc");
-
-    if(!configFile.open(QIODevice::ReadOnly | QIODevice::Text)) {
-        return false;
+    // One authorization and one root process for the whole rewrite
+    QString output;
+    if (!PrivilegedHelper::run("os-release", steps, &output)) {
+        qWarning() << "Failed to update os-release:" << output;
     }
 
-    QTextStream in(&configFile);
-    while (!in.atEnd()) {
-        QString line = in.readLine().trimmed();
-        if (line.startsWith("DefaultProfile=")) {
-            QString value = line.mid(15).trimmed();
-            value.remove('"');
-            if (value == "Xray_OS.profile") {
-                return true;
-            }
-        }
-    }
-    return false;
+    SystemFacts::gather(SystemFacts::OsRelease);
+}
+
+bool CoreInitial::konsoleProfStatus() {
+    return (SystemFacts::snapshot()->konsoleProfile() == "Xray_OS.profile");
 }
 
 void CoreInitial::setKonsoleProfile() {
     QString homeDir = QDir::homePath();
     QFile configFile(homeDir + "/.config/konsolerc");
 
-    if (!configFile.open(QIODevice::ReadOnly | QIODevice::Text)) {
+    if (!configFile.exists()) {
         return;
     }
 
     // Get current profile value first
-    QString currentProfile;
-    QTextStream in(&configFile);
-    while (!in.atEnd()) {
-        QString line = in.readLine();
-        if (line.startsWith("DefaultProfile=")) {
-            currentProfile = line.mid(15).trimmed();
-            currentProfile.remove('"');
-            break;
-        }
-    }
-    configFile.close();
+    QSharedPointer<const SystemFacts> facts = SystemFacts::snapshot();
+    QString currentProfile = facts->konsoleProfile();
 
     // Save current profile to tolitica.conf if it's not Xray_OS.profile
     if (currentProfile != "Xray_OS.profile") {
@@ -301,7 +250,7 @@ void CoreInitial::setKonsoleProfile() {
     }
 
     QStringList lines;
-    in.setDevice(&configFile);
+    QTextStream in(&configFile);
     bool foundDefaultProfile = false;
 
     while (!in.atEnd()) {
@@ -309,17 +258,9 @@ void CoreInitial::setKonsoleProfile() {
         if (line.startsWith("DefaultProfile=")) {
             if (currentProfile == "Xray_OS.profile") {
                 // Get saved profile from tolitica.conf
-                QString savedProfile = "Arch.profile"; // default fallback
-                QFile toliticaConf(homeDir + "/tolitica-home-settings/tolitica.conf");
-                if (toliticaConf.open(QIODevice::ReadOnly | QIODevice::Text)) {
-                    QTextStream tIn(&toliticaConf);
-                    while (!tIn.atEnd()) {
-                        QString tLine = tIn.readLine();
-                        if (tLine.startsWith("lastKonsoleProfile=")) {
-                            savedProfile = tLine.mid(19).trimmed();
-                            break;
-                        }
-                    }
+                QString savedProfile = facts->lastKonsoleProfile();
+                if (savedProfile.isEmpty()) {
+                    savedProfile = "Arch.profile"; // default fallback
                 }
                 lines << "DefaultProfile=" + savedProfile;
             } else {
@@ -342,29 +283,14 @@ void CoreInitial::setKonsoleProfile() {
         for (const QString &line : lines) {
             out << line << "\n";
         }
+        configFile.close();
     }
+
+    SystemFacts::gather(SystemFacts::Konsole | SystemFacts::ToliticaConf);
 }
 
 bool CoreInitial::grubThemeStatus() {
-    QFile configFile("/etc/default/grub");
-
-    if(!configFile.open(QIODevice::ReadOnly | QIODevice::Text)) {
-        return false;
-    }
-
-    QTextStream in(&configFile);
-
-    while (!in.atEnd()) {
-        QString line = in.readLine().trimmed();
-        if (line.startsWith("GRUB_THEME=")) {
-            QString value = line.mid(11).trimmed();
-            value.remove('"');
-            if (value == "/boot/grub/themes/xray_os/theme.txt") {
-                return true;
-            }
-        }
-    }
-    return false;
+    return (SystemFacts::snapshot()->grubTheme() == "/boot/grub/themes/xray_os/theme.txt");
 }
 
 void CoreInitial::setGrubTheme() {
@@ -378,6 +304,7 @@ void CoreInitial::setGrubTheme() {
     QProcess process;
     process.start("pkexec", QStringList() << "bash" << "-c" << command);
     process.waitForFinished();
+    SystemFacts::gather(SystemFacts::Grub);
 
     // Debug output
     qDebug() << "Command:" << command;
@@ -394,41 +321,15 @@ void CoreInitial::setGrubTheme() {
 }
 
 QString CoreInitial::currentIcons() {
-    QString homeDir = QDir::homePath();
-    QFile configFile(homeDir + "/.config/kdeglobals");
+    QString themeValue = SystemFacts::snapshot()->iconTheme();
 
-    if (!configFile.open(QIODevice::ReadOnly | QIODevice::Text)) {
+    if (themeValue == "Dracula") {
+        return "Dracula";
+    } else if (themeValue == "Surfn-Tela") {
+        return "Surfn-Tela";
+    } else {
         return "breeze-dark";
     }
-
-    QTextStream in(&configFile);
-    bool inIconsSection = false;
-
-    while (!in.atEnd()) {
-        QString line = in.readLine().trimmed();
-
-        if (line.isEmpty() || line.startsWith('#') || line.startsWith(';')) {
-            continue;
-        }
-
-        if (line.startsWith('[') && line.endsWith(']')) {
-            inIconsSection = (line == "[Icons]");
-            continue;
-        }
-
-        if (inIconsSection && line.startsWith("Theme=")) {
-            QString themeValue = line.mid(6).trimmed();
-            themeValue.remove('"');
-            if (themeValue == "Dracula") {
-                return "Dracula";
-            } else if (themeValue == "Surfn-Tela") {
-                return "Surfn-Tela";
-            } else {
-                return "breeze-dark";
-            }
-        }
-    }
-    return "breeze-dark";
 }
 
 void CoreInitial::setIcons(const QString &icons) {
@@ -471,7 +372,9 @@ void CoreInitial::setIcons(const QString &icons) {
         for (const QString &line : lines) {
             out << line << "\n";
         }
+        configFile.close();
     }
+    SystemFacts::gather(SystemFacts::KdeGlobals);
 
     // Reload plasma to apply icon changes
     QProcess::execute("kquitapp6", QStringList() << "plasmashell");
@@ -479,27 +382,16 @@ void CoreInitial::setIcons(const QString &icons) {
 }
 
 bool CoreInitial::aurStatus(const QString &aur) {
-    QProcess process;
-    QString command = QString("pacman -Q %1").arg(aur);
-    qDebug() << "command: " << command;
-
-    process.start("bash", QStringList() << "-c" << command);
-    qDebug() << "process: " << process.exitCode();
-    process.waitForFinished();
-
-    bool aurEnabled = (process.exitCode() == 0);
-
-    // qDebug() << ("%1 installed?: ").arg(aur) << yay;
-    return aurEnabled ? true : false;
+    return PackageDatabase::instance().isInstalled(aur);
 }
 
 void CoreInitial::getRemoveAUR(QWidget *parent, const QString &aurHelper, std::function<void(bool)> callback) {
     bool status = aurStatus(aurHelper);
     qDebug() << "getRemoveAUR-status: " << status;
 
-    QString command = QString((status) ? "pacman -Rns --noconfirm %1" :
-        "pacman -S --noconfirm %1").arg(aurHelper);
-    qDebug() << "getRemoveAUR-command: " << command;
+    QString arguments = QString((status) ? "-Rns --noconfirm %1" :
+        "-S --noconfirm %1").arg(aurHelper);
+    qDebug() << "getRemoveAUR-arguments: " << arguments;
 
     // Verify if there is online connection
     QString offlinePath = QDir::homePath() +
@@ -524,80 +416,38 @@ void CoreInitial::getRemoveAUR(QWidget *parent, const QString &aurHelper, std::f
     progress->setValue(0);
     progress->show();
 
-    QTimer *monitorTimer = new QTimer(parent);
-    int progressValue = 0;
-
     ConnectivityChecker *internetChecker = new ConnectivityChecker(this);
     connect(internetChecker, &ConnectivityChecker::connectivityChecked,
-    this, [internetChecker, command, offlinePath, status, callback,
-    progress, monitorTimer, progressValue, parent]
+    this, [internetChecker, arguments, offlinePath, status, callback, progress]
         (bool isConnected) {
             qDebug() << "OUTPUT: isConnected =" << isConnected;
-            QString cmdToRun;
+            QString argumentsToRun;
             if (!isConnected && !status) {
-                cmdToRun = QString("sudo pacman -U --noconfirm %1/*.zst").arg(offlinePath);
+                argumentsToRun = QString("-U --noconfirm %1/*.zst").arg(offlinePath);
             } else {
-                cmdToRun = command;
+                argumentsToRun = arguments;
             }
-            qDebug() << "CMD_TO_RUN: " << cmdToRun;
-
-        connect(monitorTimer, &QTimer::timeout, parent, [=]() mutable {
-            if (progressValue < 95) {
-                progressValue += 2;
-                progress->setValue(progressValue);
-            }
-        });
-        monitorTimer->start(250);
-
-        QProcess *process = new QProcess();
-        int attempts = 0;
-        do {
-            process->start("pkexec", QStringList() << "bash" << "-c" << cmdToRun);
-            process->waitForFinished();
 
-            if (process->exitCode() != 0 && attempts < 2) {
-                attempts++;
-            }
-        } while (process->exitCode() != 0 && attempts < 3);
-
-        qDebug() << "PROCESS-OUTPUT: " << process->exitCode();
-
-        monitorTimer->stop();
-        progress->setValue(100);
-
-        bool success = (process->exitCode() == 0);
-        process->deleteLater();
-        progress->deleteLater();
-        monitorTimer->deleteLater();
-
-        if (callback) callback(success);
-        if (success)
+        runPackageCommand(progress, argumentsToRun, QString(), [internetChecker, callback](bool success) {
             internetChecker->deleteLater();
+            if (callback) callback(success);
+        });
     });
     // kick off the check
     internetChecker->checkConnectivity();
 }
 
 bool CoreInitial::storeStatus(const QString &store) {
-    QProcess process;
-    QString command = QString("pacman -Q %1").arg(store);
-    qDebug() << "command: " << command;
-
-    process.start("bash", QStringList() << "-c" << command);
-    qDebug() << "process: " << process.exitCode();
-    process.waitForFinished();
-
-    bool storeEnabled = (process.exitCode() == 0);
-    return storeEnabled ? true : false;
+    return PackageDatabase::instance().isInstalled(store);
 }
 
 void::CoreInitial::getRemoveStore(QWidget *parent, const QString &store, std::function<void(bool)> callback) {
     bool status = storeStatus(store);
     qDebug() << "getRemoveStore-status: " << status;
 
-    QString command = QString((status) ? "pacman -Rns --noconfirm %1" :
-        "pacman -S --noconfirm %1").arg(store);
-    qDebug() << "getRemoveStore-command: " << command;
+    QString arguments = QString((status) ? "-Rns --noconfirm %1" :
+        "-S --noconfirm %1").arg(store);
+    qDebug() << "getRemoveStore-arguments: " << arguments;
 
     // Verify if there is online connection
     QString offlinePath = QDir::homePath() +
@@ -622,76 +472,37 @@ void::CoreInitial::getRemoveStore(QWidget *parent, const QString &store, std::fu
     progress->setValue(0);
     progress->show();
 
-    QTimer *monitorTimer = new QTimer(parent);
-    int progressValue = 0;
-
     ConnectivityChecker *internetChecker = new ConnectivityChecker(this);
     connect(internetChecker, &ConnectivityChecker::connectivityChecked,
-        this, [internetChecker, command, offlinePath, status, callback,
-        progress, monitorTimer, progressValue, parent]
-    (bool isConnected) mutable {
+        this, [internetChecker, arguments, offlinePath, status, callback, progress]
+    (bool isConnected) {
         qDebug() << "OUTPUT: is connected = " << isConnected;
-        QString cmdToRun;
+        QString argumentsToRun;
         if (!isConnected && !status) {
-            cmdToRun = QString("sudo pacman -U --noconfirm %1/*.zst").arg(offlinePath);
+            argumentsToRun = QString("-U --noconfirm %1/*.zst").arg(offlinePath);
         } else {
-            cmdToRun = command;
+            argumentsToRun = arguments;
         }
-        qDebug() << "CMD_TO_RUN: " << cmdToRun;
-
-        connect(monitorTimer, &QTimer::timeout, parent, [=]() mutable {
-            if (progressValue < 95) {
-                progressValue += 2;
-                progress->setValue(progressValue);
-            }
-        });
-        monitorTimer->start(250);
 
-        QProcess *process = new QProcess();
-        int attempts = 0;
-        do {
-            process->start("pkexec", QStringList() << "bash" << "-c" << cmdToRun);
-            process->waitForFinished();
-
-            if (process->exitCode() != 0 && attempts < 2) {
-                attempts++;
-            }
-        } while (process->exitCode() != 0 && attempts < 3);
-
-        qDebug() << "PROCESS-OUTPUT: " << process->exitCode();
-
-        monitorTimer->stop();
-        progress->setValue(100);
-
-        bool success = (process->exitCode() == 0);
-        process->deleteLater();
-        progress->deleteLater();
-        monitorTimer->deleteLater();
-
-        if (callback) callback(success);
-        if (success)
+        runPackageCommand(progress, argumentsToRun, QString(), [internetChecker, callback](bool success) {
             internetChecker->deleteLater();
+            if (callback) callback(success);
+        });
     });
     // Kick off the check
     internetChecker->checkConnectivity();
 }
 
 bool CoreInitial::gamingMetaStatus() {
-    QProcess process;
-    process.start("bash", QStringList() << "-c" << "pacman -Q arch7z-gaming-meta");
-    process.waitForFinished();
-
-    bool gamingEnabled = (process.exitCode() == 0);
-
-    return gamingEnabled ? true : false;
+    return PackageDatabase::instance().isInstalled("arch7z-gaming-meta");
 }
 
 void CoreInitial::getArch7zGamingMeta(QWidget *parent,
     std::function<void(bool)>callback) {
         bool status = gamingMetaStatus();
 
-        QString command = (status) ? "pacman -Rns --noconfirm arch7z-gaming-meta"
-            : "pacman -S --noconfirm arch7z-gaming-meta";
+        QString arguments = (status) ? "-Rns --noconfirm arch7z-gaming-meta"
+            : "-S --noconfirm arch7z-gaming-meta";
 
         QProgressDialog *progress = new QProgressDialog(
             (status) ? "Removing Arch7z Gaming Meta..."
@@ -701,63 +512,23 @@ void CoreInitial::getArch7zGamingMeta(QWidget *parent,
         progress->setValue(0);
         progress->show();
 
-        QTimer *monitorTimer = new QTimer(parent);
-        int progressValue = 0;
-
         ConnectivityChecker *internetChecker = new ConnectivityChecker(this);
         connect(internetChecker, &ConnectivityChecker::connectivityChecked,
-            this, [internetChecker, command, status, callback, progress,
-            monitorTimer, progressValue, parent](bool isConnected)
-            mutable {
+            this, [internetChecker, arguments, callback, progress, parent](bool isConnected) {
                 qDebug() << "OUTPUT: is connected = " << isConnected;
                 if (!isConnected) {
+                    progress->deleteLater();
                     QMessageBox::warning(parent, "Failed to start installation",
                         "Your system is not connected to internet, check connection first");
                     return;
                 }
 
-                connect(monitorTimer, &QTimer::timeout, parent, [=]() mutable {
-                    if (progressValue < 95) {
-                        progressValue += 2;
-                        progress->setValue(progressValue);
-                    }
-                });
-                monitorTimer->start(250);
-
-                QProcess *process = new QProcess();
-                int attempts = 0;
-                do {
-                    process->start("pkexec", QStringList() << "bash" << "-c" << command);
-                    process->waitForFinished();
-
-                    if (process->exitCode() != 0) {
-                        QProcess cleanProcess;
-                        cleanProcess.start("pkexec", QStringList() << "bash" << "-c" <<
-                            "pacman -Scc --noconfirm");
-                        cleanProcess.waitForFinished();
-
-                        cleanProcess.start("pkexec", QStringList() << "bash" << "-c" <<
-                            "pacman -Sy");
-                        cleanProcess.waitForFinished();
-
-                        attempts++;
-                    }
-                } while (process->exitCode() != 0 && attempts < 3);
-                qDebug() << "PROCESS-OUTPUT: " << process->exitCode();
-
-                monitorTimer->stop();
-                progress->setValue(100);
-
-                bool success = (process->exitCode() == 0);
-                process->kill();
-                process->waitForFinished(3000);
-                process->deleteLater();
-                progress->deleteLater();
-                monitorTimer->deleteLater();
-
-                if (callback) callback(success);
-                if (success)
+                // A failed run gets a clean cache and fresh databases before the retry
+                runPackageCommand(progress, arguments, "pacman -Scc --noconfirm && pacman -Sy && ",
+                                  [internetChecker, callback](bool success) {
                     internetChecker->deleteLater();
+                    if (callback) callback(success);
+                });
             });
         internetChecker->checkConnectivity();
     }
@@ -0,0 +1,409 @@
+#include "core_services.h"
+#include "package_database.h"
+#include "privileged_helper.h"
+
+#include <QProcess>
+#include <QMessageBox>
+#include <QDir>
+#include <QDebug>
+#include <QProgressDialog>
+#include <QCoreApplication>
+#include <QFile>
+#include <QTextStream>
+
+CoreServices::CoreServices(QWidget *parentWidget)
+    : QObject(parentWidget)
+    , m_parentWidget(parentWidget)
+{}
+
+///////////////////////////////////////////////////
+/// PACMAN:: CLEAN CACHE
+//////////////////////////////////////////////////
+void CoreServices::cleanCache() {
+    QProcess checkIssues;
+    checkIssues.start("bash", QStringList() << "-c" << "pacman -Sy --dbonly");
+    checkIssues.waitForFinished();
+    QString dbSyncErrors = checkIssues.readAllStandardError();
+
+    bool dbNotSynced = !dbSyncErrors.isEmpty();
+
+    QDir pkgCacheDir("/var/cache/pacman/pkg");
+    bool cacheExists = pkgCacheDir.exists() && !pkgCacheDir.isEmpty();
+
+    if (cacheExists) {
+        // Check for PKG corruption
+        checkIssues.start("bash", QStringList() << "-c" << "pacman -Qk");
+        checkIssues.waitForFinished();
+
+        if (dbNotSynced || cacheExists ) {
+            qDebug() << "Issues detected! Cleaning package cache.";
+            QProcess cleanup;
+
+            if (dbNotSynced) {
+                cleanup.start("pkexec", QStringList() << "bash" << "-c" << "pacman -Sy");
+                cleanup.waitForFinished();
+
+                if (cleanup.exitCode() != 0) {
+                    qDebug() << "Cleanup errors(pacman -Sy): " << cleanup.readAllStandardError();
+                }
+            }
+        if (dbNotSynced) {
+            cleanup.start("pkexec", QStringList() << "bash" << "-c" << "sudo rm -rf /var/cache/pacman/pkg/* && sudo pacman -Scc --noconfirm");
+            cleanup.waitForFinished();
+        }
+
+            qDebug() << "Cleanup output:" << cleanup.readAllStandardOutput();
+            qDebug() << "Cleanup erros:" << cleanup.readAllStandardError();
+
+        } else {
+            qDebug() << "System database and package cache are fine!";
+        }
+    }
+}
+
+///////////////////////////////////////////////////
+/// ADDONS::HELPER: Run a shell command
+//////////////////////////////////////////////////
+bool CoreServices::runCommand(const QString &cmd) {
+    QProcess process;
+    process.start("bash", QStringList() << "-c" << cmd);
+    process.waitForFinished();
+    return (process.exitCode() == 0);
+}
+
+///////////////////////////////////////////////////
+/// ADDONS:: CHECK CHAOTIC-AUR STATUS
+//////////////////////////////////////////////////
+int CoreServices::checkChaoticAURStatus() {
+    // Check if key is imported
+    bool keyExist = runCommand("pacman-key --list-keys 3056513887B78AEB");
+    // Check if required packages are installed
+    bool packagesInstalled = PackageDatabase::instance().allInstalled({"chaotic-keyring", "chaotic-mirrorlist"});
+    // Check if repository header exists in pacman.conf
+    bool repoHeaderExists = runCommand("grep -q '\\[chaotic-aur\\]' /etc/pacman.conf");
+
+    // Check if Include line exists in pacman.conf
+    bool includeLineExists = runCommand("grep -q 'Include = /etc/pacman.d/chaotic-mirrorlist' /etc/pacman.conf");
+
+    if (keyExist && packagesInstalled && repoHeaderExists && includeLineExists)
+        return 0; // Fully configured
+    else if (!keyExist && !packagesInstalled && !repoHeaderExists && !includeLineExists)
+        return 1; // Not set up
+    else
+        return 2; // Partial setup (repair needed)
+}
+
+///////////////////////////////////////////////////
+/// ADDONS:: BACKUP PACMAN CONFIG FUNCTION
+//////////////////////////////////////////////////
+QList<QVariantMap> CoreServices::backupPacmanConfigSteps() {
+    // Always backup before modifications, unless the backup is already current
+    const QString backupDir = "/etc/xray/tolitica/tolitica-settings/backups";
+    QList<QVariantMap> steps;
+    steps << PrivilegedHelper::makeDirStep(backupDir);
+
+    QFile current("/etc/pacman.conf");
+    QFile backup(backupDir + "/pacman.conf");
+    bool upToDate = current.open(QIODevice::ReadOnly) && backup.open(QIODevice::ReadOnly) &&
+                    current.readAll() == backup.readAll();
+    if (!upToDate) {
+        steps << PrivilegedHelper::copyStep("/etc/pacman.conf", backupDir + "/pacman.conf");
+    }
+    return steps;
+}
+
+///////////////////////////////////////////////////
+/// ADDONS:: CHAOTIC-AUR PACMAN.CONF EDITS
+//////////////////////////////////////////////////
+namespace {
+const char *const kChaoticKey = "3056513887B78AEB";
+const char *const kChaoticKeyring = "https://cdn-mirror.chaotic.cx/chaotic-aur/chaotic-keyring.pkg.tar.zst";
+const char *const kChaoticMirrorlist = "https://cdn-mirror.chaotic.cx/chaotic-aur/chaotic-mirrorlist.pkg.tar.zst";
+
+QByteArray readPacmanConf() {
+    QFile configFile("/etc/pacman.conf");
+    if (!configFile.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        return QByteArray();
+    }
+    return configFile.readAll();
+}
+
+// Same as sed '/\[chaotic-aur\]/,+1d': drop the header and the line after it
+QByteArray withoutChaoticRepo(const QByteArray &content) {
+    QList<QByteArray> lines = content.split('\n');
+    for (int i = 0; i < lines.size(); ++i) {
+        if (lines.at(i).contains("[chaotic-aur]")) {
+            lines.removeAt(i);
+            if (i < lines.size()) {
+                lines.removeAt(i);
+            }
+            --i;
+        }
+    }
+    return lines.join('\n');
+}
+
+QByteArray withChaoticRepo(QByteArray content) {
+    if (!content.contains("[chaotic-aur]")) {
+        content.append("\n[chaotic-aur]\nInclude = /etc/pacman.d/chaotic-mirrorlist\n");
+    }
+    return content;
+}
+
+// Key import and keyring/mirrorlist packages, shared by install and repair
+QList<QVariantMap> chaoticSetupSteps() {
+    return QList<QVariantMap>()
+        << PrivilegedHelper::runStep("pacman-key", QStringList() << "--recv-key" << kChaoticKey
+                                                                 << "--keyserver" << "keyserver.ubuntu.com")
+        << PrivilegedHelper::runStep("pacman-key", QStringList() << "--lsign-key" << kChaoticKey)
+        << PrivilegedHelper::runStep("pacman", QStringList() << "-U" << kChaoticKeyring << "--noconfirm")
+        << PrivilegedHelper::runStep("pacman", QStringList() << "-U" << kChaoticMirrorlist << "--noconfirm");
+}
+}
+
+///////////////////////////////////////////////////
+/// ADDONS:: REMOVE-CHAOTIC-AUR
+//////////////////////////////////////////////////
+void CoreServices::removeChaoticAUR() {
+    QList<QVariantMap> steps;
+    steps << PrivilegedHelper::writeStep("/etc/pacman.conf", withoutChaoticRepo(readPacmanConf()))
+          << PrivilegedHelper::runStep("pacman", QStringList() << "-Rns" << "chaotic-keyring"
+                                                               << "chaotic-mirrorlist" << "--noconfirm")
+          << PrivilegedHelper::runStep("pacman-key", QStringList() << "--delete" << kChaoticKey);
+
+    // Optionally delete an outdated backup file if it exists
+    if (QFile::exists("/etc/xray/tolitica/tolitica-settings/backups/pacman.conf")) {
+        steps << PrivilegedHelper::removeStep("/etc/xray/tolitica/tolitica-settings/backups/pacman.conf");
+    }
+
+    QString errorOutput;
+    if (PrivilegedHelper::run("packages", steps, &errorOutput)) {
+        QMessageBox::information(m_parentWidget, "Chaotic AUR Removed",
+                                 "Chaotic AUR repositories have been removed successfully");
+    } else {
+        QMessageBox::warning(m_parentWidget, "Error", "Something went wrong removing Chaotic AUR repositories:\n" + errorOutput);
+    }
+    PackageDatabase::instance().reload();
+}
+
+///////////////////////////////////////////////////
+/// ADDONS:: CHAOTIC-AUR
+//////////////////////////////////////////////////
+void CoreServices::chaoticAUR() {
+    // Create progress dialog
+    QProgressDialog *progress = new QProgressDialog("Processing Chaotic AUR...", nullptr, 0, 100, m_parentWidget);
+    progress->setWindowModality(Qt::ApplicationModal);
+    progress->setCancelButton(nullptr);
+    progress->setValue(0);
+    progress->show();
+    QCoreApplication::processEvents();
+
+    int status = checkChaoticAURStatus();
+    progress->setValue(10);
+    QCoreApplication::processEvents();
+
+    // When fully configured, that is, repository is active, removal is the desired action.
+    if (status == 0) {
+        progress->setLabelText("Removing Chaotic AUR...");
+        progress->setValue(50);
+        QCoreApplication::processEvents();
+        removeChaoticAUR();
+        progress->setValue(100);
+        progress->deleteLater();
+        return;
+    }
+
+    // The user-owned working copy is what a later repair restores from.
+    QString workingDir = QDir::homePath() + "/tolitica-home-settings/backups/current-use";
+    QString configPath = workingDir + "/pacman.conf";
+    if (!QDir().mkpath(workingDir)) {
+        qDebug() << "Failed to create backup directory:" << workingDir;
+    }
+
+    // For initial installation, modify pacman.conf via C++.
+    if (status == 1) {
+        QByteArray content = withChaoticRepo(readPacmanConf());
+
+        QFile configFile(configPath);
+        if (!configFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            progress->deleteLater();
+            QMessageBox::warning(m_parentWidget, "Error", "Failed to open working copy for writing.");
+            return;
+        }
+        configFile.write(content);
+        configFile.close();
+
+        // Backup, keys, packages and the new pacman.conf in one privileged batch
+        progress->setLabelText("Installing packages and keys...");
+        progress->setValue(40);
+        QCoreApplication::processEvents();
+
+        QList<QVariantMap> steps = backupPacmanConfigSteps();
+        steps << chaoticSetupSteps()
+              << PrivilegedHelper::writeStep("/etc/pacman.conf", content);
+
+        QString output;
+        bool success = PrivilegedHelper::run("packages", steps, &output);
+        qDebug() << "chaoticAUR setup OUTPUT:" << output;
+
+        progress->setValue(100);
+        progress->deleteLater();
+        PackageDatabase::instance().reload();
+
+        if (success) {
+            QMessageBox::information(m_parentWidget, "Chaotic AUR Added",
+                                     "Chaotic AUR repositories have been successfully set up in Xray_OS");
+        } else {
+            QMessageBox::warning(m_parentWidget, "Error", "Error adding Chaotic AUR:\n" + output);
+        }
+
+        return;
+    }
+
+    // For a partial/failed setup, attempt to repair.
+    else if (status == 2) {
+        QList<QVariantMap> steps = backupPacmanConfigSteps();
+
+        // If the local chaotic-mirrorlist does not exist, clean any broken
+        // entries first, or pacman refuses to run at all.
+        if (!QFile::exists("/etc/pacman.d/chaotic-mirrorlist")) {
+            steps << PrivilegedHelper::writeStep("/etc/pacman.conf", withoutChaoticRepo(readPacmanConf()));
+        }
+
+        // Reinstall packages and re-import the key.
+        steps << chaoticSetupSteps();
+
+        // Restore the pacman.conf from your backup store.
+        QFile workingCopy(configPath);
+        QByteArray restored = workingCopy.open(QIODevice::ReadOnly) ? workingCopy.readAll()
+                                                                    : withChaoticRepo(readPacmanConf());
+        steps << PrivilegedHelper::writeStep("/etc/pacman.conf", restored);
+
+        progress->setLabelText("Repairing Chaotic AUR...");
+        progress->setValue(50);
+        QCoreApplication::processEvents();
+
+        QString output;
+        bool success = PrivilegedHelper::run("packages", steps, &output);
+        qDebug() << "chaoticAUR repair OUTPUT:" << output;
+
+        progress->setValue(100);
+        progress->deleteLater();
+        PackageDatabase::instance().reload();
+
+        if (success) {
+            QMessageBox::information(m_parentWidget, "Restore Complete", "Chaotic AUR has been repaired!");
+        } else {
+            QMessageBox::warning(m_parentWidget, "Error", "Something went wrong repairing Chaotic AUR:\n" + output);
+        }
+    }
+}
+
+///////////////////////////////////////////////////
+/// TERMINAL: CHECK TERMINAL-THEMING STATUS
+//////////////////////////////////////////////////
+int CoreServices::checkTermThemingStatus(){
+    QString termConfigFile = QDir::homePath() + "/.config/fish/config.fish";
+    QFile configFile(termConfigFile);
+
+    if (!configFile.exists()) {
+        return 0; // File not found
+    }
+    if (!configFile.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        return 0; // Treat as not found due to error
+    }
+
+    QString targetLine = "oh-my-posh init fish --config $HOME/.config/oh-my-posh-themes/arch-atomic.omp.json";
+    QTextStream in(&configFile);
+
+    while (!in.atEnd()) {
+        QString line = in.readLine();
+        if (line.contains(targetLine)) {
+            configFile.close();
+            return line.startsWith("#") ? 2 : 1; // 2 if commented, 1 if uncommented
+        }
+    }
+
+    configFile.close();
+    return 0; // Line not found
+}
+
+////////////////////////////////////////////////////////
+/// TERMINAL: DISABLE/ENABLE TERMINAL THEMING FUNCTION
+//////////////////////////////////////////////////////
+void CoreServices::disableTermTheme(QPushButton *terminalThemeButton) {
+    QString termConfigFile = QDir::homePath() + "/.config/fish/config.fish";
+    QFile configFile(termConfigFile);
+
+    int status = checkTermThemingStatus(); // Get the current line status
+
+    // Handle the case were the file or target line is missing
+    if (status == 0) {
+        terminalThemeButton->setText("No config.fish found");
+        QMessageBox::warning(m_parentWidget, "No Oh-My-Posh theme Found!",
+                                    "No current config.fish file was found in '$HOME/.config/fish'");
+        return;
+    }
+
+    // If there is no actual arch-atomic.omp.json file
+    if (!QFile::exists(QDir::homePath() + "/.config/oh-my-posh-themes/arch-atomic.omp.json")) {
+        QMessageBox::warning(m_parentWidget, "arch-atomic.omp.json is Missing!",
+                                   "arch-atomic.omp.json is missing from /.config/oh-my-posh-themes");
+        return;
+    }
+
+    // Confirm action with the user
+    QMessageBox msgBox;
+    msgBox.setWindowTitle("Terminal Theming");
+    msgBox.setIcon(QMessageBox::Information);
+
+    if (status == 1) {
+        msgBox.setText("Terminal theming is currently enabled.\nWould you like to disable it?");
+    } else if (status == 2) {
+        msgBox.setText("Terminal theming is currently disabled\nWould you like to enable it?");
+    }
+
+    msgBox.setStandardButtons(QMessageBox::Yes | QMessageBox::No);
+    int userChoice = msgBox.exec();
+
+    if (userChoice != QMessageBox::Yes) {
+        return; // User canceled the action
+    }
+
+    // Attempt to open the file for reading
+    if (!configFile.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        QMessageBox::critical(m_parentWidget, "Error", "Failed to read configuration file.");
+        return;
+    }
+
+    QStringList lines;
+    QString targetLine = "oh-my-posh init fish --config $HOME/.config/oh-my-posh-themes/arch-atomic.omp.json";
+
+    QTextStream in(&configFile);
+    while (!in.atEnd()) {
+        QString line = in.readLine();
+
+        if (line.contains(targetLine)) {
+            line = (status == 1) ? "#" + line : line.mid(1); // Comment or uncomment
+        }
+
+        lines.append(line);
+    }
+    configFile.close();
+
+    // Attempt to open the file for writing
+    if (!configFile.open(QIODevice::WriteOnly | QIODevice::Text | QIODevice::Truncate)) {
+        QMessageBox::critical(m_parentWidget, "Error", "Failed to modify configuration file.");
+        return;
+    }
+
+    QTextStream out(&configFile);
+    for (const QString &line : lines) {
+        out << line << "\n";
+    }
+    configFile.close();
+
+    // Update the button text after successful modification
+    terminalThemeButton->setText(status == 1 ? "Enable Terminal Theming (Fish ONLY)" : "Disable Terminal Theming (Fish ONLY)");
+    QMessageBox::information(m_parentWidget, "Success", "Terminal theming successfully updated");
+}
@@ -0,0 +1,39 @@
+#ifndef CORE_SERVICES_H
+#define CORE_SERVICES_H
+
+#include <QObject>
+#include <QString>
+#include <QWidget>
+#include <QPushButton>
+#include <QList>
+#include <QVariantMap>
+
+// Package and terminal helpers shared by the main assistant (Widget) and the
+// first-run wizard (Widget_Initial), so the wizard doesn't need a Widget.
+// Dialogs opened by the helpers are parented to the widget passed in.
+class CoreServices : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit CoreServices(QWidget *parentWidget);
+
+    // PACMAN
+    static void cleanCache();
+    static bool runCommand(const QString &cmd);
+
+    // CHAOTIC-AUR
+    static int checkChaoticAURStatus();
+    static QList<QVariantMap> backupPacmanConfigSteps();
+    void removeChaoticAUR();
+    void chaoticAUR();
+
+    // TERMINAL
+    static int checkTermThemingStatus();
+    void disableTermTheme(QPushButton *terminalThemeButton);
+
+private:
+    QWidget *m_parentWidget;
+};
+
+#endif // CORE_SERVICES_H
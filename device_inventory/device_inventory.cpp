@@ -0,0 +1,408 @@
+#include "device_inventory.h"
+#include "mount_info.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QProcess>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QDebug>
+#include <algorithm>
+#include <cstdlib>
+#include <utility>
+
+#include <blkid/blkid.h>
+
+namespace {
+const char *const kSysBlock = "/sys/class/block";
+const char *const kUdevData = "/run/udev/data/b";
+
+// What udev's database says about one device, as of its modification time
+struct UdevEntry {
+    QDateTime modified;
+    qint64 size = 0;
+    QString fsType;
+    QString uuid;
+    QString label;
+    QString partitionType;
+};
+
+QMutex s_udevMutex;
+QHash<QString, UdevEntry> s_udevCache;   // major:minor -> entry
+
+// One blkid cache for the process; libblkid isn't thread safe.
+QMutex s_blkidMutex;
+blkid_cache s_blkidCache = nullptr;
+
+blkid_cache blkidCache() {
+    if (!s_blkidCache && blkid_get_cache(&s_blkidCache, nullptr) < 0) {
+        s_blkidCache = nullptr;
+    }
+    return s_blkidCache;
+}
+
+QString readSysfs(const QString &path) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return QString();
+    }
+    return QString::fromLatin1(file.readAll()).trimmed();
+}
+
+// A partition sits in its disk's directory, and only the disk has a queue
+QString queuePath(const QString &sysPath) {
+    return QFileInfo::exists(sysPath + "/partition") ? QFileInfo(sysPath).absolutePath() : sysPath;
+}
+
+// 1 for a spinning disk, 0 for one that isn't, -1 when sysfs doesn't say
+int readRotational(const QString &queuePath) {
+    const QString value = readSysfs(queuePath + "/queue/rotational");
+    return value.isEmpty() ? -1 : value == "1" ? 1 : 0;
+}
+
+// ----------------------------------------------------------------------------------------------
+// udev rewrites a device's entry (into a new file) whenever it processes an
+// event for it, so an unchanged modification time and size mean the cached
+// parse still holds.
+// ----------------------------------------------------------------------------------------------
+bool readUdev(const QString &majorMinor, UdevEntry *entry) {
+    const QFileInfo info(kUdevData + majorMinor);
+    if (!info.exists()) {
+        return false;
+    }
+    {
+        QMutexLocker locker(&s_udevMutex);
+        const auto cached = s_udevCache.constFind(majorMinor);
+        if (cached != s_udevCache.cend() && cached->modified == info.lastModified()
+            && cached->size == info.size()) {
+            *entry = *cached;
+            return true;
+        }
+    }
+
+    QFile file(info.filePath());
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        return false;
+    }
+    UdevEntry parsed;
+    parsed.modified = info.lastModified();
+    parsed.size = info.size();
+    while (!file.atEnd()) {
+        const QString line = QString::fromUtf8(file.readLine()).trimmed();
+        if (line.startsWith("E:ID_FS_TYPE=")) {
+            parsed.fsType = line.mid(13);
+        } else if (line.startsWith("E:ID_FS_UUID=")) {
+            parsed.uuid = line.mid(13);
+        } else if (line.startsWith("E:ID_FS_LABEL=")) {
+            parsed.label = line.mid(14);
+        } else if (line.startsWith("E:ID_PART_ENTRY_TYPE=")) {
+            parsed.partitionType = line.mid(21).toLower();
+        }
+    }
+
+    QMutexLocker locker(&s_udevMutex);
+    s_udevCache.insert(majorMinor, parsed);
+    *entry = parsed;
+    return true;
+}
+
+// lsblk prints flags as booleans or as "0"/"1" depending on its version
+bool jsonFlag(const QJsonValue &value) {
+    return value.isBool() ? value.toBool() : value.toString() == "1" || value.toInt() == 1;
+}
+
+qint64 jsonSize(const QJsonValue &value) {
+    return value.isDouble() ? qint64(value.toDouble()) : value.toString().toLongLong();
+}
+}
+
+QSharedPointer<const BlockDeviceSnapshot> DeviceInventory::scan() {
+    QSharedPointer<BlockDeviceSnapshot> snapshot(new BlockDeviceSnapshot);
+    if (!scanSysfs(snapshot.data())) {
+        qDebug() << "Cannot enumerate" << kSysBlock << "- falling back to lsblk";
+        snapshot->fromLsblk = scanLsblk(snapshot.data());
+    }
+    return snapshot;
+}
+
+bool DeviceInventory::find(const QString &device, BlockDevice *result) {
+    const QString name = QFileInfo(QFileInfo(device).canonicalFilePath()).fileName();
+    if (name.isEmpty() || !readDevice(name, result, nullptr, nullptr)) {
+        return false;
+    }
+    probe(result);
+    classify(result);
+    return true;
+}
+
+int DeviceInventory::rotational(const QString &device) {
+    const QString name = QFileInfo(QFileInfo(device).canonicalFilePath()).fileName();
+    if (name.isEmpty()) {
+        return -1;
+    }
+    const QString sysPath = QFileInfo(QString(kSysBlock) + "/" + name).canonicalFilePath();
+    return sysPath.isEmpty() ? -1 : readRotational(queuePath(sysPath));
+}
+
+// ----------------------------------------------------------------------------------------------
+// udev's by-uuid link first. Without udev (a generator runs before it) the
+// blkid cache knows the UUIDs it has seen, and verifies the device it names.
+// ----------------------------------------------------------------------------------------------
+bool DeviceInventory::findByUuid(const QString &uuid, BlockDevice *result) {
+    if (find("/dev/disk/by-uuid/" + uuid, result)) {
+        return true;
+    }
+
+    QString devname;
+    QString fsType;
+    {
+        QMutexLocker locker(&s_blkidMutex);
+        blkid_cache cache = blkidCache();
+        char *name = blkid_evaluate_tag("UUID", uuid.toUtf8().constData(), &cache);
+        if (!name) {
+            return false;
+        }
+        char *type = blkid_get_tag_value(cache, "TYPE", name);
+        devname = QString::fromLocal8Bit(name);
+        fsType = type ? QString::fromLatin1(type) : QString();
+        free(type);
+        free(name);
+    }
+
+    if (find(devname, result)) {
+        return true;
+    }
+    *result = BlockDevice();
+    result->path = devname;
+    result->name = QFileInfo(devname).fileName();
+    result->fsType = fsType;
+    result->uuid = uuid;
+    return true;
+}
+
+BlockDevice::Role DeviceInventory::roleForType(const QString &partitionType) {
+    static const QHash<QString, BlockDevice::Role> roles = {
+        {"c12a7328-f81f-11d2-ba4b-00a0c93ec93b", BlockDevice::EspRole},
+        {"0xef", BlockDevice::EspRole},
+        {"bc13c2ff-59e6-4262-a352-b275fd6f7172", BlockDevice::XbootldrRole},
+        {"0xea", BlockDevice::XbootldrRole},
+        {"21686148-6449-6e6f-744e-656564454649", BlockDevice::BiosBootRole},
+        {"0657fd6d-a4ab-43c4-84e5-0933c84b4f4f", BlockDevice::SwapRole},
+        {"0x82", BlockDevice::SwapRole},
+        {"e3c9e316-0b5c-4db8-817d-f92df00215ae", BlockDevice::MsrRole},
+    };
+    return roles.value(partitionType, BlockDevice::NoRole);
+}
+
+void DeviceInventory::classify(BlockDevice *device) {
+    device->role = roleForType(device->partitionType);
+    // Swap on a whole disk, or in a partition typed as plain data
+    if (device->role == BlockDevice::NoRole && device->fsType == "swap") {
+        device->role = BlockDevice::SwapRole;
+    }
+}
+
+///////////////////////////////////////////////////
+/// SYSFS
+//////////////////////////////////////////////////
+bool DeviceInventory::scanSysfs(BlockDeviceSnapshot *snapshot) {
+    const QStringList names = QDir(kSysBlock).entryList(QDir::AllEntries | QDir::NoDotAndDotDot, QDir::Name);
+    if (names.isEmpty()) {
+        return false;
+    }
+
+    const QHash<QString, QString> mounts = mountPoints();
+    QHash<QString, int> diskIndex;   // name -> position in snapshot->devices
+    struct Partition {
+        QString parent;
+        int number;
+        BlockDevice device;
+    };
+    QVector<Partition> partitions;
+
+    for (const QString &name : names) {
+        BlockDevice device;
+        QString parent;
+        int number = 0;
+        if (!readDevice(name, &device, &parent, &number)) {
+            continue;
+        }
+        device.mountPoint = mounts.value(device.majorMinor, mounts.value(device.path));
+        // Empty card readers and detached loop devices have nothing to probe
+        if (device.size > 0) {
+            probe(&device);
+        }
+        classify(&device);
+
+        if (device.type == "part") {
+            partitions.append({parent, number, device});
+        } else {
+            diskIndex.insert(name, snapshot->devices.size());
+            snapshot->devices.append(device);
+        }
+    }
+
+    // sda10 sorts before sda2 by name
+    std::sort(partitions.begin(), partitions.end(), [](const Partition &a, const Partition &b) {
+        return a.number < b.number;
+    });
+    for (const Partition &partition : std::as_const(partitions)) {
+        const auto disk = diskIndex.constFind(partition.parent);
+        if (disk != diskIndex.cend()) {
+            snapshot->devices[*disk].children.append(partition.device);
+        }
+    }
+    return true;
+}
+
+bool DeviceInventory::readDevice(const QString &name, BlockDevice *device, QString *parent, int *partition) {
+    // /sys/class/block/<name> links into /sys/devices
+    const QString sysPath = QFileInfo(QString(kSysBlock) + "/" + name).canonicalFilePath();
+    if (sysPath.isEmpty()) {
+        return false;
+    }
+    const bool isPartition = QFileInfo::exists(sysPath + "/partition");
+    const QString diskPath = queuePath(sysPath);
+
+    *device = BlockDevice();
+    device->name = name;
+    device->path = "/dev/" + name;
+    device->majorMinor = readSysfs(sysPath + "/dev");
+    device->size = readSysfs(sysPath + "/size").toLongLong() * 512;   // always 512 byte sectors
+    device->removable = readSysfs(diskPath + "/removable") == "1";
+    device->rotational = readRotational(diskPath) == 1;
+
+    if (isPartition) {
+        device->type = "part";
+    } else if (name.startsWith("loop")) {
+        device->type = "loop";
+    } else if (name.startsWith("sr")) {
+        device->type = "rom";
+    } else if (name.startsWith("dm-")) {
+        device->type = "dm";
+    } else if (name.startsWith("md")) {
+        device->type = "raid";
+    } else {
+        device->type = "disk";
+    }
+
+    if (isPartition && parent) {
+        *parent = QFileInfo(sysPath).dir().dirName();
+    }
+    if (isPartition && partition) {
+        *partition = readSysfs(sysPath + "/partition").toInt();
+    }
+    return true;
+}
+
+// ----------------------------------------------------------------------------------------------
+// udev's database first: reading it touches neither the device nor a
+// privileged cache. libblkid fills in what is still missing; as root it
+// probes (and refreshes its cache), otherwise it answers from the cache.
+// ----------------------------------------------------------------------------------------------
+void DeviceInventory::probe(BlockDevice *device) {
+    UdevEntry entry;
+    if (!device->majorMinor.isEmpty() && readUdev(device->majorMinor, &entry)) {
+        device->fsType = entry.fsType;
+        device->uuid = entry.uuid;
+        device->label = entry.label;
+        device->partitionType = entry.partitionType;
+    }
+    if (!device->fsType.isEmpty() && !device->uuid.isEmpty()) {
+        return;
+    }
+
+    QMutexLocker locker(&s_blkidMutex);
+    blkid_cache cache = blkidCache();
+    blkid_dev dev = cache ? blkid_get_dev(cache, device->path.toLocal8Bit().constData(), BLKID_DEV_NORMAL)
+                          : nullptr;
+    if (!dev) {
+        return;
+    }
+    blkid_tag_iterate iter = blkid_tag_iterate_begin(dev);
+    const char *type;
+    const char *value;
+    while (blkid_tag_next(iter, &type, &value) == 0) {
+        if (qstrcmp(type, "TYPE") == 0 && device->fsType.isEmpty()) {
+            device->fsType = QString::fromUtf8(value);
+        } else if (qstrcmp(type, "UUID") == 0 && device->uuid.isEmpty()) {
+            device->uuid = QString::fromUtf8(value);
+        } else if (qstrcmp(type, "LABEL") == 0 && device->label.isEmpty()) {
+            device->label = QString::fromUtf8(value);
+        }
+    }
+    blkid_tag_iterate_end(iter);
+}
+
+QHash<QString, QString> DeviceInventory::mountPoints() {
+    QHash<QString, QString> mounts;
+    QFile mountInfo("/proc/self/mountinfo");
+    if (!mountInfo.open(QIODevice::ReadOnly)) {
+        return mounts;
+    }
+
+    for (const MountInfo::Entry &entry : MountInfo::parse(mountInfo.readAll().toStdString())) {
+        const QString mountPoint = QString::fromStdString(entry.mountPoint);
+        // btrfs reports an anonymous major:minor, so the source is kept too
+        const QString device = QString::fromStdString(entry.device);
+        if (!mounts.contains(device)) {
+            mounts.insert(device, mountPoint);
+        }
+        const QString source = QString::fromStdString(entry.source);
+        if (source.startsWith("/dev/") && !mounts.contains(source)) {
+            mounts.insert(source, mountPoint);
+        }
+    }
+    return mounts;
+}
+
+///////////////////////////////////////////////////
+/// LSBLK FALLBACK
+//////////////////////////////////////////////////
+bool DeviceInventory::scanLsblk(BlockDeviceSnapshot *snapshot) {
+    QProcess process;
+    process.start("lsblk", QStringList() << "--json" << "--bytes"
+                                         << "--output" << "NAME,MAJ:MIN,SIZE,TYPE,FSTYPE,MOUNTPOINT,LABEL,UUID,"
+                                                          "PARTTYPE,RM,ROTA");
+    if (!process.waitForFinished()) {
+        process.kill();
+        process.waitForFinished();
+        return false;
+    }
+
+    const QJsonArray devicesArray = QJsonDocument::fromJson(process.readAllStandardOutput())
+                                        .object().value("blockdevices").toArray();
+    auto toDevice = [](const QJsonObject &object) {
+        BlockDevice device;
+        device.name = object.value("name").toString();
+        device.path = "/dev/" + device.name;
+        device.majorMinor = object.value("maj:min").toString();
+        device.type = object.value("type").toString();
+        device.size = jsonSize(object.value("size"));
+        device.removable = jsonFlag(object.value("rm"));
+        device.rotational = jsonFlag(object.value("rota"));
+        device.fsType = object.value("fstype").toString();
+        device.uuid = object.value("uuid").toString().trimmed();
+        device.label = object.value("label").toString();
+        device.partitionType = object.value("parttype").toString().toLower();
+        device.mountPoint = object.value("mountpoint").toString();
+        classify(&device);
+        return device;
+    };
+
+    for (const QJsonValue &value : devicesArray) {
+        const QJsonObject deviceObj = value.toObject();
+        BlockDevice device = toDevice(deviceObj);
+        const QJsonArray children = deviceObj.value("children").toArray();
+        for (const QJsonValue &child : children) {
+            device.children.append(toDevice(child.toObject()));
+        }
+        snapshot->devices.append(device);
+    }
+    return !snapshot->devices.isEmpty();
+}
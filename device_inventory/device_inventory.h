@@ -0,0 +1,85 @@
+#ifndef DEVICE_INVENTORY_H
+#define DEVICE_INVENTORY_H
+
+#include <QString>
+#include <QHash>
+#include <QVector>
+#include <QSharedPointer>
+
+// One disk or partition.
+struct BlockDevice {
+    // What a partition is for, from its partition table type
+    enum Role {
+        NoRole,
+        EspRole,        // EFI system partition
+        XbootldrRole,   // extended boot loader partition (/boot)
+        BiosBootRole,   // GRUB's BIOS boot partition
+        SwapRole,
+        MsrRole         // Microsoft reserved
+    };
+
+    QString name;          // e.g. sda1
+    QString path;          // /dev/sda1
+    QString majorMinor;    // e.g. 8:1
+    QString type;          // "disk", "part", "loop", "rom", "dm" or "raid"
+    qint64 size = 0;       // bytes
+    bool removable = false;
+    bool rotational = false;
+    QString fsType;
+    QString uuid;
+    QString label;
+    QString partitionType; // GPT type GUID in lower case, or an MBR type such as "0xef"
+    Role role = NoRole;
+    QString mountPoint;    // the first one, empty when not mounted (scan() only)
+    QVector<BlockDevice> children;  // partitions, for disks
+
+    bool isBoot() const { return role == EspRole || role == XbootldrRole || role == BiosBootRole; }
+};
+
+// What one scan found. Published once and never changed afterwards, so it
+// can be handed between threads and kept around freely.
+struct BlockDeviceSnapshot {
+    QVector<BlockDevice> devices;   // whole devices, partitions below them
+    bool fromLsblk = false;
+};
+
+// Block device model shared by Tolitica and ada_mounter_helper. Layout,
+// sizes and the removable/rotational flags come from sysfs; filesystem and
+// partition table details from udev's database, which holds what udev probed
+// when the device appeared and is readable by every user. libblkid's cache
+// fills in what udev doesn't know (e.g. early at boot). Parsed database
+// entries are cached per device until udev rewrites them, so rescans and
+// lookups only read sysfs. lsblk is only run when sysfs can't be read.
+//
+// Everything here is thread safe and may block on a slow disk; callers with
+// an event loop run it on a worker.
+class DeviceInventory
+{
+public:
+    // Every block device.
+    static QSharedPointer<const BlockDeviceSnapshot> scan();
+
+    // One device by node or symlink (/dev/sda1, /dev/disk/by-uuid/...),
+    // without walking the others.
+    static bool find(const QString &device, BlockDevice *result);
+    // One device by filesystem UUID.
+    static bool findByUuid(const QString &uuid, BlockDevice *result);
+    // The rotational flag of a device's disk, read from sysfs without probing
+    // anything: 1 or 0, -1 when it can't be told.
+    static int rotational(const QString &device);
+
+    // The role for a partition type; an exact lookup, O(1).
+    static BlockDevice::Role roleForType(const QString &partitionType);
+
+private:
+    static bool scanSysfs(BlockDeviceSnapshot *snapshot);
+    static bool scanLsblk(BlockDeviceSnapshot *snapshot);
+    // Fills device from /sys/class/block/<name>; false when it isn't there.
+    static bool readDevice(const QString &name, BlockDevice *device, QString *parent, int *partition);
+    static void probe(BlockDevice *device);
+    static void classify(BlockDevice *device);
+    // "major:minor" and source path -> mount point
+    static QHash<QString, QString> mountPoints();
+};
+
+#endif // DEVICE_INVENTORY_H
@@ -0,0 +1,73 @@
+#include "mount_info.h"
+
+namespace {
+bool isOctal(char c) {
+    return c >= '0' && c <= '7';
+}
+
+std::vector<std::string> split(const std::string &line, char separator) {
+    std::vector<std::string> fields;
+    size_t start = 0;
+    for (;;) {
+        const size_t end = line.find(separator, start);
+        fields.push_back(line.substr(start, end == std::string::npos ? end : end - start));
+        if (end == std::string::npos) {
+            return fields;
+        }
+        start = end + 1;
+    }
+}
+}
+
+// ----------------------------------------------------------------------------------------------
+// One line per mount:
+//   36 35 98:0 /mnt1 /mnt/parent rw,noatime master:1 - ext3 /dev/root rw,errors=continue
+//   (1)(2)(3)   (4)   (5)         (6)       (7...)   - (8)  (9)       (10)
+// Optional fields (7) run up to the lone "-" separator.
+// ----------------------------------------------------------------------------------------------
+std::vector<MountInfo::Entry> MountInfo::parse(const std::string &mountinfo) {
+    std::vector<Entry> entries;
+
+    size_t start = 0;
+    while (start < mountinfo.size()) {
+        size_t end = mountinfo.find('\n', start);
+        if (end == std::string::npos) {
+            end = mountinfo.size();
+        }
+        const std::vector<std::string> fields = split(mountinfo.substr(start, end - start), ' ');
+        start = end + 1;
+
+        size_t separator = 6;
+        while (separator < fields.size() && fields[separator] != "-") {
+            ++separator;
+        }
+        if (fields.size() < separator + 4) {
+            continue;
+        }
+
+        Entry entry;
+        entry.device = fields[2];
+        entry.mountPoint = unescape(fields[4]);
+        entry.options = fields[5];
+        entry.fsType = fields[separator + 1];
+        entry.source = unescape(fields[separator + 2]);
+        entry.superOptions = fields[separator + 3];
+        entries.push_back(entry);
+    }
+    return entries;
+}
+
+std::string MountInfo::unescape(const std::string &field) {
+    std::string out;
+    out.reserve(field.size());
+    for (size_t i = 0; i < field.size(); ++i) {
+        if (field[i] == '\\' && i + 3 < field.size() && isOctal(field[i + 1])
+            && isOctal(field[i + 2]) && isOctal(field[i + 3])) {
+            out += char((field[i + 1] - '0') * 64 + (field[i + 2] - '0') * 8 + (field[i + 3] - '0'));
+            i += 3;
+            continue;
+        }
+        out += field[i];
+    }
+    return out;
+}
@@ -0,0 +1,30 @@
+#ifndef MOUNT_INFO_H
+#define MOUNT_INFO_H
+
+#include <string>
+#include <vector>
+
+// /proc/self/mountinfo, parsed with the standard library only, so that
+// DeviceInventory, ada_mounter_helper's MountTable and the Qt-free daemon
+// all read the table the same way.
+class MountInfo
+{
+public:
+    struct Entry {
+        std::string device;        // major:minor
+        std::string mountPoint;
+        std::string options;       // per-mount options
+        std::string fsType;
+        std::string source;        // e.g. /dev/sdb1
+        std::string superOptions;  // per-superblock options
+    };
+
+    // Every well-formed line in table order; of stacked mounts on one mount
+    // point, the last one is the visible one.
+    static std::vector<Entry> parse(const std::string &mountinfo);
+
+    // mountinfo escapes space, tab, newline and backslash as \ooo
+    static std::string unescape(const std::string &field);
+};
+
+#endif // MOUNT_INFO_H
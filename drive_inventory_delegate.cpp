@@ -0,0 +1,91 @@
+#include "drive_inventory_delegate.h"
+#include "drive_inventory_model.h"
+
+#include <QApplication>
+#include <QKeyEvent>
+#include <QLineEdit>
+#include <QMessageBox>
+#include <QMouseEvent>
+#include <QRegularExpressionValidator>
+
+DriveInventoryDelegate::DriveInventoryDelegate(QObject *parent)
+    : QStyledItemDelegate(parent)
+{}
+
+QWidget *DriveInventoryDelegate::createEditor(QWidget *parent, const QStyleOptionViewItem &option,
+                                              const QModelIndex &index) const {
+    if (index.column() != DriveInventoryModel::OptionsColumn)
+        return QStyledItemDelegate::createEditor(parent, option, index);
+
+    QLineEdit *edit = new QLineEdit(parent);
+    edit->setPlaceholderText("automatic");
+    edit->setValidator(new QRegularExpressionValidator(DriveInventoryModel::optionsPattern(), edit));
+    return edit;
+}
+
+void DriveInventoryDelegate::setEditorData(QWidget *editor, const QModelIndex &index) const {
+    QLineEdit *edit = qobject_cast<QLineEdit*>(editor);
+    if (edit && index.column() == DriveInventoryModel::OptionsColumn)
+        edit->setText(index.data(Qt::EditRole).toString());
+    else
+        QStyledItemDelegate::setEditorData(editor, index);
+}
+
+void DriveInventoryDelegate::setModelData(QWidget *editor, QAbstractItemModel *model,
+                                          const QModelIndex &index) const {
+    QLineEdit *edit = qobject_cast<QLineEdit*>(editor);
+    // Unchanged text isn't an edit; skip it so the row doesn't turn dirty
+    if (edit && index.column() == DriveInventoryModel::OptionsColumn) {
+        if (edit->text().trimmed() != index.data(Qt::EditRole).toString())
+            model->setData(index, edit->text(), Qt::EditRole);
+    } else {
+        QStyledItemDelegate::setModelData(editor, model, index);
+    }
+}
+
+// ----------------------------------------------------------------------------------------------
+// Same hit testing as QStyledItemDelegate::editorEvent, so the check toggles
+// exactly where and when it would, with the confirmation in between.
+// ----------------------------------------------------------------------------------------------
+bool DriveInventoryDelegate::editorEvent(QEvent *event, QAbstractItemModel *model,
+                                         const QStyleOptionViewItem &option, const QModelIndex &index) {
+    const Qt::ItemFlags flags = model->flags(index);
+    const QVariant value = index.data(Qt::CheckStateRole);
+    if (!(flags & Qt::ItemIsUserCheckable) || !(flags & Qt::ItemIsEnabled)
+        || !(option.state & QStyle::State_Enabled) || !value.isValid())
+        return false;
+
+    if (event->type() == QEvent::MouseButtonRelease || event->type() == QEvent::MouseButtonDblClick
+        || event->type() == QEvent::MouseButtonPress) {
+        QStyleOptionViewItem viewOption(option);
+        initStyleOption(&viewOption, index);
+        const QWidget *widget = option.widget;
+        QStyle *style = widget ? widget->style() : QApplication::style();
+        const QRect checkRect = style->subElementRect(QStyle::SE_ItemViewItemCheckIndicator, &viewOption, widget);
+        const QMouseEvent *mouseEvent = static_cast<QMouseEvent*>(event);
+        if (mouseEvent->button() != Qt::LeftButton || !checkRect.contains(mouseEvent->pos()))
+            return false;
+        // Toggle on release only; swallow the rest so no editor opens
+        if (event->type() != QEvent::MouseButtonRelease)
+            return true;
+    } else if (event->type() == QEvent::KeyPress) {
+        const int key = static_cast<QKeyEvent*>(event)->key();
+        if (key != Qt::Key_Space && key != Qt::Key_Select)
+            return false;
+    } else {
+        return false;
+    }
+
+    if (index.column() == DriveInventoryModel::MountColumn && index.data(DriveInventoryModel::DangerousRole).toBool()) {
+        QMessageBox::StandardButton reply =
+            QMessageBox::warning(const_cast<QWidget*>(option.widget), "Warning",
+                                 "Changing the state of this partition can be harmful to your system.\n"
+                                 "Do you really want to continue?",
+                                 QMessageBox::Yes | QMessageBox::No);
+        if (reply == QMessageBox::No)
+            return true;
+    }
+
+    const Qt::CheckState state = value.toInt() == Qt::Checked ? Qt::Unchecked : Qt::Checked;
+    return model->setData(index, state, Qt::CheckStateRole);
+}
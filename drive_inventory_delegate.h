@@ -0,0 +1,26 @@
+#ifndef DRIVE_INVENTORY_DELEGATE_H
+#define DRIVE_INVENTORY_DELEGATE_H
+
+#include <QStyledItemDelegate>
+
+// Interaction for DriveInventoryModel rows. Check toggles on swap and
+// boot-like partitions (DangerousRole) ask for confirmation first, and the
+// options cell gets a validating line edit, created only while it is edited.
+class DriveInventoryDelegate : public QStyledItemDelegate
+{
+    Q_OBJECT
+
+public:
+    explicit DriveInventoryDelegate(QObject *parent = nullptr);
+
+    QWidget *createEditor(QWidget *parent, const QStyleOptionViewItem &option,
+                          const QModelIndex &index) const override;
+    void setEditorData(QWidget *editor, const QModelIndex &index) const override;
+    void setModelData(QWidget *editor, QAbstractItemModel *model, const QModelIndex &index) const override;
+
+protected:
+    bool editorEvent(QEvent *event, QAbstractItemModel *model, const QStyleOptionViewItem &option,
+                     const QModelIndex &index) override;
+};
+
+#endif // DRIVE_INVENTORY_DELEGATE_H
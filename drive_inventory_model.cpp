@@ -0,0 +1,454 @@
+#include "drive_inventory_model.h"
+
+#include <QBrush>
+#include <utility>
+
+DriveInventoryModel::DriveInventoryModel(QObject *parent)
+    : QAbstractItemModel(parent)
+{}
+
+const QRegularExpression &DriveInventoryModel::optionsPattern() {
+    static const QRegularExpression pattern(QRegularExpression::anchoredPattern("[A-Za-z0-9_.:+=,-]*"));
+    return pattern;
+}
+
+///////////////////////////////////////////////////
+/// LISTING
+//////////////////////////////////////////////////
+void DriveInventoryModel::update(const QVector<Disk> &disks) {
+    mergeRows(&m_disks, disks, QModelIndex());
+
+    m_rows.clear();
+    m_dirty.clear();
+    for (int i = 0; i < m_disks.size(); i++) {
+        if (!m_disks.at(i).entry.token.isEmpty()) {
+            m_rows.insert(m_disks.at(i).entry.token, qMakePair(i, -1));
+            updateDirty(m_disks.at(i).entry);
+        }
+        for (int j = 0; j < m_disks.at(i).partitions.size(); j++) {
+            if (!m_disks.at(i).partitions.at(j).token.isEmpty()) {
+                m_rows.insert(m_disks.at(i).partitions.at(j).token, qMakePair(i, j));
+                updateDirty(m_disks.at(i).partitions.at(j));
+            }
+        }
+    }
+}
+
+void DriveInventoryModel::setConfigLines(const QStringList &lines) {
+    m_configLines = lines;
+}
+
+// ----------------------------------------------------------------------------------------------
+// One level of rows. Rows that are no longer listed go first; the rest are
+// walked in listing order, updating rows in place, moving them when the
+// order changed and inserting the ones not seen before.
+// ----------------------------------------------------------------------------------------------
+template <typename Row>
+void DriveInventoryModel::mergeRows(QVector<Row> *rows, const QVector<Row> &listed, const QModelIndex &parent) {
+    QSet<QString> listedKeys;
+    for (const Row &row : listed)
+        listedKeys.insert(key(row));
+    for (int i = rows->size() - 1; i >= 0; i--) {
+        if (!listedKeys.contains(key(rows->at(i)))) {
+            beginRemoveRows(parent, i, i);
+            rows->remove(i);
+            indexRows(rows);
+            endRemoveRows();
+        }
+    }
+
+    for (int i = 0; i < listed.size(); i++) {
+        const QString listedKey = key(listed.at(i));
+        int j = i;
+        while (j < rows->size() && key(rows->at(j)) != listedKey)
+            j++;
+
+        if (j == rows->size()) {
+            Row row = listed.at(i);
+            adopt(&row);
+            beginInsertRows(parent, i, i);
+            rows->insert(i, row);
+            indexRows(rows);
+            endInsertRows();
+            continue;
+        }
+        if (j != i) {
+            beginMoveRows(parent, j, j, parent, i);
+            rows->move(j, i);
+            indexRows(rows);
+            endMoveRows();
+        }
+        updateRow(&(*rows)[i], listed.at(i), i, parent);
+    }
+
+    // Only left when the listing had the same key twice
+    if (rows->size() > listed.size()) {
+        beginRemoveRows(parent, listed.size(), rows->size() - 1);
+        rows->resize(listed.size());
+        indexRows(rows);
+        endRemoveRows();
+    }
+}
+
+// Views ask for parents from the end*Rows() signals, so the ids have to
+// point at the new rows by then
+void DriveInventoryModel::indexRows(QVector<Disk> *rows) {
+    m_diskRows.clear();
+    for (int i = 0; i < rows->size(); i++)
+        m_diskRows.insert(rows->at(i).id, i);
+}
+
+QString DriveInventoryModel::key(const Entry &entry) {
+    return entry.token.isEmpty() ? entry.device : entry.token;
+}
+
+// New rows come in as read from the config, with nothing pending
+void DriveInventoryModel::adopt(Disk *disk) {
+    disk->id = ++m_lastDiskId;
+    adopt(&disk->entry);
+    for (Entry &partition : disk->partitions)
+        adopt(&partition);
+}
+
+void DriveInventoryModel::adopt(Entry *entry) {
+    entry->appliedMount = entry->mount;
+    entry->appliedOnAccess = entry->onAccess;
+    entry->appliedOptions = entry->options;
+}
+
+void DriveInventoryModel::updateRow(Disk *disk, const Disk &listed, int row, const QModelIndex &parent) {
+    updateRow(&disk->entry, listed.entry, row, parent);
+    mergeRows(&disk->partitions, listed.partitions, index(row, 0, parent));
+}
+
+// ----------------------------------------------------------------------------------------------
+// Takes over what the listing says about a row. Edits that were not applied
+// yet are kept, and are now compared against the config as it is on disk;
+// the mount state is left for the daemon to update.
+// ----------------------------------------------------------------------------------------------
+void DriveInventoryModel::updateRow(Entry *entry, const Entry &listed, int row, const QModelIndex &parent) {
+    Entry merged = listed;
+    adopt(&merged);
+    merged.state = entry->state;
+    merged.stateDetail = entry->stateDetail;
+    if (entry->mount != entry->appliedMount || entry->onAccess != entry->appliedOnAccess
+        || entry->options != entry->appliedOptions) {
+        merged.mount = entry->mount;
+        merged.onAccess = entry->onAccess;
+        merged.idleSeconds = entry->idleSeconds;
+        merged.options = entry->options;
+    }
+
+    const bool changed = merged.device != entry->device || merged.size != entry->size
+        || merged.mountable != entry->mountable || merged.dangerous != entry->dangerous
+        || merged.mount != entry->mount || merged.onAccess != entry->onAccess
+        || merged.idleSeconds != entry->idleSeconds || merged.options != entry->options;
+    *entry = merged;
+    if (changed)
+        emit dataChanged(index(row, 0, parent), index(row, ColumnCount - 1, parent));
+}
+
+///////////////////////////////////////////////////
+/// EDITS
+//////////////////////////////////////////////////
+void DriveInventoryModel::updateDirty(const Entry &entry) {
+    if (entry.mount != entry.appliedMount || entry.onAccess != entry.appliedOnAccess
+        || entry.options != entry.appliedOptions)
+        m_dirty.insert(entry.token);
+    else
+        m_dirty.remove(entry.token);
+}
+
+bool DriveInventoryModel::isDangerousModified() const {
+    for (const QString &token : m_dirty) {
+        const QPair<int, int> row = m_rows.value(token);
+        const Entry &entry = row.second < 0 ? m_disks.at(row.first).entry
+                                            : m_disks.at(row.first).partitions.at(row.second);
+        if (entry.dangerous && entry.mount != entry.appliedMount)
+            return true;
+    }
+    return false;
+}
+
+QString DriveInventoryModel::configLine(const Entry &entry) {
+    QString line = entry.token;
+    if (!entry.options.isEmpty())
+        line += " options=" + entry.options;
+    if (entry.onAccess) {
+        line += " onaccess";
+        if (entry.idleSeconds > 0)
+            line += QString(" idle=%1").arg(entry.idleSeconds);
+    }
+    return line;
+}
+
+QStringList DriveInventoryModel::configLines() const {
+    QStringList lines;
+    for (const Disk &disk : m_disks) {
+        if (disk.entry.mountable && disk.entry.mount && !disk.entry.token.isEmpty())
+            lines.append(configLine(disk.entry));
+        for (const Entry &partition : disk.partitions) {
+            if (partition.mountable && partition.mount && !partition.token.isEmpty())
+                lines.append(configLine(partition));
+        }
+    }
+
+    // Only the rows shown can be edited; what the config says about the
+    // others stays, e.g. for a drive that is plugged in again later
+    for (const QString &line : m_configLines) {
+        if (!hasMountableRow(line.section(' ', 0, 0)))
+            lines.append(line);
+    }
+    return lines;
+}
+
+void DriveInventoryModel::markApplied() {
+    for (const QString &token : std::as_const(m_dirty)) {
+        Entry *entry = entryForToken(token);
+        entry->appliedMount = entry->mount;
+        entry->appliedOnAccess = entry->onAccess;
+        entry->appliedOptions = entry->options;
+    }
+    m_dirty.clear();
+    m_configLines = configLines();
+}
+
+void DriveInventoryModel::revert() {
+    for (const QString &token : std::as_const(m_dirty)) {
+        Entry *entry = entryForToken(token);
+        entry->mount = entry->appliedMount;
+        entry->onAccess = entry->appliedOnAccess;
+        entry->options = entry->appliedOptions;
+        const QModelIndex first = indexForToken(token, 0);
+        emit dataChanged(first, first.siblingAtColumn(ColumnCount - 1));
+    }
+    m_dirty.clear();
+}
+
+///////////////////////////////////////////////////
+/// STATE
+//////////////////////////////////////////////////
+QString DriveInventoryModel::stateText(const QString &state) {
+    if (state == "mounted")
+        return "Mounted";
+    if (state == "automount")
+        return "Mounts on access";
+    if (state == "pending")
+        return "Mounting...";
+    if (state == "failed")
+        return "Failed";
+    if (state.isEmpty())
+        return QString();
+    return "Not mounted";
+}
+
+void DriveInventoryModel::setMountState(const QString &uuid, const QString &state, const QString &detail) {
+    Entry *entry = entryForToken("UUID=" + uuid);
+    if (!entry)
+        return;
+    entry->state = state;
+    entry->stateDetail = detail;
+    const QModelIndex index = indexForToken(entry->token, StateColumn);
+    emit dataChanged(index, index);
+}
+
+///////////////////////////////////////////////////
+/// ROWS
+//////////////////////////////////////////////////
+const DriveInventoryModel::Entry *DriveInventoryModel::entryAt(const QModelIndex &index) const {
+    if (index.internalId() == 0)
+        return index.row() < m_disks.size() ? &m_disks.at(index.row()).entry : nullptr;
+    const int disk = diskRow(index.internalId());
+    if (disk < 0 || index.row() >= m_disks.at(disk).partitions.size())
+        return nullptr;
+    return &m_disks.at(disk).partitions.at(index.row());
+}
+
+DriveInventoryModel::Entry *DriveInventoryModel::entryAt(const QModelIndex &index) {
+    return const_cast<Entry *>(std::as_const(*this).entryAt(index));
+}
+
+DriveInventoryModel::Entry *DriveInventoryModel::entryForToken(const QString &token) {
+    const auto it = m_rows.constFind(token);
+    if (it == m_rows.cend())
+        return nullptr;
+    Disk &disk = m_disks[it->first];
+    return it->second < 0 ? &disk.entry : &disk.partitions[it->second];
+}
+
+bool DriveInventoryModel::hasMountableRow(const QString &token) const {
+    const auto it = m_rows.constFind(token);
+    if (it == m_rows.cend())
+        return false;
+    const Disk &disk = m_disks.at(it->first);
+    return it->second < 0 ? disk.entry.mountable : disk.partitions.at(it->second).mountable;
+}
+
+QModelIndex DriveInventoryModel::indexForToken(const QString &token, int column) {
+    const auto it = m_rows.constFind(token);
+    if (it == m_rows.cend())
+        return QModelIndex();
+    if (it->second < 0)
+        return createIndex(it->first, column, quintptr(0));
+    return createIndex(it->second, column, m_disks.at(it->first).id);
+}
+
+QModelIndex DriveInventoryModel::index(int row, int column, const QModelIndex &parent) const {
+    if (!hasIndex(row, column, parent))
+        return QModelIndex();
+    if (!parent.isValid())
+        return createIndex(row, column, quintptr(0));
+    return createIndex(row, column, m_disks.at(parent.row()).id);
+}
+
+QModelIndex DriveInventoryModel::parent(const QModelIndex &child) const {
+    if (!child.isValid() || child.internalId() == 0)
+        return QModelIndex();
+    const int row = diskRow(child.internalId());
+    return row < 0 ? QModelIndex() : createIndex(row, 0, quintptr(0));
+}
+
+int DriveInventoryModel::rowCount(const QModelIndex &parent) const {
+    if (!parent.isValid())
+        return m_disks.size();
+    if (parent.internalId() == 0 && parent.column() == 0)
+        return m_disks.at(parent.row()).partitions.size();
+    return 0;
+}
+
+int DriveInventoryModel::columnCount(const QModelIndex &) const {
+    return ColumnCount;
+}
+
+QVariant DriveInventoryModel::data(const QModelIndex &index, int role) const {
+    const Entry *found = index.isValid() ? entryAt(index) : nullptr;
+    if (!found)
+        return QVariant();
+    const Entry &entry = *found;
+
+    if (role == DangerousRole)
+        return entry.dangerous;
+    if (role == TokenRole)
+        return entry.token;
+
+    switch (index.column()) {
+    case DeviceColumn:
+        if (role == Qt::DisplayRole)
+            return entry.device;
+        break;
+    case SizeColumn:
+        if (role == Qt::DisplayRole)
+            return entry.size;
+        break;
+    case MountColumn:
+        if (!entry.mountable)
+            break;
+        if (role == Qt::DisplayRole)
+            return "Mount Drive";
+        if (role == Qt::CheckStateRole)
+            return entry.mount ? Qt::Checked : Qt::Unchecked;
+        break;
+    case OnAccessColumn:
+        if (!entry.mountable)
+            break;
+        if (role == Qt::DisplayRole)
+            return "On access";
+        if (role == Qt::CheckStateRole)
+            return entry.onAccess ? Qt::Checked : Qt::Unchecked;
+        if (role == Qt::ToolTipRole)
+            return QString("Mount the drive only when it is first opened and unmount it "
+                           "after %1 minutes of inactivity, so it can spin down.")
+                .arg(entry.idleSeconds / 60);
+        break;
+    case OptionsColumn:
+        if (!entry.mountable)
+            break;
+        // Empty means the automatic profile: filesystem defaults plus SSD/HDD tuning.
+        if (role == Qt::DisplayRole)
+            return entry.options.isEmpty() ? QString("automatic") : entry.options;
+        if (role == Qt::EditRole)
+            return entry.options;
+        if (role == Qt::ForegroundRole && entry.options.isEmpty())
+            return QBrush(Qt::gray);
+        if (role == Qt::ToolTipRole)
+            return QString("Comma separated mount options, e.g. noatime,compress=zstd:3\n"
+                           "Leave empty for settings chosen from the filesystem and drive type.");
+        break;
+    case StateColumn:
+        if (role == Qt::DisplayRole)
+            return stateText(entry.state);
+        if (role == Qt::ToolTipRole)
+            return entry.stateDetail;
+        if (role == Qt::ForegroundRole && entry.state == "failed")
+            return QBrush(Qt::red);
+        break;
+    }
+    return QVariant();
+}
+
+bool DriveInventoryModel::setData(const QModelIndex &index, const QVariant &value, int role) {
+    Entry *found = index.isValid() ? entryAt(index) : nullptr;
+    if (!found || !(flags(index) & Qt::ItemIsEnabled))
+        return false;
+    Entry &entry = *found;
+
+    if (role == Qt::CheckStateRole && index.column() == MountColumn) {
+        entry.mount = value.toInt() == Qt::Checked;
+    } else if (role == Qt::CheckStateRole && index.column() == OnAccessColumn) {
+        entry.onAccess = value.toInt() == Qt::Checked;
+    } else if (role == Qt::EditRole && index.column() == OptionsColumn) {
+        const QString options = value.toString().trimmed();
+        if (!optionsPattern().match(options).hasMatch())
+            return false;
+        entry.options = options;
+    } else {
+        return false;
+    }
+
+    updateDirty(entry);
+    emit dataChanged(index, index);
+    emit edited();
+    return true;
+}
+
+Qt::ItemFlags DriveInventoryModel::flags(const QModelIndex &index) const {
+    const Entry *found = index.isValid() ? entryAt(index) : nullptr;
+    if (!found)
+        return Qt::NoItemFlags;
+    const Entry &entry = *found;
+
+    Qt::ItemFlags flags = Qt::ItemIsEnabled | Qt::ItemIsSelectable;
+    // Without a UUID there is nothing to put in the config
+    const bool editable = entry.mountable && !entry.token.isEmpty();
+    switch (index.column()) {
+    case MountColumn:
+    case OnAccessColumn:
+        if (!entry.mountable)
+            break;
+        flags |= Qt::ItemIsUserCheckable;
+        if (!editable)
+            flags &= ~Qt::ItemIsEnabled;
+        break;
+    case OptionsColumn:
+        if (editable)
+            flags |= Qt::ItemIsEditable;
+        else if (entry.mountable)
+            flags &= ~Qt::ItemIsEnabled;
+        break;
+    }
+    return flags;
+}
+
+QVariant DriveInventoryModel::headerData(int section, Qt::Orientation orientation, int role) const {
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole)
+        return QVariant();
+    switch (section) {
+    case DeviceColumn: return "Device";
+    case SizeColumn: return "Size";
+    case MountColumn: return "Mount";
+    case OnAccessColumn: return "On Access";
+    case OptionsColumn: return "Mount Options";
+    case StateColumn: return "State";
+    }
+    return QVariant();
+}
@@ -0,0 +1,149 @@
+#ifndef DRIVE_INVENTORY_MODEL_H
+#define DRIVE_INVENTORY_MODEL_H
+
+#include <QAbstractItemModel>
+#include <QHash>
+#include <QPair>
+#include <QRegularExpression>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+// Disks and their partitions for the Mount Drives page, two levels deep.
+// Every row is plain data: the mount and on-access choices are checkable
+// cells, the options profile is edited through DriveInventoryDelegate, and
+// the state column shows what ada_mounter_helper reports.
+//
+// Each row keeps the values last read from or written to the config next
+// to the edited ones. Rows that differ are tracked by token in a dirty set,
+// so isModified() and friends only look at what was changed, and a new
+// listing is merged row by row (see update()) without losing those edits.
+class DriveInventoryModel : public QAbstractItemModel
+{
+    Q_OBJECT
+
+public:
+    enum Column {
+        DeviceColumn,
+        SizeColumn,
+        MountColumn,
+        OnAccessColumn,
+        OptionsColumn,
+        StateColumn,
+        ColumnCount
+    };
+
+    enum Role {
+        // Whether changing the row's mount choice needs a confirmation
+        DangerousRole = Qt::UserRole + 1,
+        TokenRole
+    };
+
+    // One disk or partition row
+    struct Entry {
+        QString device;         // e.g. /dev/sda1
+        QString size;
+        QString token;          // "UUID=<uuid>", empty when there is none
+        bool mountable = false; // a partition, or a disk without any
+        bool dangerous = false; // swap or boot-like
+
+        bool mount = false;
+        bool onAccess = false;
+        int idleSeconds = 0;    // written with onaccess when above 0
+        QString options;        // empty for the automatic profile
+
+        // As in the config
+        bool appliedMount = false;
+        bool appliedOnAccess = false;
+        QString appliedOptions;
+
+        QString state;          // as reported by the daemon, see setMountState()
+        QString stateDetail;
+    };
+
+    struct Disk {
+        Entry entry;
+        QVector<Entry> partitions;
+        quintptr id = 0;        // set by the model, the partitions' internalId
+    };
+
+    explicit DriveInventoryModel(QObject *parent = nullptr);
+
+    // Brings the rows in line with a new listing, keyed by UUID token (device
+    // path for rows without one): rows that went away are removed, new ones
+    // inserted and the rest updated in place. Each new entry's values are
+    // taken as the applied ones; rows with pending edits keep them.
+    void update(const QVector<Disk> &disks);
+
+    // The config as read, one line per token. Lines for tokens without a
+    // mountable row (an unplugged drive, a hidden partition, FSTYPE profiles)
+    // are written back by configLines() as they are.
+    void setConfigLines(const QStringList &lines);
+
+    // EDITS
+    bool isModified() const { return !m_dirty.isEmpty(); }
+    bool isDangerousModified() const;
+    // The config line of every row to be mounted, plus the config lines of
+    // tokens that have no row
+    QStringList configLines() const;
+    // Makes the edited values the applied ones once they have been written.
+    void markApplied();
+    // Drops every pending edit.
+    void revert() override;
+
+    // STATE
+    void setMountState(const QString &uuid, const QString &state, const QString &detail = QString());
+
+    // What an options profile may consist of; lists go into the config verbatim.
+    static const QRegularExpression &optionsPattern();
+
+    // QAbstractItemModel
+    QModelIndex index(int row, int column, const QModelIndex &parent = QModelIndex()) const override;
+    QModelIndex parent(const QModelIndex &child) const override;
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    bool setData(const QModelIndex &index, const QVariant &value, int role = Qt::EditRole) override;
+    Qt::ItemFlags flags(const QModelIndex &index) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+signals:
+    // A mount, on-access or options value was edited.
+    void edited();
+
+private:
+    // LISTING
+    template <typename Row>
+    void mergeRows(QVector<Row> *rows, const QVector<Row> &listed, const QModelIndex &parent);
+    static QString key(const Entry &entry);
+    static QString key(const Disk &disk) { return key(disk.entry); }
+    void adopt(Disk *disk);
+    static void adopt(Entry *entry);
+    void updateRow(Disk *disk, const Disk &listed, int row, const QModelIndex &parent);
+    void updateRow(Entry *entry, const Entry &listed, int row, const QModelIndex &parent);
+    // Rebuilds m_diskRows after disk rows were inserted, moved or removed
+    void indexRows(QVector<Disk> *rows);
+    static void indexRows(QVector<Entry> *) {}
+
+    // internalId 0 for disks, the disk's id for partitions; ids outlive row moves
+    int diskRow(quintptr id) const { return m_diskRows.value(id, -1); }
+    // nullptr for a partition index whose disk is gone
+    const Entry *entryAt(const QModelIndex &index) const;
+    Entry *entryAt(const QModelIndex &index);
+    Entry *entryForToken(const QString &token);
+    bool hasMountableRow(const QString &token) const;
+    QModelIndex indexForToken(const QString &token, int column);
+    void updateDirty(const Entry &entry);
+    static QString configLine(const Entry &entry);
+    static QString stateText(const QString &state);
+
+    QVector<Disk> m_disks;
+    QHash<quintptr, int> m_diskRows;         // disk id -> row
+    QHash<QString, QPair<int, int>> m_rows;  // token -> disk, partition (-1 for the disk)
+    QSet<QString> m_dirty;                   // tokens whose rows differ from the config
+    QStringList m_configLines;               // see setConfigLines()
+    quintptr m_lastDiskId = 0;
+};
+
+#endif // DRIVE_INVENTORY_MODEL_H
@@ -0,0 +1,97 @@
+#include "drive_inventory_model.h"
+
+#include <QtTest>
+
+// What DriveInventoryModel::configLines() writes back when rows come and go
+// while edits are pending.
+
+class DriveInventoryModelTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void keepsLinesOfRemovedRows();
+    void dropsLinesOfUncheckedRows();
+    void markAppliedKeepsRemovedRows();
+
+private:
+    static DriveInventoryModel::Entry partition(const QString &uuid, bool mount);
+    static DriveInventoryModel::Disk usbDisk();
+    static QStringList config();
+};
+
+DriveInventoryModel::Entry DriveInventoryModelTest::partition(const QString &uuid, bool mount) {
+    DriveInventoryModel::Entry entry;
+    entry.device = "/dev/" + uuid;
+    entry.token = "UUID=" + uuid;
+    entry.mountable = true;
+    entry.mount = mount;
+    return entry;
+}
+
+// sdb with one enabled partition on access and one that isn't enabled
+DriveInventoryModel::Disk DriveInventoryModelTest::usbDisk() {
+    DriveInventoryModel::Disk disk;
+    disk.entry.device = "/dev/sdb";
+    DriveInventoryModel::Entry data = partition("1111-AAAA", true);
+    data.onAccess = true;
+    data.idleSeconds = 600;
+    disk.partitions << data << partition("2222-BBBB", false);
+    return disk;
+}
+
+QStringList DriveInventoryModelTest::config() {
+    return {"UUID=1111-AAAA onaccess idle=600",
+            "UUID=3333-CCCC options=noatime",   // a hidden partition, never a row
+            "FSTYPE=ntfs3 options=uid=1000"};
+}
+
+void DriveInventoryModelTest::keepsLinesOfRemovedRows() {
+    DriveInventoryModel model;
+    model.setConfigLines(config());
+    model.update({usbDisk()});
+    QCOMPARE(model.rowCount(model.index(0, 0)), 2);
+
+    // Unplugged
+    model.update({});
+    QCOMPARE(model.rowCount(), 0);
+
+    const QStringList lines = model.configLines();
+    QVERIFY(lines.contains("UUID=1111-AAAA onaccess idle=600"));
+    QVERIFY(lines.contains("UUID=3333-CCCC options=noatime"));
+    QVERIFY(lines.contains("FSTYPE=ntfs3 options=uid=1000"));
+    QCOMPARE(lines.size(), 3);
+}
+
+void DriveInventoryModelTest::dropsLinesOfUncheckedRows() {
+    DriveInventoryModel model;
+    model.setConfigLines(config());
+    model.update({usbDisk()});
+
+    const QModelIndex data = model.index(0, DriveInventoryModel::MountColumn, model.index(0, 0));
+    QVERIFY(model.setData(data, Qt::Unchecked, Qt::CheckStateRole));
+
+    const QStringList lines = model.configLines();
+    QVERIFY(!lines.join('\n').contains("1111-AAAA"));
+    QVERIFY(lines.contains("UUID=3333-CCCC options=noatime"));
+}
+
+void DriveInventoryModelTest::markAppliedKeepsRemovedRows() {
+    DriveInventoryModel model;
+    model.setConfigLines(config());
+    model.update({usbDisk()});
+
+    // Enable the second partition, apply, then unplug the drive
+    const QModelIndex other = model.index(1, DriveInventoryModel::MountColumn, model.index(0, 0));
+    QVERIFY(model.setData(other, Qt::Checked, Qt::CheckStateRole));
+    model.markApplied();
+    model.update({});
+
+    const QStringList lines = model.configLines();
+    QVERIFY(lines.contains("UUID=1111-AAAA onaccess idle=600"));
+    QVERIFY(lines.contains("UUID=2222-BBBB"));
+}
+
+QTEST_GUILESS_MAIN(DriveInventoryModelTest)
+
+#include "drive_inventory_model_test.moc"
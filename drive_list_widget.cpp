@@ -1,11 +1,11 @@
 #include "drive_list_widget.h"
+#include "drive_inventory_model.h"
+#include "drive_inventory_delegate.h"
+#include "block_device_enumerator.h"
+#include "privileged_helper.h"
 #include <QVBoxLayout>
-#include <QProcess>
-#include <QJsonDocument>
-#include <QJsonObject>
-#include <QJsonArray>
-#include <QTreeWidgetItem>
-#include <QHBoxLayout>
+#include <QTreeView>
+#include <QHeaderView>
 #include <QCheckBox>
 #include <QDebug>
 #include <utility> // for std::asconst
@@ -15,26 +15,79 @@
 #include <QDialog>
 #include <QDialogButtonBox>
 #include <QLabel>
+#include <QLocale>
+#include <QRegularExpression>
+#include <QDBusConnection>
+#include <QDBusConnectionInterface>
+#include <QDBusMessage>
+#include <QDBusError>
+#include <QDBusArgument>
+#include <QDBusPendingCallWatcher>
+#include <QDBusPendingReply>
+
+namespace {
+const QString kConfigPath = "/etc/ada/tolitica/automount/manually_enabled.conf";
+
+// ada_mounter_helper's status and control interface
+const QString kMounterService = "org.xray.ada.MounterHelper";
+const QString kMounterPath = "/org/xray/ada/MounterHelper";
+const QString kMounterInterface = "org.xray.ada.MounterHelper";
+
+// Apply waits for the polkit prompt, so give the user time to type.
+const int kApplyTimeoutMs = 5 * 60 * 1000;
+
+// Idle timeout for drives newly switched to on-access mounting, so they can
+// spin down again.
+const int kDefaultIdleSeconds = 600;
+}
 
 drive_list_widget::drive_list_widget(QWidget *parent)
     : QWidget{parent}
 {
-    // Use a vertical layout that holds the QTreeWidget.
+    // Use a vertical layout that holds the tree view. Rows are plain model
+    // data; the delegate handles the checks and the options editor.
     QVBoxLayout *layout = new QVBoxLayout(this);
-    m_treeWidget = new QTreeWidget(this);
-    m_treeWidget->setColumnCount(3);
-    m_treeWidget->setHeaderLabels(QStringList() << "Device" << "Size" << "Action");
-    layout->addWidget(m_treeWidget);
+    m_model = new DriveInventoryModel(this);
+    m_treeView = new QTreeView(this);
+    m_treeView->setModel(m_model);
+    m_treeView->setItemDelegate(new DriveInventoryDelegate(m_treeView));
+    m_treeView->setUniformRowHeights(true);
+    m_treeView->setEditTriggers(QAbstractItemView::DoubleClicked | QAbstractItemView::SelectedClicked
+                                | QAbstractItemView::EditKeyPressed);
+    m_treeView->header()->setSectionResizeMode(QHeaderView::ResizeToContents);
+    m_treeView->header()->setStretchLastSection(true);
+    layout->addWidget(m_treeView);
     setLayout(layout);
 
+    connect(m_model, &DriveInventoryModel::edited, this, &drive_list_widget::selectionChanged);
+
+    m_enumerator = new BlockDeviceEnumerator(this);
+    connect(m_enumerator, &BlockDeviceEnumerator::snapshotReady, this, &drive_list_widget::showSnapshot);
+    // Plugged-in drives and their partitions show up without a rescan button.
+    m_enumerator->startMonitoring();
+
+    // Rows are updated in place, so only drives that just appeared get expanded.
+    connect(m_model, &QAbstractItemModel::rowsInserted, this, [this](const QModelIndex &parent, int first, int last) {
+        if (parent.isValid())
+            return;
+        for (int row = first; row <= last; row++)
+            m_treeView->expand(m_model->index(row, 0));
+    });
+
+    // Mount results are pushed by the daemon, so rows change as drives do.
+    QDBusConnection bus = QDBusConnection::systemBus();
+    bus.connect(kMounterService, kMounterPath, kMounterInterface, "MountChanged",
+                this, SLOT(onMountChanged(QString,QString)));
+    bus.connect(kMounterService, kMounterPath, kMounterInterface, "MountFailed",
+                this, SLOT(onMountFailed(QString,QString)));
+
     // Populate initially
     refresh();
 }
 
 QSet<QString> drive_list_widget::loadManuallyEnabledDevices() const {
     QSet<QString> enabledSet;
-    QString configPath = "/etc/ada/tolitica/automount/manually_enabled.conf";
-    QFile file(configPath);
+    QFile file(kConfigPath);
 
     if (file.open(QIODevice::ReadOnly | QIODevice::Text)) {
         QTextStream in(&file);
@@ -42,200 +95,193 @@ QSet<QString> drive_list_widget::loadManuallyEnabledDevices() const {
             QString line = in.readLine().trimmed();
             if (line.isEmpty() || line.startsWith("#"))
                 continue;
-            enabledSet.insert(line);
+            // The token is the first field; an options= profile may follow.
+            const QString token = line.split(QRegularExpression("\\s+")).first();
+            if (token.startsWith("UUID="))
+                enabledSet.insert(token);
         }
         file.close();
     }
     return enabledSet;
 }
 
+QHash<QString, QString> drive_list_widget::loadMountOptions() const {
+    QHash<QString, QString> options;
+    QFile file(kConfigPath);
+
+    if (file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        QTextStream in(&file);
+        while (!in.atEnd()) {
+            QString line = in.readLine().trimmed();
+            if (line.isEmpty() || line.startsWith("#"))
+                continue;
+            const QStringList fields = line.split(QRegularExpression("\\s+"), Qt::SkipEmptyParts);
+            for (int i = 1; i < fields.size(); i++) {
+                if (fields.at(i).startsWith("options="))
+                    options.insert(fields.first(), fields.at(i).mid(8));
+            }
+        }
+        file.close();
+    }
+    return options;
+}
+
+QHash<QString, int> drive_list_widget::loadOnAccess() const {
+    QHash<QString, int> onAccess;
+    QFile file(kConfigPath);
+
+    if (file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        QTextStream in(&file);
+        while (!in.atEnd()) {
+            QString line = in.readLine().trimmed();
+            if (line.isEmpty() || line.startsWith("#"))
+                continue;
+            const QStringList fields = line.split(QRegularExpression("\\s+"), Qt::SkipEmptyParts);
+            if (!fields.contains("onaccess"))
+                continue;
+            int idleSeconds = 0;
+            for (const QString &field : fields) {
+                if (field.startsWith("idle="))
+                    idleSeconds = field.mid(5).toInt();
+            }
+            onAccess.insert(fields.first(), idleSeconds);
+        }
+        file.close();
+    }
+    return onAccess;
+}
+
+QStringList drive_list_widget::loadConfigLines() const {
+    QStringList lines;
+    QFile file(kConfigPath);
+
+    if (file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        QTextStream in(&file);
+        while (!in.atEnd()) {
+            QString line = in.readLine().trimmed();
+            if (line.isEmpty() || line.startsWith("#"))
+                continue;
+            const QStringList fields = line.split(QRegularExpression("\\s+"), Qt::SkipEmptyParts);
+            // Written back verbatim, so only what the daemon can parse
+            if ((fields.first().startsWith("UUID=") || fields.first().startsWith("FSTYPE="))
+                && DriveInventoryModel::optionsPattern().match(fields.join(QString())).hasMatch())
+                lines.append(fields.join(' '));
+        }
+        file.close();
+    }
+    return lines;
+}
+
 void drive_list_widget::refresh() {
+    // The scan runs on a pool thread; showSnapshot() draws the result.
+    m_enumerator->enumerate();
+}
+
+void drive_list_widget::revertChanges() {
+    m_model->revert();
+    emit selectionChanged();
+    refresh();
+}
+
+void drive_list_widget::showSnapshot(QSharedPointer<const BlockDeviceSnapshot> snapshot) {
     // Load the current enabled device tokens from the configuration file.
     QSet<QString> enabledDevices = loadManuallyEnabledDevices();
+    const QHash<QString, QString> mountOptions = loadMountOptions();
+    const QHash<QString, int> onAccess = loadOnAccess();
 
-    // Block selection-change signals during refresh.
-    m_ignoreSelectionChanges = true;
-    m_treeWidget->clear();
-
-    // Run lsblk with JSON output including the UUID.
-    QProcess process;
-    process.start("lsblk", QStringList() << "--json"
-                                         << "--output" << "NAME,SIZE,TYPE,FSTYPE,MOUNTPOINT,LABEL,UUID");
-    process.waitForFinished();
+    // Fills in the mount choices of a row from the config.
+    auto configure = [&](DriveInventoryModel::Entry &entry) {
+        entry.mountable = true;
+        entry.mount = !entry.token.isEmpty() && enabledDevices.contains(entry.token);
+        entry.onAccess = onAccess.contains(entry.token);
+        entry.idleSeconds = onAccess.value(entry.token, kDefaultIdleSeconds);
+        entry.options = mountOptions.value(entry.token);
+    };
 
-    QByteArray output = process.readAllStandardOutput();
-    QJsonDocument jsonDoc = QJsonDocument::fromJson(output);
-    QJsonObject jsonObj = jsonDoc.object();
-    QJsonArray devicesArray = jsonObj.value("blockdevices").toArray();
+    QVector<DriveInventoryModel::Disk> disks;
 
     // Iterate over each disk.
-    for (const auto &value : std::as_const(devicesArray)) {
-        QJsonObject deviceObj = value.toObject();
-        QString type = deviceObj.value("type").toString();
-        if (type != "disk")
+    for (const BlockDevice &device : snapshot->devices) {
+        if (device.type != "disk")
             continue;
 
+        DriveInventoryModel::Disk disk;
+        disk.entry.device = device.path;
+        disk.entry.size = locale().formattedDataSize(device.size, 1, QLocale::DataSizeTraditionalFormat);
         // Extract the disk's UUID token.
-        QString diskUUID = deviceObj.value("uuid").toString().trimmed();
-        QString diskToken = diskUUID.isEmpty() ? "" : "UUID=" + diskUUID;
-
-        // Create the parent tree item.
-        QTreeWidgetItem *parentItem = new QTreeWidgetItem(m_treeWidget);
-        QString driveName = "/dev/" + deviceObj.value("name").toString();
-        QString driveSize = deviceObj.value("size").toString();
-        parentItem->setText(0, driveName);
-        parentItem->setText(1, driveSize);
-        // Store the UUID token in the item's UserRole.
-        parentItem->setData(0, Qt::UserRole, diskToken);
-
-        // Check if this disk is partitioned.
-        bool hasChildren = deviceObj.contains("children")
-                           && deviceObj.value("children").isArray();
-
-        if (!hasChildren) {
-            // For unpartitioned drives, add a parent checkbox.
-            QWidget *parentActionWidget = new QWidget();
-            QHBoxLayout *parentLayout = new QHBoxLayout(parentActionWidget);
-            parentLayout->setContentsMargins(0, 0, 0, 0);
-            QCheckBox *parentCheckBox = new QCheckBox("Mount Drive", parentActionWidget);
-
-            // Set checkbox state based on whether diskToken is in the config.
-            if (!diskToken.isEmpty() && enabledDevices.contains(diskToken))
-                parentCheckBox->setCheckState(Qt::Checked);
-            else
-                parentCheckBox->setCheckState(Qt::Unchecked);
-
-            // Store default state.
-            parentCheckBox->setProperty("defaultState", parentCheckBox->checkState());
-            parentLayout->addWidget(parentCheckBox);
-            parentActionWidget->setLayout(parentLayout);
-            m_treeWidget->setItemWidget(parentItem, 2, parentActionWidget);
-
-            // 🔵 CONNECT USING THE CORRECT SIGNAL 'stateChanged' WITH EXPLICIT CAPTURE AND PARAMETER
-            connect(parentCheckBox, &QCheckBox::stateChanged, this,
-                    [this, parentCheckBox](int state) {
-                        if (!m_ignoreSelectionChanges)
-                            emit selectionChanged();
-                    });
-        } else {
-            // For partitioned drives, leave the parent's widget empty.
-            QWidget *emptyWidget = new QWidget();
-            m_treeWidget->setItemWidget(parentItem, 2, emptyWidget);
-        }
+        disk.entry.token = device.uuid.isEmpty() ? "" : "UUID=" + device.uuid;
+
+        // Unpartitioned drives are mounted as a whole.
+        if (device.children.isEmpty())
+            configure(disk.entry);
 
         // Process children (partitions) if present.
-        if (hasChildren) {
-            QJsonArray partitionsArray = deviceObj.value("children").toArray();
-            for (const auto &childVal : std::as_const(partitionsArray)) {
-                QJsonObject partObj = childVal.toObject();
-                if (partObj.value("type").toString() != "part")
-                    continue;
-
-                // Retrieve partition properties.
-                QString fstype = partObj.value("fstype").toString().toLower();
-                QString partMount = partObj.value("mountpoint").toString();
-                QString label = partObj.value("label").toString().toLower();
-                QString sizeStr = partObj.value("size").toString().toLower();
-
-                // Extract partition UUID token.
-                QString partUUID = partObj.value("uuid").toString().trimmed();
-                QString partToken = partUUID.isEmpty() ? "" : "UUID=" + partUUID;
-
-                // Determine whether to hide this partition.
-                bool skip = false;
-                if (fstype == "swap" && !m_showSwap)
-                    skip = true;
-                if (!m_showBoot) {
-                    bool appearsBootlike = false;
-                    if (partMount == "/boot" || partMount == "/boot/efi")
-                        appearsBootlike = true;
-                    if (label.contains("boot") || label.contains("efi") || label.contains("esp"))
-                        appearsBootlike = true;
-                    bool isVfat = (fstype == "vfat" || fstype == "fat32");
-                    if (isVfat) {
-                        bool sizeSmall = false;
-                        if (sizeStr.endsWith("g")) {
-                            bool ok = false;
-                            double sizeVal = sizeStr.left(sizeStr.size() - 1).toDouble(&ok);
-                            if (ok && sizeVal < 3.0)
-                                sizeSmall = true;
-                        } else if (sizeStr.endsWith("m")) {
-                            bool ok = false;
-                            double sizeVal = sizeStr.left(sizeStr.size() - 1).toDouble(&ok);
-                            if (ok && sizeVal < 300.0)
-                                sizeSmall = true;
-                        }
-                        if (sizeSmall)
-                            appearsBootlike = true;
-                    }
-                    if (appearsBootlike)
-                        skip = true;
-                }
-                if (skip)
-                    continue;
-
-                // Create a child item for the partition.
-                QTreeWidgetItem *childItem = new QTreeWidgetItem(parentItem);
-                QString partitionName = "/dev/" + partObj.value("name").toString();
-                QString partitionSize = partObj.value("size").toString();
-                childItem->setText(0, partitionName);
-                childItem->setText(1, partitionSize);
-                // Store the partition's UUID token.
-                childItem->setData(0, Qt::UserRole, partToken);
-
-                // Create widget with a checkbox for the partition.
-                QWidget *childActionWidget = new QWidget();
-                QHBoxLayout *childLayout = new QHBoxLayout(childActionWidget);
-                childLayout->setContentsMargins(0, 0, 0, 0);
-                QCheckBox *childCheckBox = new QCheckBox("Mount Drive", childActionWidget);
-
-                // Set checkbox state based on whether partToken is in the config.
-                if (!partToken.isEmpty() && enabledDevices.contains(partToken))
-                    childCheckBox->setCheckState(Qt::Checked);
-                else
-                    childCheckBox->setCheckState(Qt::Unchecked);
-
-                // Save the default state.
-                childCheckBox->setProperty("defaultState", childCheckBox->checkState());
-
-                // Mark as dangerous if this partition is swap/boot-like.
-                bool isHarmful = (fstype == "swap" ||
-                                  partMount == "/boot" || partMount == "/boot/efi" ||
-                                  label.contains("boot") || label.contains("efi") || label.contains("esp"));
-                childCheckBox->setProperty("isDangerous", isHarmful);
-
-                childLayout->addWidget(childCheckBox);
-                childActionWidget->setLayout(childLayout);
-                m_treeWidget->setItemWidget(childItem, 2, childActionWidget);
-
-                // 🔵 CONNECT USING 'stateChanged(int)' FOR CHILD CHECKBOX WITH EXPLICIT CAPTURE
-                connect(childCheckBox, &QCheckBox::stateChanged, this,
-                        [this, childCheckBox](int state) {
-                            if (childCheckBox->property("isDangerous").toBool()) {
-                                QMessageBox::StandardButton reply =
-                                    QMessageBox::warning(this, "Warning",
-                                                         "Changing the state of this partition can be harmful to your system.\n"
-                                                         "Do you really want to continue?",
-                                                         QMessageBox::Yes | QMessageBox::No);
-
-                                if (reply == QMessageBox::No) {
-                                    childCheckBox->blockSignals(true);
-                                    int defState = childCheckBox->property("defaultState").toInt();
-                                    childCheckBox->setCheckState(static_cast<Qt::CheckState>(defState));
-                                    childCheckBox->blockSignals(false);
-                                    return;
-                                }
-                            }
-                            if (!m_ignoreSelectionChanges)
-                                emit selectionChanged();
-                        });
-            }
+        for (const BlockDevice &part : device.children) {
+            if (part.type != "part")
+                continue;
+
+            // Exact roles from the partition table; a /boot or ESP mount
+            // counts too, whatever the type says.
+            const bool swap = part.role == BlockDevice::SwapRole;
+            const bool boot = part.isBoot() || part.mountPoint == "/boot" || part.mountPoint == "/boot/efi";
+            const bool hidden = part.role == BlockDevice::MsrRole;
+            if ((swap && !m_showSwap) || (boot && !m_showBoot) || (hidden && !m_showHidden))
+                continue;
+
+            DriveInventoryModel::Entry partition;
+            partition.device = part.path;
+            partition.size = locale().formattedDataSize(part.size, 1, QLocale::DataSizeTraditionalFormat);
+            partition.token = part.uuid.isEmpty() ? "" : "UUID=" + part.uuid;
+            configure(partition);
+
+            // Mounting these elsewhere gets in the way of the system using them.
+            partition.dangerous = swap || boot || hidden;
+            disk.partitions.append(partition);
         }
+        disks.append(disk);
     }
-    // Re-enable selection signals once refresh is complete.
-    m_ignoreSelectionChanges = false;
+
+    // Only rows that differ from what is shown change; edits that were not
+    // applied yet stay. Lines of drives that aren't shown are kept.
+    m_model->setConfigLines(loadConfigLines());
+    m_model->update(disks);
+
+    requestMountStates();
+}
+
+///////////////////////////////////////////////////
+/// MOUNT STATE
+//////////////////////////////////////////////////
+void drive_list_widget::requestMountStates() {
+    QDBusConnection bus = QDBusConnection::systemBus();
+    QDBusMessage call = QDBusMessage::createMethodCall(kMounterService, kMounterPath,
+                                                      kMounterInterface, "ListManaged");
+    QDBusPendingCallWatcher *watcher = new QDBusPendingCallWatcher(bus.asyncCall(call), this);
+    connect(watcher, &QDBusPendingCallWatcher::finished, this, [this](QDBusPendingCallWatcher *watcher) {
+        watcher->deleteLater();
+        QDBusPendingReply<QVariantMap> reply = *watcher;
+        if (reply.isError()) {
+            qDebug() << "Mount states unavailable:" << reply.error().message();
+            return;
+        }
+
+        const QVariantMap states = reply.value();
+        for (auto it = states.cbegin(); it != states.cend(); ++it) {
+            const QVariantMap state = qdbus_cast<QVariantMap>(it.value());
+            const QString detail = state.value("state") == "failed" ? state.value("error").toString()
+                                                                      : state.value("mountPoint").toString();
+            m_model->setMountState(it.key(), state.value("state").toString(), detail);
+        }
+    });
 }
 
+void drive_list_widget::onMountChanged(const QString &uuid, const QString &state) {
+    m_model->setMountState(uuid, state, state == "mounted" ? "/mnt/" + uuid : QString());
+}
+
+void drive_list_widget::onMountFailed(const QString &uuid, const QString &error) {
+    m_model->setMountState(uuid, "failed", error);
+}
 
 void drive_list_widget::showAdditionalPartitionsDialog() {
     QDialog dialog(this);
@@ -262,128 +308,85 @@ void drive_list_widget::showAdditionalPartitionsDialog() {
         m_showSwap = swapCheckBox->isChecked();
         m_showBoot = bootCheckBox->isChecked();
         m_showHidden = hiddenCheckBox->isChecked();
-        refresh();
+        // The devices didn't change, only what is shown of them
+        if (m_enumerator->snapshot())
+            showSnapshot(m_enumerator->snapshot());
+        else
+            refresh();
     }
 }
 
-// Helper: returns true if any checkbox (parent or child) differs from its default state.
+// Both only look at the rows that were edited.
 bool drive_list_widget::isModified() const {
-    for (int i = 0; i < m_treeWidget->topLevelItemCount(); i++) {
-        QTreeWidgetItem *item = m_treeWidget->topLevelItem(i);
-        QWidget *w = m_treeWidget->itemWidget(item, 2);
-        if (w) {
-            QCheckBox *cb = w->findChild<QCheckBox*>();
-            if (cb) {
-                if (cb->checkState() != cb->property("defaultState").toInt())
-                    return true;
-            }
-        }
-        // Check children.
-        for (int j = 0; j < item->childCount(); j++) {
-            QWidget *cw = m_treeWidget->itemWidget(item->child(j), 2);
-            if (cw) {
-                QCheckBox *cb = cw->findChild<QCheckBox*>();
-                if (cb) {
-                    if (cb->checkState() != cb->property("defaultState").toInt())
-                        return true;
-                }
-            }
-        }
-    }
-    return false;
+    return m_model->isModified();
 }
 
 bool drive_list_widget::isDangerousModified() const {
-    for (int i = 0; i < m_treeWidget->topLevelItemCount(); i++) {
-        QTreeWidgetItem *item = m_treeWidget->topLevelItem(i);
-        QWidget *w = m_treeWidget->itemWidget(item, 2);
-        if (w) {
-            QCheckBox *cb = w->findChild<QCheckBox*>();
-            if (cb && cb->property("isDangerous").toBool()) {
-                if (cb->checkState() != cb->property("defaultState").toInt())
-                    return true;
-            }
-        }
-        for (int j = 0; j < item->childCount(); j++) {
-            QWidget *cw = m_treeWidget->itemWidget(item->child(j), 2);
-            if (cw) {
-                QCheckBox *cb = cw->findChild<QCheckBox*>();
-                if (cb && cb->property("isDangerous").toBool()) {
-                    if (cb->checkState() != cb->property("defaultState").toInt())
-                        return true;
-                }
-            }
-        }
-    }
-    return false;
+    return m_model->isDangerousModified();
 }
 
-bool drive_list_widget::applyMountSelection() {
-    QString configPath = "/etc/ada/tolitica/automount/manually_enabled.conf";
-
+void drive_list_widget::applyMountSelection() {
     // Reset cancellation flag at the beginning.
     m_operationCancelled = false;
 
-    // Build a string containing the new configuration content.
-    QStringList enabledTokens;
-    for (int i = 0; i < m_treeWidget->topLevelItemCount(); i++) {
-        QTreeWidgetItem *parentItem = m_treeWidget->topLevelItem(i);
-        QWidget *parentWidget = m_treeWidget->itemWidget(parentItem, 2);
-        QCheckBox *parentCheckBox = parentWidget ? parentWidget->findChild<QCheckBox*>() : nullptr;
-
-        if (parentCheckBox && parentItem->childCount() == 0) {
-            QString token = parentItem->data(0, Qt::UserRole).toString();
-            if (parentCheckBox->isChecked() && !token.isEmpty())
-                enabledTokens.append(token);
-        } else if (parentItem->childCount() > 0) {
-            for (int j = 0; j < parentItem->childCount(); j++) {
-                QTreeWidgetItem *childItem = parentItem->child(j);
-                QWidget *childWidget = m_treeWidget->itemWidget(childItem, 2);
-                QCheckBox *childCheckBox = childWidget ? childWidget->findChild<QCheckBox*>() : nullptr;
-                if (childCheckBox) {
-                    QString token = childItem->data(0, Qt::UserRole).toString();
-                    if (childCheckBox->isChecked() && !token.isEmpty())
-                        enabledTokens.append(token);
+    // Build a string containing the new configuration content. Per-filesystem
+    // profiles and drives without a row are kept as they were.
+    const QStringList enabledTokens = m_model->configLines();
+
+    // The daemon writes the config itself and reports the result through
+    // MountChanged / MountFailed, so nothing needs to be re-read afterwards.
+    // The reply waits for the polkit prompt; the window stays responsive.
+    QDBusConnection bus = QDBusConnection::systemBus();
+    if (bus.interface() && bus.interface()->isServiceRegistered(kMounterService).value()) {
+        QDBusMessage call = QDBusMessage::createMethodCall(kMounterService, kMounterPath,
+                                                          kMounterInterface, "Apply");
+        call << enabledTokens;
+        QDBusPendingCallWatcher *watcher = new QDBusPendingCallWatcher(bus.asyncCall(call, kApplyTimeoutMs), this);
+        connect(watcher, &QDBusPendingCallWatcher::finished, this, [this](QDBusPendingCallWatcher *watcher) {
+            watcher->deleteLater();
+            const QDBusPendingReply<> reply = *watcher;
+            if (reply.isError()) {
+                // A dismissed or failed polkit prompt
+                if (reply.error().type() == QDBusError::AccessDenied) {
+                    m_operationCancelled = true;
+                    emit applyFinished(true);
+                    return;
                 }
+                qWarning() << "Applying the mount selection failed:" << reply.error().message();
+                emit applyFinished(false);
+                return;
             }
-        }
+            m_model->markApplied();
+            emit applyFinished(true);
+        });
+        return;
     }
 
-    // Construct the shell command to write the data.
-    QString command = "echo '# list of enabled automount partitions' | pkexec tee " + configPath;
-    for (const QString &token : enabledTokens) {
-        command += " && echo '" + token + "' | pkexec tee -a " + configPath;
-    }
-    command += " && pkexec touch " + configPath; // Force the system to update timestamp.
-
-    // Run the command using QProcess.
-    QProcess process;
-    process.start("bash", QStringList() << "-c" << command);
-    process.waitForFinished();
-
-    // Retrieve and trim standard error output to check for cancellation.
-    QString errorOutput = process.readAllStandardError().trimmed();
-
-    // (Optional) Debug output:
-    // qDebug() << "applyMountSelection errorOutput:" << errorOutput << "exitCode:" << process.exitCode();
-
-    // Check for success.
-    if (process.exitCode() != 0) {
-        // If errorOutput is empty, unusually short, contains cancellation text, or the exit code is 126,
-        // assume a cancel occurred—and do not warn.
-        if (errorOutput.isEmpty() ||
-            errorOutput.length() < 15 ||
-            errorOutput.contains("cancel", Qt::CaseInsensitive) ||
-            errorOutput.contains("canceled", Qt::CaseInsensitive) ||
-            errorOutput.contains("Authentication canceled", Qt::CaseInsensitive) ||
-            process.exitCode() == 126) {
+    emit applyFinished(writeConfig(enabledTokens));
+}
+
+// Daemon not on the bus: tolitica-helper writes the whole file in one step,
+// replacing it atomically, and the daemon picks it up when it runs.
+bool drive_list_widget::writeConfig(const QStringList &lines) {
+    const QString &configPath = kConfigPath;
+
+    QByteArray content = "# list of enabled automount partitions\n";
+    for (const QString &line : lines)
+        content += line.toUtf8() + '\n';
+
+    QString output;
+    if (!PrivilegedHelper::run("automount", {PrivilegedHelper::writeStep(configPath, content)}, &output)) {
+        // A dismissed prompt, from polkit through the helper or from pkexec
+        if (output.contains("Not authorized", Qt::CaseInsensitive)
+            || output.contains("dismissed", Qt::CaseInsensitive)) {
             m_operationCancelled = true;
-            return true; // Treat cancellation as non-error.
+            return true;
         }
-        // Instead of issuing a warning, we silently return false.
+        qWarning() << "Writing" << configPath << "failed:" << output;
         return false;
     }
 
+    m_model->markApplied();
     return true;
 }
 
@@ -2,7 +2,15 @@
 #define DRIVE_LIST_WIDGET_H
 
 #include <QWidget>
-#include <QTreeWidget>
+#include <QHash>
+#include <QSet>
+#include <QSharedPointer>
+#include <QStringList>
+
+class QTreeView;
+class DriveInventoryModel;
+class BlockDeviceEnumerator;
+struct BlockDeviceSnapshot;
 
 class drive_list_widget : public QWidget
 {
@@ -10,12 +18,17 @@ class drive_list_widget : public QWidget
 public:
     explicit drive_list_widget(QWidget *parent = nullptr);
 
-    // Public method to refresh the drive list.
+    // Public method to refresh the drive list. Devices are enumerated in the
+    // background; rows are updated once the scan is done.
     void refresh();
 
+    // Drops the edits that were not applied and rescans, e.g. after a
+    // cancelled or failed apply.
+    void revertChanges();
+
     // Goes through all items, writes the new config files, and calls the mount/unmount helper.
-    // Returns true on sucess.
-    bool applyMountSelection();
+    // The outcome is reported through applyFinished() once the polkit prompt was answered.
+    void applyMountSelection();
     bool operationCancelled() const { return m_operationCancelled; }
 
     // Opens a dialog to let the user choose additional partitions to show.
@@ -24,7 +37,7 @@ public:
     bool hasDangerousChange() const {return m_dangerousChange;}
     void resetDangerousChange() { m_dangerousChange = false; }
 
-    // Checks if any checkbox has been modified relative to its default state.
+    // Checks if any row has been edited relative to the config.
     bool isModified() const;
     bool isDangerousModified() const;
 
@@ -32,19 +45,45 @@ public:
     // tokens (ignoring empty lines or comments).
     QSet<QString> loadManuallyEnabledDevices() const;
 
+    // Mount option profiles from the same file, keyed by their token
+    // ("UUID=<uuid>" or "FSTYPE=<type>"); see ada_mounter_helper's MountOptions.
+    QHash<QString, QString> loadMountOptions() const;
+
+    // UUID tokens marked "onaccess", with their idle timeout in seconds (0 for none).
+    QHash<QString, int> loadOnAccess() const;
+
+    // Every UUID= and FSTYPE= line with its fields, single spaced.
+    QStringList loadConfigLines() const;
+
 signals:
-    // Emitted whenever a checkbox (drive or partition) is toggled.
+    // Emitted whenever a row (drive or partition) is edited.
     void selectionChanged();
+    // Result of applyMountSelection(); true on success or when cancelled
+    // (see operationCancelled()).
+    void applyFinished(bool ok);
+
+private slots:
+    void showSnapshot(QSharedPointer<const BlockDeviceSnapshot> snapshot);
+
+    // Pushed by ada_mounter_helper over the system bus.
+    void onMountChanged(const QString &uuid, const QString &state);
+    void onMountFailed(const QString &uuid, const QString &error);
 
 private:
-    QTreeWidget *m_treeWidget;
+    // Asks the daemon for the state of every managed partition.
+    void requestMountStates();
+    // Fallback for applyMountSelection() without the daemon.
+    bool writeConfig(const QStringList &lines);
+
+    QTreeView *m_treeView;
+    DriveInventoryModel *m_model;
+    BlockDeviceEnumerator *m_enumerator;
 
     // User options to display additional partitions
     bool m_showSwap = false; // By default we hide swap partitions.
     bool m_showBoot = false; // By default we hide bbot partitions.
     bool m_showHidden = false; // By default we hide hidden partitions.
 
-    bool m_ignoreSelectionChanges = false;
     bool m_dangerousChange = false;
 
     // Operation canceled don't return error
@@ -1,50 +1,26 @@
-// This is added for detection logic to work
-#include <QFile>
-#include <QTextStream>
-#include <QProcess>
-#include <QDir>
-
 // Usual
 #include "widget.h"
 #include "widgetInitial.h"
+#include "system_facts.h"
 #include <QApplication>
 
 int main(int argc, char *argv[])
 {
-    bool shouldShowInitialSetup = false;
+    QApplication a(argc, argv);
 
-    // Check if it's live environment
-    QProcess process;
-    process.start("bash", QStringList() <<
-        "-c" << "grep -q '/cow' /proc/mounts || [ -f /run/live/medium ]");
-    process.waitForFinished();
-    bool isLiveEnv = (process.exitCode() == 0);
+    // Gather live env, tolitica.conf, os-release, grub, kdeglobals,
+    // konsolerc and shell state in parallel before the first window is built
+    SystemFacts::gather();
+    QSharedPointer<const SystemFacts> facts = SystemFacts::snapshot();
+
+    bool isLiveEnv = facts->isLiveEnv();
     QString word = "tolitica";
 
     // Check tolitica.conf for initialization value
-    QString homeDir = QDir::homePath();
-    QFile configFile(homeDir + "/tolitica-home-settings/tolitica.conf");
-    bool initialSetupIs0 = false;
-
-    if (configFile.open(QIODevice::ReadOnly | QIODevice::Text)) {
-        QTextStream in(&configFile);
-        while (!in.atEnd()) {
-            QString line = in.readLine().trimmed();
-            if (line.startsWith("initialSetup") && line.contains("=")) {
-                QString value = line.split("=")[1].trimmed();
-                if (value == "0") {
-                    initialSetupIs0 = true;
-                    break;
-                }
-            }
-        }
-        configFile.close();
-    }
+    bool initialSetupIs0 = facts->initialSetupPending();
 
     // Determine which widget to show
-    shouldShowInitialSetup = (!isLiveEnv && word == "tolitica" && initialSetupIs0);
-
-    QApplication a(argc, argv);
+    bool shouldShowInitialSetup = (!isLiveEnv && word == "tolitica" && initialSetupIs0);
 
     // Create appropriate widget
     if (shouldShowInitialSetup) {
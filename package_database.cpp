@@ -0,0 +1,211 @@
+#include "package_database.h"
+
+#include <QFileInfo>
+#include <QDateTime>
+#include <QMutexLocker>
+#include <QSet>
+#include <QDebug>
+
+#include <alpm.h>
+
+namespace {
+const char *const kRootDir = "/";
+const char *const kDbPath = "/var/lib/pacman/";
+const char *const kLocalDbDir = "/var/lib/pacman/local";
+
+// pacman adds/removes a directory under local/ for every package change,
+// so the directory's mtime is a cheap way to know our cache went stale.
+qint64 localDbStamp() {
+    QFileInfo info(kLocalDbDir);
+    return info.exists() ? info.lastModified().toMSecsSinceEpoch() : -1;
+}
+}
+
+PackageDatabase &PackageDatabase::instance() {
+    static PackageDatabase db;
+    return db;
+}
+
+PackageDatabase::~PackageDatabase() {
+    if (m_handle) {
+        alpm_release(m_handle);
+    }
+}
+
+bool PackageDatabase::ensureOpen() {
+    const qint64 stamp = localDbStamp();
+    if (m_handle && stamp == m_localDbStamp) {
+        return true;
+    }
+
+    if (m_handle) {
+        alpm_release(m_handle);
+        m_handle = nullptr;
+    }
+
+    alpm_errno_t err;
+    m_handle = alpm_initialize(kRootDir, kDbPath, &err);
+    if (!m_handle) {
+        qWarning() << "Failed to open the pacman database:" << alpm_strerror(err);
+        return false;
+    }
+    m_localDbStamp = stamp;
+    return true;
+}
+
+void PackageDatabase::reload() {
+    QMutexLocker locker(&m_mutex);
+    if (m_handle) {
+        alpm_release(m_handle);
+        m_handle = nullptr;
+    }
+    m_localDbStamp = -1;
+}
+
+bool PackageDatabase::isInstalled(const QString &name) {
+    return reason(name) != Reason::NotInstalled;
+}
+
+QString PackageDatabase::version(const QString &name) {
+    QMutexLocker locker(&m_mutex);
+    if (!ensureOpen()) {
+        return QString();
+    }
+
+    alpm_pkg_t *pkg = alpm_db_get_pkg(alpm_get_localdb(m_handle), name.toUtf8().constData());
+    return pkg ? QString::fromUtf8(alpm_pkg_get_version(pkg)) : QString();
+}
+
+PackageDatabase::Reason PackageDatabase::reason(const QString &name) {
+    QMutexLocker locker(&m_mutex);
+    if (!ensureOpen()) {
+        return Reason::NotInstalled;
+    }
+
+    alpm_pkg_t *pkg = alpm_db_get_pkg(alpm_get_localdb(m_handle), name.toUtf8().constData());
+    if (!pkg) {
+        return Reason::NotInstalled;
+    }
+    return alpm_pkg_get_reason(pkg) == ALPM_PKG_REASON_EXPLICIT ? Reason::Explicit
+                                                               : Reason::Dependency;
+}
+
+QHash<QString, bool> PackageDatabase::installed(const QStringList &names) {
+    QHash<QString, bool> result;
+    result.reserve(names.size());
+
+    QMutexLocker locker(&m_mutex);
+    if (!ensureOpen()) {
+        for (const QString &name : names) {
+            result.insert(name, false);
+        }
+        return result;
+    }
+
+    alpm_db_t *localDb = alpm_get_localdb(m_handle);
+    for (const QString &name : names) {
+        result.insert(name, alpm_db_get_pkg(localDb, name.toUtf8().constData()) != nullptr);
+    }
+    return result;
+}
+
+bool PackageDatabase::allInstalled(const QStringList &names) {
+    const QHash<QString, bool> found = installed(names);
+    for (auto it = found.cbegin(); it != found.cend(); ++it) {
+        if (!it.value()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+QStringList PackageDatabase::orphans() {
+    QStringList result;
+
+    QMutexLocker locker(&m_mutex);
+    if (!ensureOpen()) {
+        return result;
+    }
+
+    for (alpm_list_t *i = alpm_db_get_pkgcache(alpm_get_localdb(m_handle)); i; i = alpm_list_next(i)) {
+        alpm_pkg_t *pkg = static_cast<alpm_pkg_t *>(i->data);
+        if (alpm_pkg_get_reason(pkg) != ALPM_PKG_REASON_DEPEND) {
+            continue;
+        }
+
+        alpm_list_t *requiredBy = alpm_pkg_compute_requiredby(pkg);
+        alpm_list_t *optionalFor = alpm_pkg_compute_optionalfor(pkg);
+        if (!requiredBy && !optionalFor) {
+            result << QString::fromUtf8(alpm_pkg_get_name(pkg));
+        }
+        FREELIST(requiredBy);
+        FREELIST(optionalFor);
+    }
+    return result;
+}
+
+QStringList PackageDatabase::removalPlan(const QString &metaPackage) {
+    QStringList plan;
+
+    QMutexLocker locker(&m_mutex);
+    if (!ensureOpen()) {
+        return plan;
+    }
+
+    alpm_db_t *localDb = alpm_get_localdb(m_handle);
+    if (!alpm_db_get_pkg(localDb, metaPackage.toUtf8().constData())) {
+        return plan;
+    }
+
+    // Who needs each dependency-installed package, computed once up front.
+    QHash<QString, QStringList> neededBy;
+    for (alpm_list_t *i = alpm_db_get_pkgcache(localDb); i; i = alpm_list_next(i)) {
+        alpm_pkg_t *pkg = static_cast<alpm_pkg_t *>(i->data);
+        if (alpm_pkg_get_reason(pkg) != ALPM_PKG_REASON_DEPEND) {
+            continue;
+        }
+
+        QStringList users;
+        alpm_list_t *requiredBy = alpm_pkg_compute_requiredby(pkg);
+        alpm_list_t *optionalFor = alpm_pkg_compute_optionalfor(pkg);
+        for (alpm_list_t *j = requiredBy; j; j = alpm_list_next(j)) {
+            users << QString::fromUtf8(static_cast<const char *>(j->data));
+        }
+        for (alpm_list_t *j = optionalFor; j; j = alpm_list_next(j)) {
+            users << QString::fromUtf8(static_cast<const char *>(j->data));
+        }
+        FREELIST(requiredBy);
+        FREELIST(optionalFor);
+
+        neededBy.insert(QString::fromUtf8(alpm_pkg_get_name(pkg)), users);
+    }
+
+    // Grow the set until no more packages fall out of use.
+    QSet<QString> removing;
+    removing.insert(metaPackage);
+    plan << metaPackage;
+
+    bool grew = true;
+    while (grew) {
+        grew = false;
+        for (auto it = neededBy.cbegin(); it != neededBy.cend(); ++it) {
+            if (removing.contains(it.key())) {
+                continue;
+            }
+
+            bool stillNeeded = false;
+            for (const QString &user : it.value()) {
+                if (!removing.contains(user)) {
+                    stillNeeded = true;
+                    break;
+                }
+            }
+            if (!stillNeeded) {
+                removing.insert(it.key());
+                plan << it.key();
+                grew = true;
+            }
+        }
+    }
+    return plan;
+}
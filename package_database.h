@@ -0,0 +1,64 @@
+#ifndef PACKAGE_DATABASE_H
+#define PACKAGE_DATABASE_H
+
+#include <QString>
+#include <QStringList>
+#include <QHash>
+#include <QMutex>
+
+typedef struct _alpm_handle_t alpm_handle_t;
+
+// In-process view of the local pacman database (/var/lib/pacman/local).
+// Replaces the `pacman -Q <pkg>` spawns every status check used to do:
+// the database is opened once through libalpm and every query is answered
+// from its in-memory package cache.
+class PackageDatabase
+{
+public:
+    enum class Reason {
+        NotInstalled,
+        Explicit,
+        Dependency
+    };
+
+    // Shared instance used by Widget, Widget_Initial, CoreInitial and CoreFunctions.
+    static PackageDatabase &instance();
+
+    // Single package queries (equivalent to `pacman -Q <name>`).
+    bool isInstalled(const QString &name);
+    QString version(const QString &name);
+    Reason reason(const QString &name);
+
+    // Batched lookups, answered under a single lock.
+    QHash<QString, bool> installed(const QStringList &names);
+    bool allInstalled(const QStringList &names);
+
+    // Dependencies nothing requires anymore (equivalent to `pacman -Qtdq`).
+    QStringList orphans();
+
+    // Everything removing metaPackage should take with it: the package, the
+    // dependencies nothing else needs once it is gone, and the orphans left
+    // behind (`pacman -Rs` followed by `pacman -Rns $(pacman -Qtdq)`).
+    // Explicitly installed packages are never included. Empty when
+    // metaPackage isn't installed.
+    QStringList removalPlan(const QString &metaPackage);
+
+    // Drops the cached handle so the next query re-reads the database.
+    void reload();
+
+private:
+    PackageDatabase() = default;
+    ~PackageDatabase();
+    PackageDatabase(const PackageDatabase &) = delete;
+    PackageDatabase &operator=(const PackageDatabase &) = delete;
+
+    // Opens the handle on first use and re-opens it whenever pacman changed the
+    // local database behind our back. Must be called with m_mutex held.
+    bool ensureOpen();
+
+    QMutex m_mutex;
+    alpm_handle_t *m_handle = nullptr;
+    qint64 m_localDbStamp = -1;
+};
+
+#endif // PACKAGE_DATABASE_H
@@ -0,0 +1,93 @@
+#ifndef POLKIT_AUTHORITY_H
+#define POLKIT_AUTHORITY_H
+
+#include <QString>
+#include <QVariantMap>
+#include <QMap>
+#include <QMetaType>
+#include <QDBusArgument>
+#include <QDBusMessage>
+#include <QDBusMetaType>
+
+// polkit's (sa{sv}) subject
+struct PolkitSubject {
+    QString kind;
+    QVariantMap details;
+};
+
+Q_DECLARE_METATYPE(PolkitSubject)
+
+inline QDBusArgument &operator<<(QDBusArgument &argument, const PolkitSubject &subject) {
+    argument.beginStructure();
+    argument << subject.kind << subject.details;
+    argument.endStructure();
+    return argument;
+}
+
+inline const QDBusArgument &operator>>(const QDBusArgument &argument, PolkitSubject &subject) {
+    argument.beginStructure();
+    argument >> subject.kind >> subject.details;
+    argument.endStructure();
+    return argument;
+}
+
+// CheckAuthorization against org.freedesktop.PolicyKit1, shared by the
+// system bus services (tolitica-helper, ada_mounter_helper). The caller
+// sends the message built here, blocking or not, and hands the reply back.
+class PolkitAuthority
+{
+public:
+    // The subject and the a{ss} details aren't known to QtDBus by default;
+    // call once before the first check.
+    static void registerTypes() {
+        qDBusRegisterMetaType<PolkitSubject>();
+        qDBusRegisterMetaType<QMap<QString, QString>>();
+    }
+
+    // Checks actionId for the client behind busName (its unique name).
+    // flags 0x1: AllowUserInteraction, so the session's agent prompts.
+    static QDBusMessage checkAuthorization(const QString &busName, const QString &actionId) {
+        PolkitSubject subject;
+        subject.kind = "system-bus-name";
+        subject.details.insert("name", busName);
+
+        QDBusMessage check = QDBusMessage::createMethodCall(
+            "org.freedesktop.PolicyKit1", "/org/freedesktop/PolicyKit1/Authority",
+            "org.freedesktop.PolicyKit1.Authority", "CheckAuthorization");
+        check << QVariant::fromValue(subject) << actionId
+              << QVariant::fromValue(QMap<QString, QString>()) << uint(1) << QString();
+        return check;
+    }
+
+    // Whether reply grants the action. On false, error says why and denied
+    // tells a refusal (or dismissed prompt) from a check that didn't work.
+    static bool isAuthorized(const QDBusMessage &reply, const QString &actionId, QString *error,
+                             bool *denied = nullptr) {
+        if (denied) {
+            *denied = false;
+        }
+        if (reply.type() != QDBusMessage::ReplyMessage || reply.arguments().isEmpty()) {
+            *error = "Authorization check failed: " + reply.errorMessage();
+            return false;
+        }
+
+        // (bba{ss}): is_authorized, is_challenge, details
+        bool isAuthorized = false;
+        bool isChallenge = false;
+        QMap<QString, QString> details;
+        const QDBusArgument result = reply.arguments().at(0).value<QDBusArgument>();
+        result.beginStructure();
+        result >> isAuthorized >> isChallenge >> details;
+        result.endStructure();
+
+        if (!isAuthorized) {
+            *error = "Not authorized for " + actionId;
+            if (denied) {
+                *denied = true;
+            }
+        }
+        return isAuthorized;
+    }
+};
+
+#endif // POLKIT_AUTHORITY_H
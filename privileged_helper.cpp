@@ -0,0 +1,270 @@
+#include "privileged_helper.h"
+
+#include <QDBusConnection>
+#include <QDBusMessage>
+#include <QDBusPendingCall>
+#include <QDBusPendingCallWatcher>
+#include <QDBusPendingReply>
+#include <QDBusError>
+#include <QEventLoop>
+#include <QProcess>
+#include <QFile>
+#include <QSharedPointer>
+#include <QDebug>
+
+#include <climits>
+
+namespace {
+const char *const kService = "org.xray.tolitica.Helper";
+const char *const kPath = "/org/xray/tolitica/Helper";
+const char *const kInterface = "org.xray.tolitica.Helper";
+
+// Package transactions can run for a long time; INT_MAX disables the
+// D-Bus reply timeout.
+const int kExecuteTimeoutMs = INT_MAX;
+
+QString shellQuote(const QString &value) {
+    QString quoted = value;
+    quoted.replace('\'', "'\\''");
+    return "'" + quoted + "'";
+}
+}
+
+PrivilegedHelper::PrivilegedHelper(QObject *parent)
+    : QObject(parent)
+{}
+
+///////////////////////////////////////////////////
+/// STEPS
+//////////////////////////////////////////////////
+QVariantMap PrivilegedHelper::runStep(const QString &program, const QStringList &arguments) {
+    return {{"op", "run"}, {"program", program}, {"arguments", arguments}};
+}
+
+QVariantMap PrivilegedHelper::writeStep(const QString &path, const QByteArray &content) {
+    return {{"op", "write"}, {"path", path}, {"content", content}};
+}
+
+QVariantMap PrivilegedHelper::copyStep(const QString &source, const QString &target) {
+    return {{"op", "copy"}, {"path", source}, {"target", target}};
+}
+
+QVariantMap PrivilegedHelper::makeDirStep(const QString &path) {
+    return {{"op", "mkdir"}, {"path", path}};
+}
+
+QVariantMap PrivilegedHelper::removeStep(const QString &path) {
+    return {{"op", "remove"}, {"path", path}};
+}
+
+QVariantMap PrivilegedHelper::replaceTextStep(const QString &path, const QString &from, const QString &to) {
+    return {{"op", "replaceText"}, {"path", path}, {"from", from}, {"to", to}};
+}
+
+QVariantMap PrivilegedHelper::setKeyStep(const QString &path, const QString &key, const QString &value) {
+    return {{"op", "setKey"}, {"path", path}, {"key", key}, {"value", value}};
+}
+
+QVariantMap PrivilegedHelper::removeOrphansStep() {
+    return {{"op", "removeOrphans"}};
+}
+
+QVariantMap PrivilegedHelper::removePackagesStep(const QStringList &packages) {
+    return {{"op", "removePackages"}, {"packages", packages}};
+}
+
+///////////////////////////////////////////////////
+/// HELPER
+//////////////////////////////////////////////////
+void PrivilegedHelper::start(const QString &capability, const QList<QVariantMap> &steps) {
+    QDBusConnection bus = QDBusConnection::systemBus();
+
+    if (!m_connected) {
+        bus.connect(kService, kPath, kInterface, "StepStarted",
+                    this, SLOT(onHelperStepStarted(QString,uint,uint)));
+        m_connected = true;
+    }
+
+    QVariantList batch;
+    for (const QVariantMap &step : steps) {
+        batch << step;
+    }
+
+    QDBusMessage call = QDBusMessage::createMethodCall(kService, kPath, kInterface, "Execute");
+    call << capability << QVariant(batch);
+
+    QDBusPendingCallWatcher *watcher =
+        new QDBusPendingCallWatcher(bus.asyncCall(call, kExecuteTimeoutMs), this);
+    connect(watcher, &QDBusPendingCallWatcher::finished, this,
+            [this, watcher, steps](QDBusPendingCallWatcher *) {
+        QDBusPendingReply<QString> reply = *watcher;
+        watcher->deleteLater();
+
+        if (!reply.isError()) {
+            emit finished(true, reply.value());
+            return;
+        }
+
+        const QDBusError::ErrorType type = reply.error().type();
+        if (type == QDBusError::ServiceUnknown || type == QDBusError::NameHasNoOwner) {
+            qDebug() << "tolitica-helper unavailable, falling back to pkexec";
+            startFallback(steps);
+            return;
+        }
+        emit finished(false, reply.error().message());
+    });
+}
+
+void PrivilegedHelper::onHelperStepStarted(const QString &client, uint index, uint total) {
+    // The signal goes to every listener; only follow our own batch
+    if (client == QDBusConnection::systemBus().baseService()) {
+        emit stepStarted(int(index), int(total));
+    }
+}
+
+bool PrivilegedHelper::run(const QString &capability, const QList<QVariantMap> &steps,
+                           QString *output) {
+    PrivilegedHelper helper;
+    QEventLoop loop;
+    bool success = false;
+
+    connect(&helper, &PrivilegedHelper::finished, &loop,
+            [&](bool ok, const QString &result) {
+        success = ok;
+        if (output) {
+            *output = result;
+        }
+        loop.quit();
+    });
+
+    helper.start(capability, steps);
+    loop.exec();
+    return success;
+}
+
+///////////////////////////////////////////////////
+/// PKEXEC FALLBACK
+//////////////////////////////////////////////////
+QString PrivilegedHelper::fallbackScript(const QList<QVariantMap> &steps, QString *error) {
+    QStringList script;
+    script << "set -e";
+
+    for (int i = 0; i < steps.size(); ++i) {
+        const QVariantMap &step = steps.at(i);
+        const QString op = step.value("op").toString();
+        const QString path = shellQuote(step.value("path").toString());
+
+        // Progress markers, parsed back out of stdout
+        script << QString("echo '::step %1 %2'").arg(i).arg(steps.size());
+
+        if (op == "run") {
+            QStringList command;
+            command << shellQuote(step.value("program").toString());
+            for (const QString &argument : step.value("arguments").toStringList()) {
+                command << shellQuote(argument);
+            }
+            script << command.join(' ');
+        } else if (op == "removePackages") {
+            QStringList command;
+            command << "pacman" << "-Rn" << "--noconfirm";
+            for (const QString &package : step.value("packages").toStringList()) {
+                command << shellQuote(package);
+            }
+            script << command.join(' ');
+        } else if (op == "removeOrphans") {
+            script << "orphans=$(pacman -Qtdq || true)"
+                   << "[ -z \"$orphans\" ] || pacman -Rns --noconfirm $orphans";
+        } else if (op == "write" || op == "replaceText" || op == "setKey") {
+            // Edits are applied here on a readable copy, then written whole
+            QByteArray content = step.value("content").toByteArray();
+            if (op != "write") {
+                QFile file(step.value("path").toString());
+                if (!file.open(QIODevice::ReadOnly)) {
+                    *error = "Cannot read " + file.fileName();
+                    return QString();
+                }
+                QString text = QString::fromUtf8(file.readAll());
+                if (op == "replaceText") {
+                    text.replace(step.value("from").toString(), step.value("to").toString());
+                } else {
+                    const QString prefix = step.value("key").toString() + "=";
+                    QStringList lines = text.split('\n');
+                    for (QString &line : lines) {
+                        if (line.startsWith(prefix)) {
+                            line = prefix + step.value("value").toString();
+                        }
+                    }
+                    text = lines.join('\n');
+                }
+                content = text.toUtf8();
+            }
+            // Synced before the rename, like the helper's QSaveFile
+            script << QString("printf '%s' %1 > %2.tolitica-new")
+                          .arg(shellQuote(QString::fromUtf8(content)), path)
+                   << QString("sync %1.tolitica-new").arg(path)
+                   << QString("mv -f %1.tolitica-new %1").arg(path);
+        } else if (op == "copy") {
+            script << QString("cp -f %1 %2").arg(path, shellQuote(step.value("target").toString()));
+        } else if (op == "mkdir") {
+            script << "mkdir -p " + path;
+        } else if (op == "remove") {
+            script << "rm -f " + path;
+        } else {
+            *error = "Unknown step: " + op;
+            return QString();
+        }
+    }
+    return script.join('\n') + '\n';
+}
+
+void PrivilegedHelper::startFallback(const QList<QVariantMap> &steps) {
+    QString error;
+    const QString script = fallbackScript(steps, &error);
+    if (script.isEmpty()) {
+        emit finished(false, error);
+        return;
+    }
+
+    m_fallback = new QProcess(this);
+    m_fallback->setProcessChannelMode(QProcess::MergedChannels);
+
+    // Shared by the handlers below, freed with the last of them
+    QSharedPointer<QString> collected(new QString);
+    connect(m_fallback, &QProcess::readyReadStandardOutput, this, [this, collected]() {
+        while (m_fallback->canReadLine()) {
+            const QString line = QString::fromLocal8Bit(m_fallback->readLine());
+            if (line.startsWith("::step ")) {
+                const QStringList parts = line.split(' ', Qt::SkipEmptyParts);
+                emit stepStarted(parts.value(1).toInt(), parts.value(2).toInt());
+            } else {
+                collected->append(line);
+            }
+        }
+    });
+    connect(m_fallback, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished), this,
+            [this, collected](int exitCode, QProcess::ExitStatus status) {
+        collected->append(QString::fromLocal8Bit(m_fallback->readAll()));
+        m_fallback->deleteLater();
+        m_fallback = nullptr;
+        emit finished(status == QProcess::NormalExit && exitCode == 0, *collected);
+    });
+    // Without pkexec there is no finished() from QProcess, so run() would
+    // wait forever
+    connect(m_fallback, &QProcess::errorOccurred, this, [this](QProcess::ProcessError error) {
+        if (error != QProcess::FailedToStart) {
+            return;
+        }
+        const QString output = "Cannot start pkexec: " + m_fallback->errorString();
+        m_fallback->deleteLater();
+        m_fallback = nullptr;
+        emit finished(false, output);
+    });
+
+    // One pkexec for the whole batch; the script goes through stdin
+    m_fallback->start("pkexec", QStringList() << "bash" << "-s");
+    if (!m_fallback) {
+        return; // failed to start right away, finished() was sent
+    }
+    m_fallback->write(script.toUtf8());
+    m_fallback->closeWriteChannel();
+}
@@ -0,0 +1,61 @@
+#ifndef PRIVILEGED_HELPER_H
+#define PRIVILEGED_HELPER_H
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QVariantMap>
+#include <QList>
+#include <QByteArray>
+
+class QProcess;
+
+// Client for tolitica-helper (see tolitica_helper/). A batch of steps is sent
+// in one Execute() call under a capability ("packages", "os-release",
+// "services", "automount"), so the user authenticates once and no root
+// process is forked per step. When the helper isn't installed the same batch
+// is turned into one script and run through a single pkexec instead.
+class PrivilegedHelper : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit PrivilegedHelper(QObject *parent = nullptr);
+
+    // STEPS
+    static QVariantMap runStep(const QString &program, const QStringList &arguments);
+    static QVariantMap writeStep(const QString &path, const QByteArray &content);
+    static QVariantMap copyStep(const QString &source, const QString &target);
+    static QVariantMap makeDirStep(const QString &path);
+    static QVariantMap removeStep(const QString &path);
+    static QVariantMap replaceTextStep(const QString &path, const QString &from, const QString &to);
+    static QVariantMap setKeyStep(const QString &path, const QString &key, const QString &value);
+    static QVariantMap removeOrphansStep();
+    // One ALPM removal transaction for the whole list (pacman -Rn)
+    static QVariantMap removePackagesStep(const QStringList &packages);
+
+    // Starts the batch; progress comes through stepStarted(), the outcome
+    // through finished().
+    void start(const QString &capability, const QList<QVariantMap> &steps);
+
+    // Runs the batch and waits for it, keeping the UI responsive meanwhile.
+    // output receives the programs' output, or the error on failure.
+    static bool run(const QString &capability, const QList<QVariantMap> &steps,
+                    QString *output = nullptr);
+
+signals:
+    void stepStarted(int index, int total);
+    void finished(bool success, const QString &output);
+
+private slots:
+    void onHelperStepStarted(const QString &client, uint index, uint total);
+
+private:
+    void startFallback(const QList<QVariantMap> &steps);
+    static QString fallbackScript(const QList<QVariantMap> &steps, QString *error);
+
+    QProcess *m_fallback = nullptr;
+    bool m_connected = false;
+};
+
+#endif // PRIVILEGED_HELPER_H
@@ -0,0 +1,298 @@
+#include "progress_model.h"
+
+#include <QProcess>
+#include <QProgressDialog>
+#include <QRegularExpression>
+#include <QDir>
+#include <QDirIterator>
+#include <QFileInfo>
+#include <QLocale>
+#include <QtMath>
+
+namespace {
+const char *const kPackageCache = "/var/cache/pacman/pkg";
+
+// Weight of each phase on the 0-100 bar
+const int kSyncEnd = 5;
+const int kDownloadSpan = 55;
+const int kInstallEnd = 95;
+
+// Smoothing for the throughput average; higher follows changes faster
+const double kRateSmoothing = 0.3;
+
+qint64 parseSize(const QString &number, const QString &unit) {
+    double value = number.toDouble();
+    if (unit == "KiB") {
+        value *= 1024.0;
+    } else if (unit == "MiB") {
+        value *= 1024.0 * 1024.0;
+    } else if (unit == "GiB") {
+        value *= 1024.0 * 1024.0 * 1024.0;
+    }
+    return qint64(value);
+}
+}
+
+ProgressModel::ProgressModel(QObject *parent)
+    : QObject(parent)
+{
+    m_cacheTimer.setInterval(500);
+    connect(&m_cacheTimer, &QTimer::timeout, this, &ProgressModel::pollCache);
+}
+
+QString ProgressModel::pacmanCommand(const QString &arguments) {
+    return "LC_ALL=C stdbuf -oL pacman " + arguments;
+}
+
+///////////////////////////////////////////////////
+/// FEEDING
+//////////////////////////////////////////////////
+void ProgressModel::follow(QProcess *process) {
+    // Whatever sits in the cache now isn't part of this download
+    m_cacheBaseline.clear();
+    const QStringList existing = QDir(kPackageCache).entryList(QDir::Files);
+    for (const QString &name : existing) {
+        m_cacheBaseline.insert(name);
+    }
+
+    connect(process, &QProcess::readyReadStandardOutput, this, [this, process]() {
+        feed(process->readAllStandardOutput());
+    });
+}
+
+void ProgressModel::feed(const QByteArray &output) {
+    const QString text = QString::fromLocal8Bit(output);
+    m_transcript += text;
+
+    m_pendingLine += text;
+    int newline;
+    while ((newline = m_pendingLine.indexOf('\n')) >= 0) {
+        parseLine(m_pendingLine.left(newline).trimmed());
+        m_pendingLine.remove(0, newline + 1);
+    }
+    emit changed();
+}
+
+void ProgressModel::parseLine(const QString &line) {
+    static const QRegularExpression packagesRe(R"(^Packages \((\d+)\))");
+    static const QRegularExpression downloadSizeRe(R"(^Total Download Size:\s+([\d.]+)\s+(\S+))");
+    static const QRegularExpression downloadingRe(R"(^(\S+) downloading\.\.\.$)");
+    static const QRegularExpression operationRe(
+        R"(^(installing|upgrading|reinstalling|downgrading|removing) (\S+)\.\.\.$)");
+    static const QRegularExpression hookRe(R"(^\((\d+)/(\d+)\) (.+)$)");
+
+    if (line.isEmpty()) {
+        return;
+    }
+
+    QRegularExpressionMatch match;
+    if (line.startsWith(":: Synchronizing package databases")) {
+        setPhase(Phase::Synchronizing);
+    } else if ((match = packagesRe.match(line)).hasMatch()) {
+        m_totalPackages = match.captured(1).toInt();
+    } else if ((match = downloadSizeRe.match(line)).hasMatch()) {
+        m_totalBytes = parseSize(match.captured(1), match.captured(2));
+    } else if (line.startsWith(":: Retrieving packages")) {
+        setPhase(Phase::Downloading);
+    } else if ((match = downloadingRe.match(line)).hasMatch()) {
+        m_currentPackage = match.captured(1);
+    } else if ((match = operationRe.match(line)).hasMatch()) {
+        packageStarted(Phase::Installing, match.captured(2));
+    } else if (line.startsWith(":: Running post-transaction hooks")) {
+        setPhase(Phase::RunningHooks);
+    } else if (m_phase == Phase::RunningHooks && (match = hookRe.match(line)).hasMatch()) {
+        m_hookIndex = match.captured(1).toInt();
+        m_hookTotal = match.captured(2).toInt();
+        m_currentPackage = match.captured(3);
+    }
+}
+
+void ProgressModel::setTotals(int packages, qint64 bytes) {
+    m_totalPackages = packages;
+    m_totalBytes = bytes;
+    emit changed();
+}
+
+void ProgressModel::packageStarted(Phase phase, const QString &name) {
+    setPhase(phase);
+    m_currentPackage = name;
+    if (phase == Phase::Installing) {
+        m_packagesDone++;
+    }
+    emit changed();
+}
+
+void ProgressModel::setDownloadedBytes(qint64 bytes) {
+    const qint64 now = m_clock.isValid() ? m_clock.elapsed() : 0;
+    if (!m_clock.isValid()) {
+        m_clock.start();
+    }
+
+    // Exponential moving average of the throughput between samples
+    const qint64 elapsedMs = now - m_lastSampleMs;
+    if (elapsedMs > 0 && bytes >= m_lastSampleBytes) {
+        const double instant = double(bytes - m_lastSampleBytes) * 1000.0 / double(elapsedMs);
+        m_bytesPerSecond = (m_bytesPerSecond <= 0.0)
+            ? instant
+            : kRateSmoothing * instant + (1.0 - kRateSmoothing) * m_bytesPerSecond;
+    }
+    m_lastSampleBytes = bytes;
+    m_lastSampleMs = now;
+
+    m_downloadedBytes = m_totalBytes > 0 ? qMin(bytes, m_totalBytes) : bytes;
+    emit changed();
+}
+
+void ProgressModel::reset() {
+    m_cacheTimer.stop();
+    m_phase = Phase::Preparing;
+    m_currentPackage.clear();
+    m_packagesDone = m_totalPackages = 0;
+    m_hookIndex = m_hookTotal = 0;
+    m_downloadedBytes = m_totalBytes = 0;
+    m_bytesPerSecond = 0.0;
+    m_pendingLine.clear();
+    m_clock.invalidate();
+    m_lastSampleBytes = m_lastSampleMs = 0;
+    emit changed();
+}
+
+void ProgressModel::finish() {
+    if (!m_pendingLine.isEmpty()) {
+        parseLine(m_pendingLine.trimmed());
+        m_pendingLine.clear();
+    }
+    setPhase(Phase::Finished);
+    emit changed();
+}
+
+void ProgressModel::setPhase(Phase phase) {
+    if (phase == m_phase) {
+        return;
+    }
+
+    // Downloads are only measured while pacman is retrieving packages
+    if (phase == Phase::Downloading) {
+        m_clock.invalidate();
+        m_lastSampleBytes = m_lastSampleMs = 0;
+        m_cacheTimer.start();
+    } else if (m_phase == Phase::Downloading) {
+        m_cacheTimer.stop();
+        m_downloadedBytes = qMax(m_downloadedBytes, m_totalBytes);
+        m_bytesPerSecond = 0.0;
+    }
+    m_phase = phase;
+}
+
+///////////////////////////////////////////////////
+/// CACHE MEASUREMENT
+//////////////////////////////////////////////////
+qint64 ProgressModel::stagedBytes() const {
+    // Finished packages land in the cache itself, partial ones in pacman's
+    // download-* directories (when those are readable)
+    qint64 total = 0;
+    QDirIterator it(kPackageCache, QDir::Files, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        it.next();
+        const QFileInfo info = it.fileInfo();
+        if (info.absolutePath() == kPackageCache && m_cacheBaseline.contains(info.fileName())) {
+            continue;
+        }
+        total += info.size();
+    }
+    return total;
+}
+
+void ProgressModel::pollCache() {
+    setDownloadedBytes(stagedBytes());
+}
+
+///////////////////////////////////////////////////
+/// READING
+//////////////////////////////////////////////////
+int ProgressModel::percent() const {
+    const int downloadSpan = m_totalBytes > 0 ? kDownloadSpan : 0;
+    const int installStart = kSyncEnd + downloadSpan;
+
+    switch (m_phase) {
+    case Phase::Preparing:
+        return 0;
+    case Phase::Synchronizing:
+        return kSyncEnd / 2;
+    case Phase::Downloading:
+        if (m_totalBytes <= 0) {
+            return kSyncEnd;
+        }
+        return kSyncEnd + int(downloadSpan * m_downloadedBytes / m_totalBytes);
+    case Phase::Installing:
+        if (m_totalPackages <= 0) {
+            return installStart;
+        }
+        return installStart + (kInstallEnd - installStart) * qMax(m_packagesDone - 1, 0) / m_totalPackages;
+    case Phase::RunningHooks:
+        if (m_hookTotal <= 0) {
+            return kInstallEnd;
+        }
+        return kInstallEnd + 4 * m_hookIndex / m_hookTotal;
+    case Phase::Finished:
+        return 100;
+    }
+    return 0;
+}
+
+int ProgressModel::etaSeconds() const {
+    if (m_phase != Phase::Downloading || m_bytesPerSecond <= 0.0 || m_totalBytes <= 0) {
+        return -1;
+    }
+    return qCeil(double(m_totalBytes - m_downloadedBytes) / m_bytesPerSecond);
+}
+
+QString ProgressModel::statusText() const {
+    QLocale locale;
+
+    switch (m_phase) {
+    case Phase::Preparing:
+        return "Preparing...";
+    case Phase::Synchronizing:
+        return "Synchronizing package databases...";
+    case Phase::Downloading: {
+        QString text = "Downloading " + m_currentPackage;
+        if (m_totalBytes > 0) {
+            text += QString("\n%1 of %2").arg(locale.formattedDataSize(m_downloadedBytes),
+                                              locale.formattedDataSize(m_totalBytes));
+        }
+        if (m_bytesPerSecond > 0.0) {
+            text += QString(" - %1/s").arg(locale.formattedDataSize(qint64(m_bytesPerSecond)));
+        }
+        const int eta = etaSeconds();
+        if (eta >= 0) {
+            text += QString(" - %1:%2 left").arg(eta / 60).arg(eta % 60, 2, 10, QChar('0'));
+        }
+        return text;
+    }
+    case Phase::Installing:
+        if (m_totalPackages > 0) {
+            return QString("Processing %1 (%2/%3)").arg(m_currentPackage)
+                .arg(m_packagesDone).arg(m_totalPackages);
+        }
+        return "Processing " + m_currentPackage;
+    case Phase::RunningHooks:
+        return "Running hooks: " + m_currentPackage;
+    case Phase::Finished:
+        return "Done";
+    }
+    return QString();
+}
+
+///////////////////////////////////////////////////
+/// PRESENTING
+//////////////////////////////////////////////////
+void ProgressModel::attach(QProgressDialog *dialog) {
+    const QString title = dialog->labelText();
+    dialog->setRange(0, 100);
+
+    connect(this, &ProgressModel::changed, dialog, [this, dialog, title]() {
+        dialog->setValue(percent());
+        dialog->setLabelText(title + "\n" + statusText());
+    });
+}
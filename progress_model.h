@@ -0,0 +1,98 @@
+#ifndef PROGRESS_MODEL_H
+#define PROGRESS_MODEL_H
+
+#include <QObject>
+#include <QString>
+#include <QSet>
+#include <QTimer>
+#include <QElapsedTimer>
+
+class QProcess;
+class QProgressDialog;
+
+// Real progress for package operations, replacing the "+2% every 250 ms"
+// timers. It is fed by pacman's own output: phases, package count, total
+// download size and the package currently being downloaded or installed.
+// Downloaded bytes are measured from the files landing in the package cache,
+// which gives throughput and an ETA. One model drives one QProgressDialog.
+//
+// Run pacman through pacmanCommand() so the output is line-buffered and in
+// the C locale the parser expects.
+class ProgressModel : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum class Phase {
+        Preparing,
+        Synchronizing,
+        Downloading,
+        Installing,
+        RunningHooks,
+        Finished
+    };
+
+    explicit ProgressModel(QObject *parent = nullptr);
+
+    static QString pacmanCommand(const QString &arguments);
+
+    // FEEDING
+    void follow(QProcess *process);
+    void feed(const QByteArray &output);
+    void setTotals(int packages, qint64 bytes);
+    void packageStarted(Phase phase, const QString &name);
+    void setDownloadedBytes(qint64 bytes);
+    void reset();     // before re-running the same operation
+    void finish();
+
+    // READING
+    Phase phase() const { return m_phase; }
+    int percent() const;
+    QString currentPackage() const { return m_currentPackage; }
+    int packagesDone() const { return m_packagesDone; }
+    int totalPackages() const { return m_totalPackages; }
+    qint64 downloadedBytes() const { return m_downloadedBytes; }
+    qint64 totalBytes() const { return m_totalBytes; }
+    double bytesPerSecond() const { return m_bytesPerSecond; }
+    int etaSeconds() const;   // -1 while unknown
+    QString statusText() const;
+
+    // Everything the followed process printed on stdout
+    QString transcript() const { return m_transcript; }
+
+    // PRESENTING
+    void attach(QProgressDialog *dialog);
+
+signals:
+    void changed();
+
+private slots:
+    void pollCache();
+
+private:
+    void parseLine(const QString &line);
+    void setPhase(Phase phase);
+    qint64 stagedBytes() const;
+
+    Phase m_phase = Phase::Preparing;
+    QString m_currentPackage;
+    int m_packagesDone = 0;
+    int m_totalPackages = 0;
+    int m_hookIndex = 0;
+    int m_hookTotal = 0;
+    qint64 m_downloadedBytes = 0;
+    qint64 m_totalBytes = 0;
+    double m_bytesPerSecond = 0.0;
+
+    QString m_pendingLine;
+    QString m_transcript;
+
+    // Cache measurement
+    QTimer m_cacheTimer;
+    QSet<QString> m_cacheBaseline;
+    QElapsedTimer m_clock;
+    qint64 m_lastSampleBytes = 0;
+    qint64 m_lastSampleMs = 0;
+};
+
+#endif // PROGRESS_MODEL_H
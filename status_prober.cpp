@@ -0,0 +1,22 @@
+#include "status_prober.h"
+
+#include <QThread>
+#include <QtGlobal>
+
+StatusProber::StatusProber(QObject *parent)
+    : QObject(parent)
+{
+    // Probes mostly wait on pacman, systemctl and config files rather than
+    // the CPU, so allow more of them in flight than there are cores.
+    m_pool.setMaxThreadCount(qMax(8, QThread::idealThreadCount()));
+}
+
+StatusProber::~StatusProber()
+{
+    waitForDone();
+}
+
+void StatusProber::waitForDone()
+{
+    m_pool.waitForDone();
+}
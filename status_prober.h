@@ -0,0 +1,45 @@
+#ifndef STATUS_PROBER_H
+#define STATUS_PROBER_H
+
+#include <QObject>
+#include <QThreadPool>
+#include <QFuture>
+#include <QFutureWatcher>
+#include <QtConcurrent/QtConcurrent>
+#include <functional>
+
+// Runs status probes (package, service and config checks) concurrently on its
+// own pool so pages can be drawn straight away with placeholder toggles.
+// probe() hands back a QFuture; whenReady() delivers the result on the
+// context object's thread once the probe finishes.
+class StatusProber : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit StatusProber(QObject *parent = nullptr);
+    ~StatusProber();
+
+    template <typename T>
+    QFuture<T> probe(std::function<T()> check) {
+        return QtConcurrent::run(&m_pool, check);
+    }
+
+    template <typename T, typename Handler>
+    void whenReady(const QFuture<T> &future, QObject *context, Handler handler) {
+        QFutureWatcher<T> *watcher = new QFutureWatcher<T>(context);
+        connect(watcher, &QFutureWatcherBase::finished, context, [watcher, handler]() mutable {
+            handler(watcher->result());
+            watcher->deleteLater();
+        });
+        watcher->setFuture(future);
+    }
+
+    // Blocks until every queued probe has finished.
+    void waitForDone();
+
+private:
+    QThreadPool m_pool;
+};
+
+#endif // STATUS_PROBER_H
@@ -0,0 +1,237 @@
+#include "system_facts.h"
+
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QStandardPaths>
+#include <QTextStream>
+#include <QRegularExpression>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QFuture>
+#include <QList>
+#include <QtConcurrent/QtConcurrent>
+#include <QDebug>
+
+#include <pwd.h>
+#include <unistd.h>
+
+namespace {
+QMutex s_mutex;
+QSharedPointer<const SystemFacts> s_current;
+
+// Strips the surrounding whitespace and the quotes config files like to add.
+QString unquoted(QString value) {
+    value = value.trimmed();
+    value.remove('"');
+    return value;
+}
+}
+
+void SystemFacts::gather(Sources sources) {
+    QSharedPointer<SystemFacts> next(new SystemFacts);
+    {
+        QMutexLocker locker(&s_mutex);
+        if (s_current) {
+            *next = *s_current;
+        } else {
+            sources = All;
+        }
+    }
+
+    // Every reader fills its own members, so they can run side by side.
+    SystemFacts *facts = next.data();
+    QList<QFuture<void>> jobs;
+    if (sources & LiveEnv)      jobs << QtConcurrent::run([facts]() { facts->readLiveEnv(); });
+    if (sources & ToliticaConf) jobs << QtConcurrent::run([facts]() { facts->readToliticaConf(); });
+    if (sources & OsRelease)    jobs << QtConcurrent::run([facts]() { facts->readOsRelease(); });
+    if (sources & Grub)         jobs << QtConcurrent::run([facts]() { facts->readGrub(); });
+    if (sources & KdeGlobals)   jobs << QtConcurrent::run([facts]() { facts->readKdeGlobals(); });
+    if (sources & Konsole)      jobs << QtConcurrent::run([facts]() { facts->readKonsole(); });
+    if (sources & Shell)        jobs << QtConcurrent::run([facts]() { facts->readShell(); });
+
+    for (QFuture<void> &job : jobs) {
+        job.waitForFinished();
+    }
+
+    QMutexLocker locker(&s_mutex);
+    s_current = next;
+}
+
+QSharedPointer<const SystemFacts> SystemFacts::snapshot() {
+    {
+        QMutexLocker locker(&s_mutex);
+        if (s_current) {
+            return s_current;
+        }
+    }
+
+    gather(All);
+
+    QMutexLocker locker(&s_mutex);
+    return s_current;
+}
+
+///////////////////////////////////////////////////
+/// LIVE ENVIRONMENT
+//////////////////////////////////////////////////
+void SystemFacts::readLiveEnv() {
+    // Same test the old `grep -q '/cow' /proc/mounts || [ -f /run/live/medium ]` did
+    bool live = QFileInfo("/run/live/medium").isFile();
+
+    QFile mounts("/proc/mounts");
+    if (!live && mounts.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        live = mounts.readAll().contains("/cow");
+    }
+    m_liveEnv = live;
+}
+
+///////////////////////////////////////////////////
+/// TOLITICA.CONF
+//////////////////////////////////////////////////
+void SystemFacts::readToliticaConf() {
+    m_toliticaConf.clear();
+
+    QFile configFile(QDir::homePath() + "/tolitica-home-settings/tolitica.conf");
+    if (!configFile.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        return;
+    }
+
+    // Keys are written both as "key = value" and "key=value"; first one wins.
+    QTextStream in(&configFile);
+    while (!in.atEnd()) {
+        QString line = in.readLine();
+        int eq = line.indexOf('=');
+        if (eq <= 0) {
+            continue;
+        }
+        QString key = line.left(eq).trimmed();
+        if (!m_toliticaConf.contains(key)) {
+            m_toliticaConf.insert(key, line.mid(eq + 1).trimmed());
+        }
+    }
+}
+
+///////////////////////////////////////////////////
+/// OS-RELEASE
+//////////////////////////////////////////////////
+void SystemFacts::readOsRelease() {
+    m_osRelease.clear();
+
+    QFile configFile("/usr/lib/os-release");
+    if (!configFile.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        return;
+    }
+
+    QTextStream in(&configFile);
+    while (!in.atEnd()) {
+        QString line = in.readLine().trimmed();
+        int eq = line.indexOf('=');
+        if (eq <= 0 || line.startsWith('#')) {
+            continue;
+        }
+        m_osRelease.insert(line.left(eq), line.mid(eq + 1));
+    }
+}
+
+///////////////////////////////////////////////////
+/// GRUB
+//////////////////////////////////////////////////
+void SystemFacts::readGrub() {
+    m_grubTheme.clear();
+    m_grubCmdlineDefault.clear();
+
+    QFile grubFile("/etc/default/grub");
+    if (!grubFile.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        return;
+    }
+    QString grubContent = QTextStream(&grubFile).readAll();
+
+    static const QRegularExpression cmdlineRegex(R"(GRUB_CMDLINE_LINUX_DEFAULT=(['\"])(.*?)\1)");
+    QRegularExpressionMatch match = cmdlineRegex.match(grubContent);
+    if (match.hasMatch()) {
+        m_grubCmdlineDefault = match.captured(2);
+    }
+
+    const QStringList lines = grubContent.split('\n');
+    for (const QString &rawLine : lines) {
+        QString line = rawLine.trimmed();
+        if (line.startsWith("GRUB_THEME=")) {
+            m_grubTheme = unquoted(line.mid(11));
+            break;
+        }
+    }
+}
+
+///////////////////////////////////////////////////
+/// KDEGLOBALS
+//////////////////////////////////////////////////
+void SystemFacts::readKdeGlobals() {
+    m_lookAndFeel.clear();
+    m_iconTheme.clear();
+
+    const QString configDir = QStandardPaths::writableLocation(QStandardPaths::ConfigLocation);
+    QFile configFile(QDir(configDir).filePath("kdeglobals"));
+    if (!configFile.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        return;
+    }
+
+    QTextStream in(&configFile);
+    QString section;
+    while (!in.atEnd()) {
+        QString line = in.readLine().trimmed();
+
+        if (line.isEmpty() || line.startsWith('#') || line.startsWith(';')) {
+            continue;
+        }
+
+        if (line.startsWith('[') && line.endsWith(']')) {
+            section = line;
+            continue;
+        }
+
+        if (section == "[KDE]" && line.startsWith("LookAndFeelPackage=")) {
+            m_lookAndFeel = unquoted(line.mid(19));
+        } else if (section == "[Icons]" && line.startsWith("Theme=")) {
+            m_iconTheme = unquoted(line.mid(6));
+        }
+    }
+}
+
+///////////////////////////////////////////////////
+/// KONSOLE
+//////////////////////////////////////////////////
+void SystemFacts::readKonsole() {
+    m_konsoleProfile.clear();
+
+    QFile configFile(QDir::homePath() + "/.config/konsolerc");
+    if (!configFile.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        return;
+    }
+
+    QTextStream in(&configFile);
+    while (!in.atEnd()) {
+        QString line = in.readLine().trimmed();
+        if (line.startsWith("DefaultProfile=")) {
+            m_konsoleProfile = unquoted(line.mid(15));
+            break;
+        }
+    }
+}
+
+///////////////////////////////////////////////////
+/// SHELL
+//////////////////////////////////////////////////
+void SystemFacts::readShell() {
+    // getpwuid_r reads the same passwd entry `getent passwd $USER` printed
+    struct passwd pwd;
+    struct passwd *result = nullptr;
+    char buffer[4096];
+
+    if (getpwuid_r(getuid(), &pwd, buffer, sizeof(buffer), &result) != 0 || !result) {
+        qDebug() << "Failed to fetch current shell";
+        m_loginShell = "Unknown";
+        return;
+    }
+    m_loginShell = QString::fromLocal8Bit(result->pw_shell);
+}
@@ -0,0 +1,87 @@
+#ifndef SYSTEM_FACTS_H
+#define SYSTEM_FACTS_H
+
+#include <QString>
+#include <QHash>
+#include <QFlags>
+#include <QSharedPointer>
+
+// Read-only snapshot of the machine/user state the status toggles depend on:
+// live session, tolitica.conf values, os-release, grub, kdeglobals, konsolerc
+// and the login shell. Everything is gathered once at startup, each source on
+// its own pool thread, and shared by Widget, Widget_Initial, CoreInitial and
+// CoreFunctions. Code that changes one of those files refreshes just that
+// source with gather(<source>).
+class SystemFacts
+{
+public:
+    enum Source {
+        LiveEnv      = 0x01,
+        ToliticaConf = 0x02,
+        OsRelease    = 0x04,
+        Grub         = 0x08,
+        KdeGlobals   = 0x10,
+        Konsole      = 0x20,
+        Shell        = 0x40,
+        All          = 0x7f
+    };
+    Q_DECLARE_FLAGS(Sources, Source)
+
+    // Re-reads the requested sources in parallel and publishes a new snapshot.
+    // Blocks until every source has been read.
+    static void gather(Sources sources = All);
+
+    // Latest published snapshot; gathers everything on first use.
+    static QSharedPointer<const SystemFacts> snapshot();
+
+    // LIVE ENVIRONMENT
+    bool isLiveEnv() const { return m_liveEnv; }
+
+    // TOLITICA.CONF
+    bool initialSetupPending() const { return m_toliticaConf.value("initialSetup") == "0"; }
+    QString xrayImageVersion() const { return m_toliticaConf.value("xrayos_img_ver"); }
+    QString archImageVersion() const { return m_toliticaConf.value("arch_img_ver"); }
+    QString lastKonsoleProfile() const { return m_toliticaConf.value("lastKonsoleProfile"); }
+
+    // OS-RELEASE (values are kept verbatim, quotes included)
+    bool hasOsRelease() const { return !m_osRelease.isEmpty(); }
+    QString osReleaseValue(const QString &key) const { return m_osRelease.value(key); }
+    const QHash<QString, QString> &osRelease() const { return m_osRelease; }
+
+    // GRUB
+    QString grubTheme() const { return m_grubTheme; }
+    QString grubCmdlineDefault() const { return m_grubCmdlineDefault; }
+
+    // KDEGLOBALS
+    QString lookAndFeelPackage() const { return m_lookAndFeel; }
+    QString iconTheme() const { return m_iconTheme; }
+
+    // KONSOLE
+    QString konsoleProfile() const { return m_konsoleProfile; }
+
+    // SHELL
+    QString loginShell() const { return m_loginShell; }
+
+private:
+    void readLiveEnv();
+    void readToliticaConf();
+    void readOsRelease();
+    void readGrub();
+    void readKdeGlobals();
+    void readKonsole();
+    void readShell();
+
+    bool m_liveEnv = false;
+    QHash<QString, QString> m_toliticaConf;
+    QHash<QString, QString> m_osRelease;
+    QString m_grubTheme;
+    QString m_grubCmdlineDefault;
+    QString m_lookAndFeel;
+    QString m_iconTheme;
+    QString m_konsoleProfile;
+    QString m_loginShell;
+};
+
+Q_DECLARE_OPERATORS_FOR_FLAGS(SystemFacts::Sources)
+
+#endif // SYSTEM_FACTS_H
@@ -0,0 +1,234 @@
+#include "systemd_units.h"
+
+#include <QCoreApplication>
+#include <QThread>
+#include <QFileInfo>
+#include <QDBusArgument>
+#include <QDBusObjectPath>
+#include <QDBusPendingCall>
+#include <QDBusPendingReply>
+#include <QDebug>
+
+namespace {
+const char *const kManagerPath = "/org/freedesktop/systemd1";
+const char *const kManagerInterface = "org.freedesktop.systemd1.Manager";
+const char *const kUnitInterface = "org.freedesktop.systemd1.Unit";
+const char *const kPropertiesInterface = "org.freedesktop.DBus.Properties";
+}
+
+///////////////////////////////////////////////////
+/// UNIT STATE
+//////////////////////////////////////////////////
+bool SystemdUnits::UnitState::isEnabled() const {
+    static const QStringList enabledStates = {
+        "enabled", "enabled-runtime", "static", "alias", "indirect", "generated", "transient"
+    };
+    return enabledStates.contains(unitFileState);
+}
+
+bool SystemdUnits::UnitState::isActive() const {
+    return activeState == "active" || activeState == "reloading";
+}
+
+bool SystemdUnits::UnitState::operator==(const UnitState &other) const {
+    return loadState == other.loadState && activeState == other.activeState &&
+           subState == other.subState && unitFileState == other.unitFileState;
+}
+
+///////////////////////////////////////////////////
+/// CONSTRUCTION
+//////////////////////////////////////////////////
+SystemdUnits::SystemdUnits(const QDBusConnection &bus, const QString &service, QObject *parent)
+    : QObject(parent), m_bus(bus), m_service(service)
+{
+    qRegisterMetaType<SystemdUnits::UnitState>();
+}
+
+SystemdUnits &SystemdUnits::instance() {
+    // The first caller may be a probe thread; park the object on the GUI
+    // thread so the D-Bus signal slots run there.
+    static SystemdUnits *units = []() {
+        SystemdUnits *created = new SystemdUnits(QDBusConnection::systemBus());
+        if (QCoreApplication::instance()) {
+            created->moveToThread(QCoreApplication::instance()->thread());
+        }
+        return created;
+    }();
+    return *units;
+}
+
+///////////////////////////////////////////////////
+/// QUERIES
+//////////////////////////////////////////////////
+QHash<QString, SystemdUnits::UnitState> SystemdUnits::states(const QStringList &units) const {
+    return query(units, nullptr);
+}
+
+SystemdUnits::UnitState SystemdUnits::state(const QString &unit) const {
+    return query(QStringList() << unit, nullptr).value(unit);
+}
+
+QHash<QString, SystemdUnits::UnitState> SystemdUnits::query(const QStringList &units,
+    QHash<QString, QString> *paths) const {
+    QHash<QString, UnitState> result;
+    if (units.isEmpty()) {
+        return result;
+    }
+
+    // Send both requests before waiting on either, so a batch costs a
+    // single round trip to the manager.
+    QDBusMessage unitsCall = QDBusMessage::createMethodCall(
+        m_service, kManagerPath, kManagerInterface, "ListUnitsByNames");
+    unitsCall << units;
+
+    QDBusMessage filesCall = QDBusMessage::createMethodCall(
+        m_service, kManagerPath, kManagerInterface, "ListUnitFilesByPatterns");
+    filesCall << QStringList() << units;
+
+    QDBusPendingCall unitsPending = m_bus.asyncCall(unitsCall);
+    QDBusPendingCall filesPending = m_bus.asyncCall(filesCall);
+    unitsPending.waitForFinished();
+    filesPending.waitForFinished();
+
+    // a(ssssssouso): name, description, load, active, sub, following,
+    // unit path, job id, job type, job path
+    QDBusMessage unitsReply = unitsPending.reply();
+    if (unitsReply.type() == QDBusMessage::ReplyMessage && !unitsReply.arguments().isEmpty()) {
+        const QDBusArgument arg = unitsReply.arguments().at(0).value<QDBusArgument>();
+        arg.beginArray();
+        while (!arg.atEnd()) {
+            QString name, description, loadState, activeState, subState, following, jobType;
+            QDBusObjectPath unitPath, jobPath;
+            uint jobId = 0;
+
+            arg.beginStructure();
+            arg >> name >> description >> loadState >> activeState >> subState >> following
+                >> unitPath >> jobId >> jobType >> jobPath;
+            arg.endStructure();
+
+            UnitState &state = result[name];
+            state.loadState = loadState;
+            state.activeState = activeState;
+            state.subState = subState;
+            if (paths) {
+                paths->insert(unitPath.path(), name);
+            }
+        }
+        arg.endArray();
+    } else {
+        qWarning() << "ListUnitsByNames failed:" << unitsReply.errorMessage();
+    }
+
+    // a(ss): unit file path, state. Matched back by file name.
+    QDBusMessage filesReply = filesPending.reply();
+    if (filesReply.type() == QDBusMessage::ReplyMessage && !filesReply.arguments().isEmpty()) {
+        const QDBusArgument arg = filesReply.arguments().at(0).value<QDBusArgument>();
+        arg.beginArray();
+        while (!arg.atEnd()) {
+            QString filePath, fileState;
+
+            arg.beginStructure();
+            arg >> filePath >> fileState;
+            arg.endStructure();
+
+            const QString name = QFileInfo(filePath).fileName();
+            if (units.contains(name)) {
+                result[name].unitFileState = fileState;
+            }
+        }
+        arg.endArray();
+    } else {
+        qWarning() << "ListUnitFilesByPatterns failed:" << filesReply.errorMessage();
+    }
+
+    return result;
+}
+
+///////////////////////////////////////////////////
+/// LIVE UPDATES
+//////////////////////////////////////////////////
+bool SystemdUnits::subscribe() {
+    if (m_subscribed) {
+        return true;
+    }
+
+    // Without Subscribe() the manager stays quiet about unit changes
+    QDBusMessage reply = m_bus.call(QDBusMessage::createMethodCall(
+        m_service, kManagerPath, kManagerInterface, "Subscribe"));
+    if (reply.type() == QDBusMessage::ErrorMessage) {
+        qWarning() << "Failed to subscribe to systemd:" << reply.errorMessage();
+        return false;
+    }
+
+    m_bus.connect(m_service, kManagerPath, kManagerInterface, "UnitFilesChanged",
+                  this, SLOT(onUnitFilesChanged()));
+    m_subscribed = true;
+    return true;
+}
+
+void SystemdUnits::watch(const QStringList &units) {
+    QStringList fresh;
+    for (const QString &unit : units) {
+        if (!m_watched.contains(unit)) {
+            fresh << unit;
+        }
+    }
+    if (fresh.isEmpty() || !subscribe()) {
+        return;
+    }
+
+    QHash<QString, QString> paths;
+    const QHash<QString, UnitState> current = query(fresh, &paths);
+    for (auto it = paths.cbegin(); it != paths.cend(); ++it) {
+        m_unitPaths.insert(it.key(), it.value());
+        m_bus.connect(m_service, it.key(), kPropertiesInterface, "PropertiesChanged", this,
+                      SLOT(onPropertiesChanged(QString,QVariantMap,QStringList,QDBusMessage)));
+    }
+    for (const QString &unit : fresh) {
+        m_watched.insert(unit, current.value(unit));
+    }
+}
+
+void SystemdUnits::refresh(const QStringList &units) {
+    const QHash<QString, UnitState> current = query(units, nullptr);
+    for (const QString &unit : units) {
+        const UnitState state = current.value(unit);
+        if (m_watched.value(unit) != state) {
+            m_watched.insert(unit, state);
+            emit unitChanged(unit, state);
+        }
+    }
+}
+
+void SystemdUnits::onPropertiesChanged(const QString &interface, const QVariantMap &changed,
+    const QStringList &invalidated, const QDBusMessage &message) {
+    if (interface != kUnitInterface) {
+        return;
+    }
+
+    const QString unit = m_unitPaths.value(message.path());
+    if (unit.isEmpty()) {
+        return;
+    }
+
+    if (!invalidated.isEmpty()) {
+        refresh(QStringList() << unit);
+        return;
+    }
+
+    UnitState state = m_watched.value(unit);
+    state.loadState = changed.value("LoadState", state.loadState).toString();
+    state.activeState = changed.value("ActiveState", state.activeState).toString();
+    state.subState = changed.value("SubState", state.subState).toString();
+
+    if (m_watched.value(unit) != state) {
+        m_watched.insert(unit, state);
+        emit unitChanged(unit, state);
+    }
+}
+
+void SystemdUnits::onUnitFilesChanged() {
+    // Sent after enable/disable/daemon-reload, without saying which units
+    // were touched; one batch call covers every watched unit.
+    refresh(m_watched.keys());
+}
@@ -0,0 +1,84 @@
+#ifndef SYSTEMD_UNITS_H
+#define SYSTEMD_UNITS_H
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QHash>
+#include <QVariantMap>
+#include <QMetaType>
+#include <QDBusConnection>
+#include <QDBusMessage>
+
+// Reads unit state straight from org.freedesktop.systemd1 instead of running
+// `systemctl is-enabled` / `systemctl is-active` for every unit. states() asks
+// for a whole batch of units at once: ListUnitsByNames for the runtime state
+// and ListUnitFilesByPatterns for the install state, both sent before either
+// reply is awaited.
+//
+// watch() subscribes to the manager and to each unit's PropertiesChanged, so
+// unitChanged() fires when a unit starts/stops or gets enabled/disabled by
+// anyone, without re-polling.
+//
+// The bus and service name are injectable so the class can be pointed at a
+// stand-in manager registered on a private bus.
+class SystemdUnits : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct UnitState {
+        QString loadState;      // loaded, not-found, masked, ...
+        QString activeState;    // active, inactive, failed, ...
+        QString subState;       // running, dead, listening, ...
+        QString unitFileState;  // enabled, disabled, static, ... (empty if no unit file)
+
+        // Same answers `systemctl is-enabled` / `systemctl is-active` give
+        // through their exit code.
+        bool isEnabled() const;
+        bool isActive() const;
+
+        bool operator==(const UnitState &other) const;
+        bool operator!=(const UnitState &other) const { return !(*this == other); }
+    };
+
+    explicit SystemdUnits(const QDBusConnection &bus,
+                          const QString &service = QStringLiteral("org.freedesktop.systemd1"),
+                          QObject *parent = nullptr);
+
+    // Shared instance on the system bus. Lives on the GUI thread; states()
+    // and state() are safe to call from probe threads too.
+    static SystemdUnits &instance();
+
+    QHash<QString, UnitState> states(const QStringList &units) const;
+    UnitState state(const QString &unit) const;
+
+    // Starts tracking the given units and emits unitChanged() whenever one of
+    // them changes. Call from the thread the object lives on.
+    void watch(const QStringList &units);
+
+signals:
+    void unitChanged(const QString &unit, const SystemdUnits::UnitState &state);
+
+private slots:
+    void onPropertiesChanged(const QString &interface, const QVariantMap &changed,
+                             const QStringList &invalidated, const QDBusMessage &message);
+    void onUnitFilesChanged();
+
+private:
+    // Fills *paths with object path -> unit name when given.
+    QHash<QString, UnitState> query(const QStringList &units, QHash<QString, QString> *paths) const;
+    void refresh(const QStringList &units);
+    bool subscribe();
+
+    QDBusConnection m_bus;
+    QString m_service;
+    bool m_subscribed = false;
+
+    QHash<QString, UnitState> m_watched;   // unit name -> last known state
+    QHash<QString, QString> m_unitPaths;   // object path -> unit name
+};
+
+Q_DECLARE_METATYPE(SystemdUnits::UnitState)
+
+#endif // SYSTEMD_UNITS_H
@@ -0,0 +1,308 @@
+#include "systemd_units.h"
+
+#include <QtTest>
+#include <QThread>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QDBusArgument>
+#include <QDBusMetaType>
+#include <QDBusObjectPath>
+
+// SystemdUnits against a stand-in manager instead of the real systemd. The
+// stand-in registers under its own name on the session bus, which ctest
+// starts privately with dbus-run-session, and answers from its own
+// connection on its own thread, since SystemdUnits blocks on its replies.
+
+namespace {
+const char *const kService = "org.xray.ada.test.systemd1";
+const char *const kManagerPath = "/org/freedesktop/systemd1";
+const char *const kStandInConnection = "systemd-stand-in";
+}
+
+///////////////////////////////////////////////////
+/// STAND-IN MANAGER
+//////////////////////////////////////////////////
+// One ListUnitsByNames entry, a(ssssssouso)
+struct StandInUnit {
+    QString name;
+    QString description;
+    QString loadState;
+    QString activeState;
+    QString subState;
+    QString following;
+    QDBusObjectPath path;
+    uint jobId = 0;
+    QString jobType;
+    QDBusObjectPath jobPath;
+};
+Q_DECLARE_METATYPE(StandInUnit)
+
+// One ListUnitFilesByPatterns entry, a(ss)
+struct StandInUnitFile {
+    QString path;
+    QString state;
+};
+Q_DECLARE_METATYPE(StandInUnitFile)
+
+QDBusArgument &operator<<(QDBusArgument &arg, const StandInUnit &unit) {
+    arg.beginStructure();
+    arg << unit.name << unit.description << unit.loadState << unit.activeState << unit.subState
+        << unit.following << unit.path << unit.jobId << unit.jobType << unit.jobPath;
+    arg.endStructure();
+    return arg;
+}
+
+const QDBusArgument &operator>>(const QDBusArgument &arg, StandInUnit &unit) {
+    arg.beginStructure();
+    arg >> unit.name >> unit.description >> unit.loadState >> unit.activeState >> unit.subState
+        >> unit.following >> unit.path >> unit.jobId >> unit.jobType >> unit.jobPath;
+    arg.endStructure();
+    return arg;
+}
+
+QDBusArgument &operator<<(QDBusArgument &arg, const StandInUnitFile &file) {
+    arg.beginStructure();
+    arg << file.path << file.state;
+    arg.endStructure();
+    return arg;
+}
+
+const QDBusArgument &operator>>(const QDBusArgument &arg, StandInUnitFile &file) {
+    arg.beginStructure();
+    arg >> file.path >> file.state;
+    arg.endStructure();
+    return arg;
+}
+
+// Answers the few Manager calls SystemdUnits makes from a table of units,
+// and sends the signals systemd would when the test changes one.
+class StandInManager : public QObject
+{
+    Q_OBJECT
+    Q_CLASSINFO("D-Bus Interface", "org.freedesktop.systemd1.Manager")
+
+public:
+    explicit StandInManager(const QDBusConnection &bus)
+        : m_bus(bus)
+    {}
+
+    void setUnit(const QString &name, const SystemdUnits::UnitState &state) {
+        QMutexLocker locker(&m_mutex);
+        m_units.insert(name, state);
+    }
+
+    // Like a start or stop: PropertiesChanged on the unit's object
+    void setActiveState(const QString &name, const QString &activeState, const QString &subState) {
+        {
+            QMutexLocker locker(&m_mutex);
+            m_units[name].activeState = activeState;
+            m_units[name].subState = subState;
+        }
+        QDBusMessage signal = QDBusMessage::createSignal(unitPath(name),
+            "org.freedesktop.DBus.Properties", "PropertiesChanged");
+        QVariantMap changed;
+        changed.insert("ActiveState", activeState);
+        changed.insert("SubState", subState);
+        signal << QString("org.freedesktop.systemd1.Unit") << changed << QStringList();
+        m_bus.send(signal);
+    }
+
+    // Like enable/disable: UnitFilesChanged on the manager, naming no unit
+    void setUnitFileState(const QString &name, const QString &unitFileState) {
+        {
+            QMutexLocker locker(&m_mutex);
+            m_units[name].unitFileState = unitFileState;
+        }
+        m_bus.send(QDBusMessage::createSignal(kManagerPath, "org.freedesktop.systemd1.Manager",
+                                              "UnitFilesChanged"));
+    }
+
+    int calls(const QString &method) const {
+        QMutexLocker locker(&m_mutex);
+        return m_calls.value(method);
+    }
+
+    static QString unitPath(const QString &name) {
+        QString escaped = name;
+        escaped.replace('.', "_2e").replace('-', "_2d");
+        return "/org/freedesktop/systemd1/unit/" + escaped;
+    }
+
+public slots:
+    QList<StandInUnit> ListUnitsByNames(const QStringList &names) {
+        QMutexLocker locker(&m_mutex);
+        m_calls["ListUnitsByNames"]++;
+        QList<StandInUnit> units;
+        for (const QString &name : names) {
+            // systemd lists unknown names too, as not-found
+            const SystemdUnits::UnitState state = m_units.value(name);
+            StandInUnit unit;
+            unit.name = name;
+            unit.loadState = state.loadState.isEmpty() ? QString("not-found") : state.loadState;
+            unit.activeState = state.activeState.isEmpty() ? QString("inactive") : state.activeState;
+            unit.subState = state.subState.isEmpty() ? QString("dead") : state.subState;
+            unit.path = QDBusObjectPath(unitPath(name));
+            unit.jobPath = QDBusObjectPath("/");
+            units.append(unit);
+        }
+        return units;
+    }
+
+    QList<StandInUnitFile> ListUnitFilesByPatterns(const QStringList &states, const QStringList &patterns) {
+        Q_UNUSED(states)
+        QMutexLocker locker(&m_mutex);
+        m_calls["ListUnitFilesByPatterns"]++;
+        QList<StandInUnitFile> files;
+        for (auto it = m_units.cbegin(); it != m_units.cend(); ++it) {
+            if (patterns.contains(it.key()) && !it->unitFileState.isEmpty()) {
+                files.append({"/usr/lib/systemd/system/" + it.key(), it->unitFileState});
+            }
+        }
+        return files;
+    }
+
+    void Subscribe() {
+        QMutexLocker locker(&m_mutex);
+        m_calls["Subscribe"]++;
+    }
+
+private:
+    QDBusConnection m_bus;
+    mutable QMutex m_mutex;
+    QHash<QString, SystemdUnits::UnitState> m_units;
+    QHash<QString, int> m_calls;
+};
+
+///////////////////////////////////////////////////
+/// TESTS
+//////////////////////////////////////////////////
+class SystemdUnitsTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void init();
+
+    void batchIsOneRoundTrip();
+    void unknownUnit();
+    void activeStateChange();
+    void unitFileChange();
+
+private:
+    static SystemdUnits::UnitState unitState(const QString &active, const QString &sub, const QString &file);
+
+    QThread m_thread;
+    StandInManager *m_manager = nullptr;
+};
+
+SystemdUnits::UnitState SystemdUnitsTest::unitState(const QString &active, const QString &sub,
+                                                    const QString &file) {
+    SystemdUnits::UnitState state;
+    state.loadState = "loaded";
+    state.activeState = active;
+    state.subState = sub;
+    state.unitFileState = file;
+    return state;
+}
+
+void SystemdUnitsTest::initTestCase() {
+    if (!QDBusConnection::sessionBus().isConnected()) {
+        QSKIP("No session bus; run under dbus-run-session");
+    }
+
+    qDBusRegisterMetaType<StandInUnit>();
+    qDBusRegisterMetaType<QList<StandInUnit>>();
+    qDBusRegisterMetaType<StandInUnitFile>();
+    qDBusRegisterMetaType<QList<StandInUnitFile>>();
+
+    QDBusConnection bus = QDBusConnection::connectToBus(QDBusConnection::SessionBus, kStandInConnection);
+    QVERIFY(bus.isConnected());
+
+    m_manager = new StandInManager(bus);
+    m_manager->moveToThread(&m_thread);
+    m_thread.start();
+    QVERIFY(bus.registerObject(kManagerPath, m_manager, QDBusConnection::ExportAllSlots));
+    QVERIFY2(bus.registerService(kService), qPrintable(bus.lastError().message()));
+}
+
+void SystemdUnitsTest::cleanupTestCase() {
+    if (m_manager) {
+        QDBusConnection::disconnectFromBus(kStandInConnection);
+        m_thread.quit();
+        m_thread.wait();
+        delete m_manager;
+    }
+}
+
+void SystemdUnitsTest::init() {
+    m_manager->setUnit("bluetooth.service", unitState("active", "running", "enabled"));
+    m_manager->setUnit("apparmor.service", unitState("active", "exited", "enabled"));
+    m_manager->setUnit("snapd.socket", unitState("inactive", "dead", "disabled"));
+}
+
+void SystemdUnitsTest::batchIsOneRoundTrip() {
+    SystemdUnits units(QDBusConnection::sessionBus(), kService);
+    const int listed = m_manager->calls("ListUnitsByNames");
+    const int files = m_manager->calls("ListUnitFilesByPatterns");
+
+    const QHash<QString, SystemdUnits::UnitState> states =
+        units.states({"bluetooth.service", "apparmor.service", "snapd.socket"});
+
+    QCOMPARE(m_manager->calls("ListUnitsByNames"), listed + 1);
+    QCOMPARE(m_manager->calls("ListUnitFilesByPatterns"), files + 1);
+    QCOMPARE(states.size(), 3);
+    QVERIFY(states.value("bluetooth.service") == unitState("active", "running", "enabled"));
+    QVERIFY(states.value("apparmor.service").isActive());
+    QVERIFY(states.value("apparmor.service").isEnabled());
+    QVERIFY(!states.value("snapd.socket").isActive());
+    QVERIFY(!states.value("snapd.socket").isEnabled());
+}
+
+void SystemdUnitsTest::unknownUnit() {
+    SystemdUnits units(QDBusConnection::sessionBus(), kService);
+    const SystemdUnits::UnitState state = units.state("missing.service");
+
+    QCOMPARE(state.loadState, QString("not-found"));
+    QVERIFY(state.unitFileState.isEmpty());
+    QVERIFY(!state.isActive());
+    QVERIFY(!state.isEnabled());
+}
+
+void SystemdUnitsTest::activeStateChange() {
+    SystemdUnits units(QDBusConnection::sessionBus(), kService);
+    QSignalSpy spy(&units, &SystemdUnits::unitChanged);
+    units.watch({"bluetooth.service"});
+    QVERIFY(m_manager->calls("Subscribe") > 0);
+    // A call after watch() returns only once the bus has its match rules
+    units.state("bluetooth.service");
+
+    m_manager->setActiveState("bluetooth.service", "inactive", "dead");
+
+    QVERIFY(spy.wait());
+    QCOMPARE(spy.first().at(0).toString(), QString("bluetooth.service"));
+    const SystemdUnits::UnitState state = spy.first().at(1).value<SystemdUnits::UnitState>();
+    QCOMPARE(state.activeState, QString("inactive"));
+    QCOMPARE(state.unitFileState, QString("enabled"));
+}
+
+void SystemdUnitsTest::unitFileChange() {
+    SystemdUnits units(QDBusConnection::sessionBus(), kService);
+    QSignalSpy spy(&units, &SystemdUnits::unitChanged);
+    units.watch({"bluetooth.service", "snapd.socket"});
+    units.state("bluetooth.service");
+
+    m_manager->setUnitFileState("bluetooth.service", "disabled");
+
+    QVERIFY(spy.wait());
+    QCOMPARE(spy.size(), 1);
+    QCOMPARE(spy.first().at(0).toString(), QString("bluetooth.service"));
+    const SystemdUnits::UnitState state = spy.first().at(1).value<SystemdUnits::UnitState>();
+    QVERIFY(!state.isEnabled());
+    QVERIFY(state.isActive());
+}
+
+QTEST_GUILESS_MAIN(SystemdUnitsTest)
+
+#include "systemd_units_test.moc"
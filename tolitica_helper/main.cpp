@@ -0,0 +1,31 @@
+#include <QCoreApplication>
+#include <QDBusConnection>
+#include <QDBusError>
+#include <QDebug>
+#include "tolitica_helper.h"
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication a(argc, argv);
+
+    QDBusConnection bus = QDBusConnection::systemBus();
+    if (!bus.isConnected()) {
+        qWarning() << "Cannot connect to the system bus:" << bus.lastError().message();
+        return 1;
+    }
+
+    // Started by D-Bus activation; quits by itself once idle.
+    ToliticaHelper helper;
+    if (!bus.registerObject(ToliticaHelper::objectPath(), &helper,
+                            QDBusConnection::ExportScriptableSlots |
+                            QDBusConnection::ExportScriptableSignals)) {
+        qWarning() << "Cannot register helper object:" << bus.lastError().message();
+        return 1;
+    }
+    if (!bus.registerService(ToliticaHelper::serviceName())) {
+        qWarning() << "Cannot own" << ToliticaHelper::serviceName() << ":" << bus.lastError().message();
+        return 1;
+    }
+
+    return a.exec();
+}
@@ -0,0 +1,376 @@
+#include "tolitica_helper.h"
+#include "polkit_authority.h"
+
+#include <QCoreApplication>
+#include <QDBusConnection>
+#include <QDBusMessage>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QProcess>
+#include <QSaveFile>
+#include <QDebug>
+
+#include <alpm.h>
+#include <cstdlib>
+
+namespace {
+// Exit once nobody has called for a while; D-Bus starts us again on demand.
+const int kIdleTimeoutMs = 60 * 1000;
+
+// How long CheckAuthorization may wait for the user to type a password.
+const int kAuthTimeoutMs = 5 * 60 * 1000;
+}
+
+ToliticaHelper::ToliticaHelper(QObject *parent)
+    : QObject(parent)
+{
+    PolkitAuthority::registerTypes();
+
+    m_idleTimer.setSingleShot(true);
+    m_idleTimer.setInterval(kIdleTimeoutMs);
+    connect(&m_idleTimer, &QTimer::timeout, qApp, &QCoreApplication::quit);
+    m_idleTimer.start();
+}
+
+///////////////////////////////////////////////////
+/// CAPABILITIES
+//////////////////////////////////////////////////
+bool ToliticaHelper::capabilityFor(const QString &name, Capability *capability) {
+    if (name == "packages") {
+        capability->actionId = "org.xray.tolitica.helper.packages";
+        capability->programs = {"pacman", "pacman-key"};
+        capability->paths = {"/etc/pacman.conf", "/etc/pacman.d/", "/etc/xray/tolitica/",
+                             "/var/cache/pacman/pkg/"};
+        return true;
+    }
+    if (name == "os-release") {
+        capability->actionId = "org.xray.tolitica.helper.os-release";
+        capability->programs = {};
+        capability->paths = {"/usr/lib/os-release"};
+        return true;
+    }
+    if (name == "automount") {
+        capability->actionId = "org.xray.tolitica.helper.automount";
+        capability->programs = {};
+        capability->paths = {"/etc/ada/tolitica/automount/"};
+        return true;
+    }
+    if (name == "services") {
+        capability->actionId = "org.xray.tolitica.helper.services";
+        capability->programs = {"systemctl"};
+        capability->paths = {};
+        return true;
+    }
+    return false;
+}
+
+bool ToliticaHelper::pathAllowed(const Capability &capability, const QString &path) {
+    if (!QDir::isAbsolutePath(path)) {
+        return false;
+    }
+    const QString clean = QDir::cleanPath(path);
+    for (const QString &allowed : capability.paths) {
+        if (allowed.endsWith('/') ? clean.startsWith(allowed) : clean == allowed) {
+            return true;
+        }
+    }
+    return false;
+}
+
+///////////////////////////////////////////////////
+/// POLKIT
+//////////////////////////////////////////////////
+bool ToliticaHelper::authorize(const QString &actionId, QString *error) {
+    const QDBusMessage check = PolkitAuthority::checkAuthorization(message().service(), actionId);
+    const QDBusMessage reply = QDBusConnection::systemBus().call(check, QDBus::Block, kAuthTimeoutMs);
+    return PolkitAuthority::isAuthorized(reply, actionId, error);
+}
+
+///////////////////////////////////////////////////
+/// EXECUTE
+//////////////////////////////////////////////////
+QString ToliticaHelper::Execute(const QString &capabilityName, const QVariantList &steps) {
+    m_idleTimer.stop();
+
+    QString output;
+    QString error;
+    Capability capability;
+
+    if (!capabilityFor(capabilityName, &capability)) {
+        error = "Unknown capability: " + capabilityName;
+    } else if (authorize(capability.actionId, &error)) {
+        const QString client = message().service();
+        for (int i = 0; i < steps.size(); ++i) {
+            emit StepStarted(client, uint(i), uint(steps.size()));
+
+            const QVariantMap step = qdbus_cast<QVariantMap>(steps.at(i));
+            if (!runStep(capability, step, &output, &error)) {
+                error = QString("Step %1 (%2) failed: %3")
+                            .arg(i + 1).arg(step.value("op").toString(), error);
+                break;
+            }
+        }
+    }
+
+    m_idleTimer.start();
+
+    if (!error.isEmpty()) {
+        qWarning() << error;
+        sendErrorReply(QDBusError::Failed, error + (output.isEmpty() ? QString() : "\n" + output));
+    }
+    return output;
+}
+
+bool ToliticaHelper::runStep(const Capability &capability, const QVariantMap &step,
+                             QString *output, QString *error) {
+    const QString op = step.value("op").toString();
+    const QString path = step.value("path").toString();
+
+    // * -run a whitelisted program-
+    if (op == "run") {
+        const QString program = step.value("program").toString();
+        if (!capability.programs.contains(program)) {
+            *error = program + " is not allowed here";
+            return false;
+        }
+
+        QProcess process;
+        process.setProcessChannelMode(QProcess::MergedChannels);
+        process.start("/usr/bin/" + program, step.value("arguments").toStringList());
+        process.waitForFinished(-1);
+        output->append(QString::fromLocal8Bit(process.readAll()));
+
+        if (process.exitStatus() != QProcess::NormalExit || process.exitCode() != 0) {
+            *error = QString("%1 exited with %2").arg(program).arg(process.exitCode());
+            return false;
+        }
+        return true;
+    }
+
+    // * -remove orphaned dependencies-
+    if (op == "removeOrphans") {
+        if (!capability.programs.contains("pacman")) {
+            *error = "pacman is not allowed here";
+            return false;
+        }
+
+        QProcess query;
+        query.start("/usr/bin/pacman", QStringList() << "-Qtdq");
+        query.waitForFinished(-1);
+        const QStringList orphans = QString::fromLocal8Bit(query.readAllStandardOutput())
+                                        .split('\n', Qt::SkipEmptyParts);
+        if (orphans.isEmpty()) {
+            return true;
+        }
+
+        QVariantMap remove;
+        remove.insert("op", "run");
+        remove.insert("program", "pacman");
+        remove.insert("arguments", QStringList() << "-Rns" << "--noconfirm" << orphans);
+        return runStep(capability, remove, output, error);
+    }
+
+    // * -remove packages in a single ALPM transaction-
+    if (op == "removePackages") {
+        if (!capability.programs.contains("pacman")) {
+            *error = "package removal is not allowed here";
+            return false;
+        }
+        return removePackages(step.value("packages").toStringList(), output, error);
+    }
+
+    // Everything below touches files, so check the path(s) first
+    if (!pathAllowed(capability, path)) {
+        *error = path + " is outside this capability";
+        return false;
+    }
+
+    // * -write a whole file-
+    if (op == "write") {
+        return writeFileAtomically(path, step.value("content").toByteArray(), error);
+    }
+
+    // * -literal find/replace, like sed 's/from/to/g'-
+    if (op == "replaceText") {
+        const QString from = step.value("from").toString();
+        const QString to = step.value("to").toString();
+        return editFile(path, [&](const QString &content) {
+            return QString(content).replace(from, to);
+        }, error);
+    }
+
+    // * -rewrite KEY=... lines, like sed 's/^KEY=.*/KEY=value/'-
+    if (op == "setKey") {
+        const QString prefix = step.value("key").toString() + "=";
+        const QString line = prefix + step.value("value").toString();
+        return editFile(path, [&](const QString &content) {
+            QStringList lines = content.split('\n');
+            for (QString &current : lines) {
+                if (current.startsWith(prefix)) {
+                    current = line;
+                }
+            }
+            return lines.join('\n');
+        }, error);
+    }
+
+    // * -copy one allowed file over another-
+    if (op == "copy") {
+        const QString target = step.value("target").toString();
+        if (!pathAllowed(capability, target)) {
+            *error = target + " is outside this capability";
+            return false;
+        }
+
+        QFile source(path);
+        if (!source.open(QIODevice::ReadOnly)) {
+            *error = "Cannot read " + path + ": " + source.errorString();
+            return false;
+        }
+        return writeFileAtomically(target, source.readAll(), error);
+    }
+
+    // * -create a directory-
+    if (op == "mkdir") {
+        if (!QDir().mkpath(path)) {
+            *error = "Cannot create " + path;
+            return false;
+        }
+        return true;
+    }
+
+    // * -remove a file-
+    if (op == "remove") {
+        if (QFileInfo::exists(path) && !QFile::remove(path)) {
+            *error = "Cannot remove " + path;
+            return false;
+        }
+        return true;
+    }
+
+    *error = "Unknown step";
+    return false;
+}
+
+///////////////////////////////////////////////////
+/// PACKAGES
+//////////////////////////////////////////////////
+bool ToliticaHelper::removePackages(const QStringList &packages, QString *output, QString *error) {
+    if (packages.isEmpty()) {
+        return true;
+    }
+
+    alpm_errno_t err;
+    alpm_handle_t *handle = alpm_initialize("/", "/var/lib/pacman/", &err);
+    if (!handle) {
+        *error = QString("Cannot open the pacman database: ") + alpm_strerror(err);
+        return false;
+    }
+
+    // Same log and hooks a `pacman -R` would use
+    alpm_option_set_logfile(handle, "/var/log/pacman.log");
+    alpm_option_add_hookdir(handle, "/usr/share/libalpm/hooks/");
+    alpm_option_add_hookdir(handle, "/etc/pacman.d/hooks/");
+
+    // -n: don't keep .pacsave files, like the `pacman -Rns` this replaces.
+    // The database lock is taken here and held for the whole removal.
+    if (alpm_trans_init(handle, ALPM_TRANS_FLAG_NOSAVE) != 0) {
+        *error = QString("Cannot start transaction: ") + alpm_strerror(alpm_errno(handle));
+        alpm_release(handle);
+        return false;
+    }
+
+    auto transact = [&]() -> bool {
+        alpm_db_t *localDb = alpm_get_localdb(handle);
+        for (const QString &name : packages) {
+            alpm_pkg_t *pkg = alpm_db_get_pkg(localDb, name.toUtf8().constData());
+            if (!pkg) {
+                continue; // already gone
+            }
+            if (alpm_remove_pkg(handle, pkg) != 0) {
+                *error = QString("Cannot remove %1: %2").arg(name, alpm_strerror(alpm_errno(handle)));
+                return false;
+            }
+        }
+
+        alpm_list_t *data = nullptr;
+        if (alpm_trans_prepare(handle, &data) != 0) {
+            *error = QString("Cannot prepare removal: ") + alpm_strerror(alpm_errno(handle));
+            // Unsatisfied dependencies come back as alpm_depmissing_t
+            if (alpm_errno(handle) == ALPM_ERR_UNSATISFIED_DEPS) {
+                for (alpm_list_t *i = data; i; i = alpm_list_next(i)) {
+                    alpm_depmissing_t *missing = static_cast<alpm_depmissing_t *>(i->data);
+                    char *depstring = alpm_dep_compute_string(missing->depend);
+                    error->append(QString("\n  %1 requires %2").arg(missing->target, depstring));
+                    free(depstring);
+                    alpm_depmissing_free(missing);
+                }
+            }
+            alpm_list_free(data);
+            return false;
+        }
+
+        if (alpm_trans_commit(handle, &data) != 0) {
+            *error = QString("Cannot commit removal: ") + alpm_strerror(alpm_errno(handle));
+            FREELIST(data);
+            return false;
+        }
+        return true;
+    };
+
+    bool success = transact();
+    if (success) {
+        output->append(QString("Removed %1 packages: %2\n").arg(packages.size()).arg(packages.join(' ')));
+    }
+
+    alpm_trans_release(handle);
+    alpm_release(handle);
+    return success;
+}
+
+///////////////////////////////////////////////////
+/// FILES
+//////////////////////////////////////////////////
+bool ToliticaHelper::writeFileAtomically(const QString &path, const QByteArray &content,
+                                         QString *error) {
+    // Keep the mode of the file being replaced (new files get 0644)
+    const bool existed = QFileInfo::exists(path);
+    const QFile::Permissions permissions = existed ? QFile::permissions(path)
+        : (QFile::ReadOwner | QFile::WriteOwner | QFile::ReadGroup | QFile::ReadOther);
+
+    QDir().mkpath(QFileInfo(path).absolutePath());
+
+    // The temporary file gets its mode before commit() syncs it and renames
+    // it over the target, so watchers see a single, complete replacement.
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        *error = "Cannot write " + path + ": " + file.errorString();
+        return false;
+    }
+    file.setPermissions(permissions);
+    file.write(content);
+    if (!file.commit()) {
+        *error = "Cannot write " + path + ": " + file.errorString();
+        return false;
+    }
+    return true;
+}
+
+bool ToliticaHelper::editFile(const QString &path,
+                              const std::function<QString(const QString &)> &edit,
+                              QString *error) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        *error = "Cannot read " + path + ": " + file.errorString();
+        return false;
+    }
+    const QString before = QString::fromUtf8(file.readAll());
+    file.close();
+
+    const QString after = edit(before);
+    if (after == before) {
+        return true;
+    }
+    return writeFileAtomically(path, after.toUtf8(), error);
+}
@@ -0,0 +1,63 @@
+#ifndef TOLITICA_HELPER_H
+#define TOLITICA_HELPER_H
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QVariantList>
+#include <QVariantMap>
+#include <QTimer>
+#include <QDBusContext>
+#include <functional>
+
+// Root side of Tolitica's privileged operations. Runs on the system bus as
+// org.xray.tolitica.Helper, started on demand by D-Bus activation.
+//
+// A caller hands Execute() a capability name and a batch of steps. The
+// caller is authorized once for the capability's polkit action
+// (auth_admin_keep, so a session is not asked again for a few minutes),
+// then every step runs in this process: file edits and writes are done
+// directly, only programs like pacman are spawned. A capability also limits
+// which programs and paths its steps may touch.
+class ToliticaHelper : public QObject, protected QDBusContext
+{
+    Q_OBJECT
+    Q_CLASSINFO("D-Bus Interface", "org.xray.tolitica.Helper")
+
+public:
+    explicit ToliticaHelper(QObject *parent = nullptr);
+
+    static const char *serviceName() { return "org.xray.tolitica.Helper"; }
+    static const char *objectPath() { return "/org/xray/tolitica/Helper"; }
+
+public slots:
+    // Runs the steps in order and stops at the first failure. Returns the
+    // collected program output; failures come back as a D-Bus error.
+    Q_SCRIPTABLE QString Execute(const QString &capability, const QVariantList &steps);
+
+signals:
+    // Lets the caller (identified by its unique bus name) show progress.
+    Q_SCRIPTABLE void StepStarted(const QString &client, uint index, uint total);
+
+private:
+    struct Capability {
+        QString actionId;
+        QStringList programs;
+        QStringList paths;      // files, or directories when ending in '/'
+    };
+
+    static bool capabilityFor(const QString &name, Capability *capability);
+    bool authorize(const QString &actionId, QString *error);
+    bool runStep(const Capability &capability, const QVariantMap &step, QString *output, QString *error);
+
+    static bool removePackages(const QStringList &packages, QString *output, QString *error);
+
+    static bool pathAllowed(const Capability &capability, const QString &path);
+    static bool writeFileAtomically(const QString &path, const QByteArray &content, QString *error);
+    static bool editFile(const QString &path, const std::function<QString(const QString &)> &edit,
+                         QString *error);
+
+    QTimer m_idleTimer;
+};
+
+#endif // TOLITICA_HELPER_H
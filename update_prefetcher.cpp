@@ -0,0 +1,220 @@
+#include "update_prefetcher.h"
+
+#include <QProcess>
+#include <QSettings>
+#include <QStandardPaths>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSet>
+#include <QDebug>
+
+#include <signal.h>
+
+namespace {
+const char *const kSystemCache = "/var/cache/pacman/pkg";
+const char *const kSystemLocalDb = "/var/lib/pacman/local";
+const char *const kSettingKey = "updates/prefetch";
+const int kIntervalMs = 4 * 60 * 60 * 1000;
+
+QString shellQuote(const QString &value) {
+    QString quoted = value;
+    quoted.replace('\'', "'\\''");
+    return "'" + quoted + "'";
+}
+}
+
+UpdatePrefetcher::UpdatePrefetcher(QObject *parent)
+    : QObject(parent)
+{
+    m_timer.setInterval(kIntervalMs);
+    connect(&m_timer, &QTimer::timeout, this, &UpdatePrefetcher::prefetch);
+}
+
+UpdatePrefetcher::~UpdatePrefetcher() {
+    stop();
+}
+
+///////////////////////////////////////////////////
+/// SETTINGS
+//////////////////////////////////////////////////
+bool UpdatePrefetcher::isEnabled() {
+    return QSettings("Xray_OS", "Tolitica").value(kSettingKey, false).toBool();
+}
+
+void UpdatePrefetcher::setEnabled(bool enabled) {
+    QSettings("Xray_OS", "Tolitica").setValue(kSettingKey, enabled);
+}
+
+QString UpdatePrefetcher::baseDir() {
+    return QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation) + "/tolitica/prefetch";
+}
+
+QString UpdatePrefetcher::dbDir() {
+    return baseDir() + "/db";
+}
+
+QString UpdatePrefetcher::packageDir() {
+    return baseDir() + "/pkg";
+}
+
+QString UpdatePrefetcher::cacheArguments() {
+    return QString("--cachedir %1 --cachedir %2").arg(kSystemCache, shellQuote(packageDir()));
+}
+
+QString UpdatePrefetcher::idle(const QString &pacmanArguments) {
+    return "LC_ALL=C chrt --idle 0 ionice -c3 fakeroot -- pacman " + pacmanArguments
+        + " --dbpath " + shellQuote(dbDir()) + " --logfile /dev/null";
+}
+
+///////////////////////////////////////////////////
+/// PREFETCH
+//////////////////////////////////////////////////
+void UpdatePrefetcher::start() {
+    m_timer.start();
+    prefetch();
+}
+
+void UpdatePrefetcher::stop() {
+    m_timer.stop();
+    if (m_process) {
+        m_process->disconnect(this);
+        // The shell leads its own process group (see prefetch()), so pacman,
+        // fakeroot's daemon and the rest go with it
+        if (m_process->processId() > 0) {
+            ::kill(-pid_t(m_process->processId()), SIGKILL);
+        }
+        m_process->kill();
+        m_process->waitForFinished(3000);
+        m_process->deleteLater();
+        m_process = nullptr;
+    }
+}
+
+bool UpdatePrefetcher::prepareDatabase() {
+    // The private dbpath shares the real local database (read only) and keeps
+    // its own sync databases, so the system's are never touched without root
+    if (!QDir().mkpath(dbDir()) || !QDir().mkpath(packageDir())) {
+        qWarning() << "Cannot create prefetch directories under" << baseDir();
+        return false;
+    }
+
+    const QString localLink = dbDir() + "/local";
+    if (!QFileInfo(localLink).isSymLink() && !QFile::link(kSystemLocalDb, localLink)) {
+        qWarning() << "Cannot link" << localLink << "to" << kSystemLocalDb;
+        return false;
+    }
+
+    // Only our own prefetch uses this database; a lock left by one that was
+    // killed would block every later run. One that is still running (e.g.
+    // from another Tolitica) keeps it, and this round is skipped.
+    const QString lock = dbDir() + "/db.lck";
+    if (QFileInfo::exists(lock)) {
+        if (databaseInUse()) {
+            qDebug() << "Another update prefetch is still running";
+            return false;
+        }
+        QFile::remove(lock);
+    }
+    return true;
+}
+
+// Whether any process runs pacman on the private dbpath
+bool UpdatePrefetcher::databaseInUse() {
+    const QStringList pids = QDir("/proc").entryList(QDir::Dirs | QDir::NoDotAndDotDot);
+    for (const QString &pid : pids) {
+        QFile cmdline("/proc/" + pid + "/cmdline");
+        if (!cmdline.open(QIODevice::ReadOnly)) {
+            continue;
+        }
+        const QList<QByteArray> arguments = cmdline.readAll().split('\0');
+        const int dbPath = arguments.indexOf("--dbpath");
+        if (dbPath >= 0 && dbPath + 1 < arguments.size()
+            && QFile::decodeName(arguments.at(dbPath + 1)) == dbDir()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void UpdatePrefetcher::prefetch() {
+    if (m_process || !prepareDatabase()) {
+        return;
+    }
+
+    // Downloads go to the first writable cache dir, the private one; packages
+    // already in the system cache are reused
+    const QString command = idle("-Sy") + " && "
+        + idle("-Swu --noconfirm --cachedir " + shellQuote(packageDir())
+               + " --cachedir " + kSystemCache);
+
+    m_process = new QProcess(this);
+    connect(m_process, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished), this,
+            [this](int exitCode, QProcess::ExitStatus status) {
+        if (status != QProcess::NormalExit || exitCode != 0) {
+            qDebug() << "Update prefetch failed:" << m_process->readAllStandardError();
+        }
+        m_process->deleteLater();
+        m_process = nullptr;
+        refresh();
+    });
+    // setsid makes the shell a process group leader, so stop() can kill the
+    // whole pipeline and not just the shell
+    m_process->start("setsid", QStringList() << "bash" << "-c" << command);
+}
+
+///////////////////////////////////////////////////
+/// STAGED PACKAGES
+//////////////////////////////////////////////////
+void UpdatePrefetcher::refresh() {
+    if (!QFileInfo::exists(dbDir() + "/sync")) {
+        return;
+    }
+
+    // File name and size of every pending upgrade, per the private databases
+    QProcess *pending = new QProcess(this);
+    connect(pending, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished), this,
+            [this, pending](int exitCode, QProcess::ExitStatus) {
+        const QStringList lines = QString::fromLocal8Bit(pending->readAllStandardOutput())
+                                      .split('\n', Qt::SkipEmptyParts);
+        pending->deleteLater();
+        if (exitCode != 0) {
+            return;
+        }
+
+        QSet<QString> wanted;
+        int packages = 0;
+        qint64 bytes = 0;
+        for (const QString &line : lines) {
+            const QString fileName = line.section(' ', 0, 0);
+            wanted.insert(fileName);
+            wanted.insert(fileName + ".sig");
+
+            if (QFileInfo::exists(packageDir() + "/" + fileName)
+                || QFileInfo::exists(QString(kSystemCache) + "/" + fileName)) {
+                packages++;
+                bytes += line.section(' ', 1, 1).toLongLong();
+            }
+        }
+
+        // Whatever isn't pending any more (installed or superseded) goes,
+        // unless a prefetch is still writing into the cache
+        if (!m_process) {
+            QDir cache(packageDir());
+            for (const QString &name : cache.entryList(QDir::Files)) {
+                if (!wanted.contains(name)) {
+                    cache.remove(name);
+                }
+            }
+        }
+
+        m_stagedPackages = packages;
+        m_stagedBytes = bytes;
+        emit stagedChanged(packages, bytes);
+    });
+
+    // -p only prints, so no fakeroot needed
+    pending->start("bash", QStringList() << "-c"
+                   << "LC_ALL=C pacman -Sup --print-format '%f %s' --dbpath "
+                          + shellQuote(dbDir()) + " --logfile /dev/null");
+}
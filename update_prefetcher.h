@@ -0,0 +1,59 @@
+#ifndef UPDATE_PREFETCHER_H
+#define UPDATE_PREFETCHER_H
+
+#include <QObject>
+#include <QString>
+#include <QTimer>
+
+class QProcess;
+
+// Optional background prefetch of pending updates. While the assistant is open
+// (and again every few hours) it refreshes a private copy of the sync
+// databases and downloads the pending packages into a private cache, both
+// under idle CPU/IO scheduling and without root (fakeroot, like checkupdates).
+// systemUpdate() passes that cache to pacman with cacheArguments(), so an
+// update only downloads what changed since the last prefetch.
+class UpdatePrefetcher : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit UpdatePrefetcher(QObject *parent = nullptr);
+    ~UpdatePrefetcher();
+
+    // User setting, off by default
+    static bool isEnabled();
+    static void setEnabled(bool enabled);
+
+    // "--cachedir <system> --cachedir <prefetch>" for pacman -Su; downloads
+    // still land in the system cache
+    static QString cacheArguments();
+
+    void start();      // prefetch now and then on the timer
+    void stop();       // also aborts a running prefetch
+    void refresh();    // recount what is staged, e.g. after an update
+
+    int stagedPackages() const { return m_stagedPackages; }
+    qint64 stagedBytes() const { return m_stagedBytes; }
+
+signals:
+    void stagedChanged(int packages, qint64 bytes);
+
+private slots:
+    void prefetch();
+
+private:
+    static QString baseDir();
+    static QString dbDir();
+    static QString packageDir();
+    static QString idle(const QString &pacmanArguments);
+    bool prepareDatabase();
+    static bool databaseInUse();
+
+    QTimer m_timer;
+    QProcess *m_process = nullptr;
+    int m_stagedPackages = 0;
+    qint64 m_stagedBytes = 0;
+};
+
+#endif // UPDATE_PREFETCHER_H
@@ -16,54 +16,20 @@
 #include <QLabel>
 #include <QCheckBox>
 #include <QToolButton>
+#include <QSignalBlocker>
+#include <QLocale>
 #include <cstddef>
 
 // CUSTOM CLASSES
 #include "core_functions.h"
+#include "core_services.h"
 #include "calamares_page.h"
 #include "connectivityChecker.h"
-
-void Widget::cleanCache() {
-    QProcess checkIssues;
-    checkIssues.start("bash", QStringList() << "-c" << "pacman -Sy --dbonly");
-    checkIssues.waitForFinished();
-    QString dbSyncErrors = checkIssues.readAllStandardError();
-
-    bool dbNotSynced = !dbSyncErrors.isEmpty();
-
-    QDir pkgCacheDir("/var/cache/pacman/pkg");
-    bool cacheExists = pkgCacheDir.exists() && !pkgCacheDir.isEmpty();
-
-    if (cacheExists) {
-        // Check for PKG corruption
-        checkIssues.start("bash", QStringList() << "-c" << "pacman -Qk");
-        checkIssues.waitForFinished();
-
-        if (dbNotSynced || cacheExists ) {
-            qDebug() << "Issues detected! Cleaning package cache.";
-            QProcess cleanup;
-
-            if (dbNotSynced) {
-                cleanup.start("pkexec", QStringList() << "bash" << "-c" << "pacman -Sy");
-                cleanup.waitForFinished();
-
-                if (cleanup.exitCode() != 0) {
-                    qDebug() << "Cleanup errors(pacman -Sy): " << cleanup.readAllStandardError();
-                }
-            }
-        if (dbNotSynced) {
-            cleanup.start("pkexec", QStringList() << "bash" << "-c" << "sudo rm -rf /var/cache/pacman/pkg/* && sudo pacman -Scc --noconfirm");
-            cleanup.waitForFinished();
-        }
-
-            qDebug() << "Cleanup output:" << cleanup.readAllStandardOutput();
-            qDebug() << "Cleanup erros:" << cleanup.readAllStandardError();
-
-        } else {
-            qDebug() << "System database and package cache are fine!";
-        }
-    }
-}
+#include "package_database.h"
+#include "system_facts.h"
+#include "systemd_units.h"
+#include "privileged_helper.h"
+#include "progress_model.h"
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
 /// FUNCTIONS FOR THE TWEAKS PAGE /////////////////////// /////////////////////// ////////////////
@@ -74,23 +40,15 @@ void Widget::cleanCache() {
 //////////////////////////////////////////////////
 void Widget::cleanOrphans() {
     // Check if there are orphans to clean
-    QProcess checkOrphans;
-    checkOrphans.start("bash", QStringList() << "-c" << "pacman -Qtdq");
-    checkOrphans.waitForFinished();
-
-    QString orphanOutput = checkOrphans.readAllStandardOutput().trimmed();
+    const QStringList orphans = PackageDatabase::instance().orphans();
 
-    if(orphanOutput.isEmpty()) {
+    if(orphans.isEmpty()) {
         QMessageBox::information(this, "No orphans Found", "There are no orphaned packages to clean!");
         return; // Exit fucntion early if nothing to remove
     }
 
     // Check if yay is installed
-    QProcess checkYayProcess;
-    checkYayProcess.start("bash", QStringList() << "-c" << "pacman -Q yay");
-    checkYayProcess.waitForFinished();
-
-    bool yayInstalled = (checkYayProcess.exitCode() == 0);
+    bool yayInstalled = PackageDatabase::instance().isInstalled("yay");
 
     // Create the command
     QStringList args;
@@ -98,7 +56,7 @@ void Widget::cleanOrphans() {
         args << "bash" << "-c" << "yay -Yc --noconfirm && "
                 "pkexec pacman -Rns $(pacman -Qtdq) --noconfirm";
     } else {
-        args << "bash" << "-c" << "pacman -Rns $(pacman -Qtdq) --noconfirm";
+        args << "bash" << "-c" << "pacman -Rns " + orphans.join(' ') + " --noconfirm";
     }
 
     // Run the cleanup process
@@ -175,7 +133,9 @@ void Widget::cleanPkgCache() {
 //////////////////////////////////////////////////
 void Widget::systemUpdate() {
     QProcess *sysUp = new QProcess(this);
-    QTimer *monitorTimer = new QTimer(this); // High-frequency monitoring
+
+    // The prefetch must not race the real transaction; its cache is used below
+    m_updatePrefetcher->stop();
 
     // Create the process bar dynamically
     QProgressDialog *progress = new QProgressDialog("Updating system...", nullptr, 0, 100, this);
@@ -184,54 +144,39 @@ void Widget::systemUpdate() {
     progress->setValue(0); // Ensure it starts at 0
     progress->show();
 
-    QCoreApplication::processEvents(); // Forces immediate rendering before the process starts
-
-    int progressValue = 0;
-
-    // Updating the progress value when a new started output is available.
-    connect(sysUp, &QProcess::readyReadStandardOutput, this, [=]() mutable {
-        progressValue += 5;
-        progress->setValue(qMin(progressValue, 95));
-        QCoreApplication::processEvents(); // Ensure progress updates properly
-    });
-
-    // Using monitorTimer to simulate progress updates if process output is insufficient
-    connect(monitorTimer, &QTimer::timeout, this, [=]() mutable {
-        if (progressValue < 95) {
-            progressValue += 2;
-            progress->setValue(qMin(progressValue, 95));
-        }
-    });
-    monitorTimer->start(250);
+    // Progress follows pacman's own output
+    ProgressModel *model = new ProgressModel(progress);
+    model->attach(progress);
+    model->follow(sysUp);
 
     // Detect when process finishes
     connect(sysUp, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished), this, [=] (int exitCode,
     QProcess::ExitStatus status) {
-        monitorTimer->stop();
+        model->finish();
 
-        QString output = QString::fromUtf8(sysUp->readAllStandardOutput());
+        QString output = model->transcript();
         if (output.contains("Nothing to do") && output.contains("there is nothing to do")) {
             QMessageBox::information(nullptr, "System Already Upto Date", "No updates were found");
         } else {
-            progress->setValue(100);
             QMessageBox::information(nullptr, "Xray_OS Has Been Updated", "Your Operating System has been updated successfully");
-            progress->setValue(100);
         }
 
         // Cleanup Memory
         progress->deleteLater();
         sysUp->deleteLater();
-        monitorTimer->deleteLater(); // Stop aggressive monitoring
 
+        if (UpdatePrefetcher::isEnabled()) {
+            m_updatePrefetcher->start();
+        } else {
+            m_updatePrefetcher->refresh();
+        }
     });
 
     // Adding a little delay to ensure UI stability before starting the process
     QTimer::singleShot(150, this, [=]() {
-        // Start update process
-        sysUp->start("pkexec", QStringList() << "bash" << "-c" << "pacman -Syu --noconfirm && flatpak update --assumeyes");
-
-        // Start aggressive monitoring
-        monitorTimer->start(250); // Updates every 250ms
+        sysUp->start("pkexec", QStringList() << "bash" << "-c"
+                     << ProgressModel::pacmanCommand("-Syu --noconfirm " + UpdatePrefetcher::cacheArguments())
+                        + " && flatpak update --assumeyes");
     });
 
 }
@@ -326,7 +271,6 @@ void Widget::archZGamingMeta() {
     }
 
     QProcess *installAGM = new QProcess(this);
-    QTimer *monitorTimer = new QTimer(this); // High-frequency monitoring
 
     // Create the progress bar dynamically
     QProgressDialog *progress = new QProgressDialog("Installing Arch7z Gaming Meta...", nullptr, 0, 100, this);
@@ -334,36 +278,30 @@ void Widget::archZGamingMeta() {
     progress->setCancelButton(nullptr);
     progress->show();
 
-    int progressValue = 0;
+    ProgressModel *model = new ProgressModel(progress);
+    model->attach(progress);
+    model->follow(installAGM);
 
-    // Fix: Real-time progress update using process output
-    connect(installAGM, &QProcess::readyReadStandardOutput, this, [=]() mutable {
-        // Adjust progress dynamically based on output
-        progressValue += 5;
-        progress->setValue(qMin(progressValue, 95));
-        QCoreApplication::processEvents(); // Ensure UI refresh
-    });
+    const QString installCommand = ProgressModel::pacmanCommand("-S arch7z-gaming-meta --noconfirm");
+    bool retried = false;
 
     // Combined finished signal handling
     connect(installAGM, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished),
             this, [=](int exitCode, QProcess::ExitStatus status) mutable {
-                // If installation failed, try to clean the cache and reinstall
-                if (exitCode != 0) {
-                    QProcess fix(this);
-                    fix.start("pkexec", QStringList() << "pacman -Scc --noconfirm");
-                    fix.waitForFinished();  // Ensure cache cleanup before retry
-                    installAGM->start("pkexec", QStringList() << "bash" << "-c" << "pacman -S arch7z-gaming-meta --noconfirm");
-                    installAGM->waitForFinished();
+                // If installation failed, clean the cache and try once more
+                if (exitCode != 0 && !retried) {
+                    retried = true;
+                    model->reset();
+                    installAGM->start("pkexec", QStringList() << "bash" << "-c"
+                                      << "pacman -Scc --noconfirm && " + installCommand);
+                    return;
                 }
+                model->finish();
 
                 // After installation (or retry), check if the package is installed
-                QProcess checkInstalled;
-                checkInstalled.start("bash", QStringList() << "-c" << "pacman -Q arch7z-gaming-meta");
-                checkInstalled.waitForFinished();
+                bool installed = PackageDatabase::instance().isInstalled("arch7z-gaming-meta");
 
-                progress->setValue(100); // Mark progress as complete
-
-                if (checkInstalled.exitCode() == 0) {
+                if (installed) {
                     QMessageBox::information(nullptr, "Arch7z Gaming Meta",
                                              "Arch7z Gaming Meta packages are installed successfully!");
                 } else {
@@ -374,15 +312,10 @@ void Widget::archZGamingMeta() {
                 // Cleanup Memory
                 progress->deleteLater();
                 installAGM->deleteLater();
-                monitorTimer->deleteLater(); // Stop aggressive monitoring
             });
 
-    // Start aggressive monitoring
-    monitorTimer->start(250); // Updates every 250ms
-
     // Start installing process
-    installAGM->start("pkexec", QStringList() << "bash" << "-c" << "pacman -S arch7z-gaming-meta --noconfirm");
-    installAGM->waitForFinished();
+    installAGM->start("pkexec", QStringList() << "bash" << "-c" << installCommand);
 }
 
 
@@ -390,69 +323,7 @@ void Widget::archZGamingMeta() {
 /// ADDONS::REMOVE ARCH7Z-GAMING-META FUNCTION
 //////////////////////////////////////////////////
 void Widget::removeArchZGamingMeta() {
-    QProcess *removeAGM = new QProcess(this);
-    QTimer *monitorTimer = new QTimer(this);
-
-    QProgressDialog *progress = new QProgressDialog("Removing Arch7z Gaming Meta...", nullptr, 0, 100, this);
-    progress->setWindowModality(Qt::WindowModal);
-    progress->setCancelButton(nullptr);
-    progress->show();
-
-    int progressValue = 0;
-
-    // Ensure yay detection
-    QProcess checkYay;
-    checkYay.start("bash", QStringList() << "-c" << "pacman -Q yay");
-    checkYay.waitForFinished();
-    bool yayInstalled = (checkYay.exitCode() == 0);
-
-    QStringList removeCommands = {
-        "pacman -R arch7z-gaming-meta --noconfirm",
-        "pacman -R steam-native-runtime --noconfirm",
-        "pacman -R steam lutris bottles dosbox goverlay heroic-games-launcher-bin portproton protonplus protonup-qt vkbasalt gamemode lib32-gamemode q4wine-git wine-gecko wine-mono wine-nine protontricks --noconfirm",
-        "pacman -R winetricks wine-staging --noconfirm",
-        "pacman -R gamescope mangohud vkd3d proton-ge-custom-bin --noconfirm",
-        "pacman -R lib32-vkd3d vkbasalt-cli reshade-shaders-git --noconfirm"
-    };
-
-    if (yayInstalled) {
-        removeCommands.append("yay -Yc --noconfirm");
-    } else {
-        removeCommands.append("pacman -Rns $(pacman -Qtdq) --noconfirm");
-    }
-
-    qDebug() << "Package removal list:";
-    for (const auto &cmd : removeCommands) {
-        qDebug() << cmd;
-    }
-
-    int currentStep = 0;
-
-    // **Loop Execution: Process Commands Sequentially**
-    connect(removeAGM, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished), this, [=]() mutable {
-        if (currentStep < removeCommands.size()) {
-            qDebug() << "Executing command:" << removeCommands[currentStep];
-
-            removeAGM->start("pkexec", QStringList() << "bash" << "-c" << removeCommands[currentStep]);
-
-            progressValue += (100 / removeCommands.size()); // Update progress dynamically
-            progress->setValue(qMin(progressValue, 95));
-            QCoreApplication::processEvents();
-
-            currentStep++; // Move to next command in sequence
-        } else {
-            qDebug() << "All packages removed successfully!";
-            progress->setValue(100);
-            QMessageBox::information(nullptr, "Arch7z Gaming Meta Removed",
-                                     "Arch7z Gaming Meta packages have been successfully removed.");
-            progress->deleteLater();
-            removeAGM->deleteLater();
-            monitorTimer->deleteLater();
-        }
-    });
-
-    removeAGM->start("pkexec", QStringList() << "bash" << "-c" << removeCommands[currentStep]); // Start first command
-    monitorTimer->start(250);
+    removeMetaPackage("arch7z-gaming-meta", "Arch7z Gaming Meta");
 }
 
 ///////////////////////////////////////////////////
@@ -507,7 +378,6 @@ void Widget::arch7zDevelopmentMeta() {
 
 
     QProcess *installADM = new QProcess(this);
-    QTimer *monitorTimer = new QTimer(this); // High-frequency monitoring
 
     // Create the progress bar dynamically
     QProgressDialog *progress = new QProgressDialog("Installing Arch7z Development Meta...", nullptr, 0, 100, this);
@@ -515,14 +385,9 @@ void Widget::arch7zDevelopmentMeta() {
     progress->setCancelButton(nullptr);
     progress->show();
 
-    int progressValue = 0;
-
-    // Real-time progress update based on process output
-    connect(installADM, &QProcess::readyReadStandardOutput, this, [=]() mutable {
-        progressValue += 5;
-        progress->setValue(qMin(progressValue, 95));
-        QCoreApplication::processEvents(); // Ensure UI refresh
-    });
+    ProgressModel *model = new ProgressModel(progress);
+    model->attach(progress);
+    model->follow(installADM);
 
     // Combined finished signal handling with cache cleanup on failure
     connect(installADM, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished),
@@ -540,13 +405,10 @@ void Widget::arch7zDevelopmentMeta() {
                 // }
 
                 // After installation (or after the retry), check if the package is installed
-                QProcess checkInstalled;
-                checkInstalled.start("bash", QStringList() << "-c" << "pacman -Q arch7z-development-meta");
-                checkInstalled.waitForFinished();
+                model->finish();
+                bool installed = PackageDatabase::instance().isInstalled("arch7z-development-meta");
 
-                progress->setValue(100); // Mark progress as complete
-
-                if (checkInstalled.exitCode() == 0) {
+                if (installed) {
                     QMessageBox::information(nullptr, "Arch7z Development Meta",
                                              "Arch7z Development Meta packages are installed successfully!");
                 } else {
@@ -557,16 +419,11 @@ void Widget::arch7zDevelopmentMeta() {
                 // Cleanup dynamic objects
                 progress->deleteLater();
                 installADM->deleteLater();
-                monitorTimer->deleteLater(); // Stop aggressive monitoring
             });
 
-    // Start aggressive monitoring of progress updates
-    monitorTimer->start(250); // Updates every 250ms
-
     // Begin the installation process
     installADM->start("pkexec", QStringList() << "bash" << "-c"
-                                              << "pacman -S arch7z-development-meta --noconfirm");
-    installADM->waitForFinished();
+                                              << ProgressModel::pacmanCommand("-S arch7z-development-meta --noconfirm"));
 }
 
 
@@ -574,366 +431,45 @@ void Widget::arch7zDevelopmentMeta() {
 /// ADDONS:: REMOVE ARCH7Z-DEVELOPMENT-META FUNCTION
 //////////////////////////////////////////////////
 void Widget::removeArch7zDevelopmentMeta() {
-    QProcess *removeADM = new QProcess(this);
-    QTimer *monitorTimer = new QTimer(this);
-
-    QProgressDialog *progress = new QProgressDialog("Removing Arch7z Development Meta...", nullptr, 0, 100,
-                                                    this);
-    progress->setWindowModality(Qt::WindowModal);
-    progress->setCancelButton(nullptr);
-    progress->show();
-
-    int progressValue = 0;
-
-    // Ensure yay detection
-    QProcess checkYay;
-    checkYay.start("bash", QStringList() << "-c" << "pacman -Q yay");
-    checkYay.waitForFinished();
-
-    bool yayInstalled = (checkYay.exitCode() == 0);
-
-    QStringList removeCommands = {
-        "pacman -R arch7z-development-meta --noconfirm",
-        "pacman -R geany-themes --noconfirm",
-        "pacman -R geany visual-studio-code-bin zed jetbrains-toolbox github-desktop sublime-text-4 --noconfirm"
-    };
-
-    if (yayInstalled) {
-        removeCommands.append("yay -Yc --noconfirm");
-    } else {
-        removeCommands.append("pacman -Rns &(pacman -Qtdq) --noconfirm");
-    }
-
-    int CurrentStep = 0;
-
-    // **Loop Execution: Process Commands Sequentially**
-    connect(removeADM, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished), this, [=]()
-            mutable {
-        if (CurrentStep <removeCommands.size()) {
-            removeADM->start("pkexec", QStringList() << "bash" << "-c" <<
-                                           removeCommands[CurrentStep]);
-
-            progressValue += (100 / removeCommands.size()); // Update progress dynamically
-            progress->setValue(qMin(progressValue, 95));
-            QCoreApplication::processEvents();
-
-            CurrentStep++; // Move to next command in sequence
-        } else {
-            progress->setValue(100);
-            QMessageBox::information(nullptr, "Arhc7z Development Meta Removed",
-                                     "Arhc7z Development Meta packages have been successfully removed");
-            progress->deleteLater();
-            removeADM->deleteLater();
-            monitorTimer->deleteLater();
-        }
-    });
-
-    removeADM->start("pkexec", QStringList() << "bash" << "-c" << removeCommands[CurrentStep]); // Start first commands
-    monitorTimer->start(250);
+    removeMetaPackage("arch7z-development-meta", "Arch7z Development Meta");
 }
 
 ///////////////////////////////////////////////////
-/// ADDONS::HELPER: Run a shell command
+/// ADDONS:: REMOVE A META PACKAGE AND WHAT IT PULLED IN
 //////////////////////////////////////////////////
-bool Widget::runCommand(const QString &cmd) {
-    QProcess process;
-    process.start("bash", QStringList() << "-c" << cmd);
-    process.waitForFinished();
-    return (process.exitCode() == 0);
-}
-
-///////////////////////////////////////////////////
-/// ADDONS:: CHECK CHAOTIC-AUR STATUS
-//////////////////////////////////////////////////
-int Widget::checkChaoticAURStatus() {
-    // Check if key is imported
-    bool keyExist = runCommand("pacman-key --list-keys 3056513887B78AEB");
-    // Check if required packages are installed
-    bool packagesInstalled = runCommand("pacman -Q chaotic-keyring chaotic-mirrorlist");
-    // Check if repository header exists in pacman.conf
-    bool repoHeaderExists = runCommand("grep -q '\\[chaotic-aur\\]' /etc/pacman.conf");
-
-    // Check if Include line exists in pacman.conf
-    bool includeLineExists = runCommand("grep -q 'Include = /etc/pacman.d/chaotic-mirrorlist' /etc/pacman.conf");
-
-    if (keyExist && packagesInstalled && repoHeaderExists && includeLineExists)
-        return 0; // Fully configured
-    else if (!keyExist && !packagesInstalled && !repoHeaderExists && !includeLineExists)
-        return 1; // Not set up
-    else
-        return 2; // Partial setup (repair needed)
-}
-
-///////////////////////////////////////////////////
-/// ADDONS:: BACKUP PACMAN CONFIG FUNCTION
-//////////////////////////////////////////////////
-void Widget::backupPacmanConfig() {
-    // Always backup before modifications
-    QProcess createBackupDir;
-    createBackupDir.start("pkexec", QStringList() << "bash" << "-c"
-                                                  << "mkdir -p /etc/xray/tolitica/tolitica-settings/backups");
-    createBackupDir.waitForFinished();
-    QString errOut = createBackupDir.readAllStandardError();
-
-    if (!errOut.isEmpty()) {
-        QMessageBox::warning(this, "Backup Error", "Failed to create backup directory:\n" + errOut);
-    }
-
-    // Create backup if the current /etc/pacman.conf differs from the backup
-    QProcess backupCheck;
-    QString backupCmd = "cmp -s /etc/pacman.conf /etc/xray/tolitica/tolitica-settings/backups/pacman.conf || pkexec cp /etc/pacman.conf /etc/xray/tolitica/tolitica-settings/backups/";
-    backupCheck.start("bash", QStringList() << "-c" << backupCmd);
-    backupCheck.waitForFinished();
-}
-
-///////////////////////////////////////////////////
-/// ADDONS:: REMOVE-CHAOTIC-AUR
-//////////////////////////////////////////////////
-void Widget::removeChaoticAUR() {
-    QProcess removeProc;
-    removeProc.start("pkexec", QStringList() << "bash" << "-c" << "sed -i '/\\[chaotic-aur\\]/,+1d' /etc/pacman.conf && "
-                                                                  "pkexec pacman -Rns chaotic-keyring chaotic-mirrorlist --noconfirm && "
-                                                                  "pkexec pacman-key --delete 3056513887B78AEB");
-    removeProc.waitForFinished();
-
-    // Optionally delete an outdated backup file if it exists
-    if (QFile::exists("/etc/xray/tolitica/tolitica-settings/backups/pacman.conf")) {
-        QProcess delProc;
-        delProc.start("pkexec", QStringList() << "bash" << "-c" << "rm -r /etc/xray/tolitica/tolitica-settings/backups/pacman.conf");
-        delProc.waitForFinished();
+void Widget::removeMetaPackage(const QString &metaPackage, const QString &title) {
+    // The meta package, the dependencies only it needed and the orphans that
+    // leaves behind, read from the local database
+    const QStringList plan = PackageDatabase::instance().removalPlan(metaPackage);
+    if (plan.isEmpty()) {
+        QMessageBox::information(this, title, title + " is not installed.");
+        return;
     }
 
-    QString errorOutput = removeProc.readAllStandardError();
-    if (removeProc.exitCode() == 0) {
-        QMessageBox::information(this, "Chaotic AUR Removed",
-                                 "Chaotic AUR repositories have been removed successfully");
-    } else {
-        QMessageBox::warning(this, "Error", "Something went wrong removing Chaotic AUR repositories:\n" + errorOutput);
-    }
-}
+    qDebug() << "Package removal plan:" << plan;
 
-///////////////////////////////////////////////////
-/// ADDONS:: CHAOTIC-AUR
-//////////////////////////////////////////////////
-void Widget::chaoticAUR() {
-    // Create progress dialog
-    QProgressDialog *progress = new QProgressDialog("Processing Chaotic AUR...", nullptr, 0, 100, this);
-    progress->setWindowModality(Qt::ApplicationModal);
+    QProgressDialog *progress = new QProgressDialog("Removing " + title + "...", nullptr, 0, 0, this);
+    progress->setWindowModality(Qt::WindowModal);
     progress->setCancelButton(nullptr);
-    progress->setValue(0);
     progress->show();
-    QCoreApplication::processEvents();
-
-    int status = checkChaoticAURStatus();
-    progress->setValue(10);
-    QCoreApplication::processEvents();
-
-    // Always back up before making any modifications
-    backupPacmanConfig();
-    progress->setValue(20);
-    QCoreApplication::processEvents();
-
-    // When fully configured, that is, repository is active, removal is the desired action.
-    if (status == 0) {
-        progress->setLabelText("Removing Chaotic AUR...");
-        progress->setValue(50);
-        QCoreApplication::processEvents();
-        removeChaoticAUR();
-        progress->setValue(100);
-        progress->deleteLater();
-        return;
-    }
-
-    // For initial installation, modify pacman.conf via C++.
-    else if (status == 1) {
-
-        // Proceed with package and key setup.
-        QProcess addProc;
-        QString addCmd =
-            "pkexec pacman-key --recv-key 3056513887B78AEB --keyserver keyserver.ubuntu.com && "
-            "pkexec pacman-key --lsign-key 3056513887B78AEB && "
-            "pkexec pacman -U https://cdn-mirror.chaotic.cx/chaotic-aur/chaotic-keyring.pkg.tar.zst --noconfirm &&"
-            "pkexec pacman -U https://cdn-mirror.chaotic.cx/chaotic-aur/chaotic-mirrorlist.pkg.tar.zst --noconfirm";
-        progress->setLabelText("Installing packages and keys...");
-        progress->setValue(40);
-        QCoreApplication::processEvents();
-
-        addProc.start("bash", QStringList() << "-c" << addCmd);
 
-        if (addProc.exitCode() != 0) {
-            cleanCache();
-        }
-        addProc.waitForFinished();
-
-        progress->setValue(70);
-        QCoreApplication::processEvents();
-        qDebug() << "addProcFunction OUTPUT:" << addProc.readAllStandardOutput();
-        qDebug() << "addProcFunction ERRORS:" << addProc.readAllStandardError();
-
-        QString workingDir = QDir::homePath() + "/tolitica-home-settings/backups/current-use";
-        if (!QDir().mkpath(workingDir)) {
-            qDebug() << "Failed to create backup directory:" << workingDir;
-        }
-        QString configPath = workingDir + "/pacman.conf";
-        QString originalConfig = "/etc/pacman.conf";
-
-        qDebug() << "workingDir:" << workingDir;
-        qDebug() << "configPath:" << configPath;
-        qDebug() << "originalConfig:" << originalConfig;
-
-        // Copy the original config into our working directory
-        QProcess copyProc;
-        copyProc.start("pkexec", QStringList() << "cp" << originalConfig << configPath);
-        copyProc.waitForFinished();
-        qDebug() << "Copy EXIT-CODE:" << copyProc.exitCode();
-        qDebug() << "Copy process OUTPUT:" << copyProc.readAllStandardOutput();
-        qDebug() << "Copy process ERRORS:" << copyProc.readAllStandardError();
-
-        if (copyProc.exitCode() != 0) {
-            QMessageBox::warning(this, "Error", "Failed to copy pacman.conf to working directory:\n" +
-                                                    copyProc.readAllStandardError());
-            return;
-        }
-
-        // Immediately fix ownership so the file is writeable by the current user.
-        QProcess fixPermissions;
-        // Use the current user from the environment (e.g., "angel")
-        QString user = qgetenv("USER");
-        qDebug() << "Fixing permissions for user:" << user;
-        fixPermissions.start("pkexec", QStringList() << "chown" << user + ":" + user << configPath);
-        fixPermissions.waitForFinished();
-        qDebug() << "chown EXIT-CODE:" << fixPermissions.exitCode();
-        qDebug() << "chown OUTPUT:" << fixPermissions.readAllStandardOutput();
-        qDebug() << "chown ERRORS:" << fixPermissions.readAllStandardError();
-
-        fixPermissions.start("pkexec", QStringList() << "chmod" << "644" << configPath);
-        fixPermissions.waitForFinished();
-        qDebug() << "chmod EXIT-CODE:" << fixPermissions.exitCode();
-        qDebug() << "chmod OUTPUT:" << fixPermissions.readAllStandardOutput();
-        qDebug() << "chmod ERRORS:" << fixPermissions.readAllStandardError();
-
-        // Open the working copy in C++ for precise modification.
-        QFile configFile(configPath);
-        if (!configFile.open(QIODevice::ReadOnly | QIODevice::Text)) {
-            QMessageBox::warning(this, "Error", "Failed to open working copy for reading.");
-            return;
-        }
-        QString content = configFile.readAll();
-        configFile.close();
-
-        // Append the Chaotic AUR repository block if it's not already there.
-        if (!content.contains("[chaotic-aur]")) {
-            content.append("\n[chaotic-aur]\nInclude = /etc/pacman.d/chaotic-mirrorlist\n");
-        }
-
-        // Write back the modified configuration.
-        if (!configFile.open(QIODevice::WriteOnly | QIODevice::Text | QIODevice::Truncate)) {
-            QMessageBox::warning(this, "Error", "Failed to open working copy for writing.");
-            return;
-        }
-        QTextStream out(&configFile);
-        out << content;
-        configFile.close();
-
-        // Copy the modified configuration back to /etc/pacman.conf using pkexec.
-        progress->setLabelText("Updating configuration...");
-        progress->setValue(90);
-        QCoreApplication::processEvents();
-
-        QProcess installConfig;
-        installConfig.start("pkexec", QStringList() << "cp" << configPath << originalConfig);
-        installConfig.waitForFinished();
-
-        progress->setValue(100);
-        QCoreApplication::processEvents();
-        qDebug() << "InstallConfig EXIT-CODE:" << installConfig.exitCode();
-        qDebug() << "InstallConfig OUTPUT:" << installConfig.readAllStandardOutput();
-        qDebug() << "InstallConfig ERRORS:" << installConfig.readAllStandardError();
-
-        if (installConfig.exitCode() != 0) {
-            QMessageBox::warning(this, "Error", "Failed to update /etc/pacman.conf:\n" +
-                                                    installConfig.readAllStandardError());
-            return;
-        }
-
-        progress->deleteLater();
+    // One ALPM transaction, one database lock, one authorization
+    PrivilegedHelper *helper = new PrivilegedHelper(this);
+    connect(helper, &PrivilegedHelper::finished, this, [=](bool success, const QString &output) {
+        PackageDatabase::instance().reload();
+        progress->close();
 
-        if (installConfig.exitCode() == 0) {
-            QMessageBox::information(this, "Chaotic AUR Added",
-                                     "Chaotic AUR repositories have been successfully set up in Xray_OS");
+        if (success) {
+            QMessageBox::information(nullptr, title + " Removed",
+                                     title + " packages have been successfully removed.");
         } else {
-            QMessageBox::warning(this, "Error", "Error adding Chaotic AUR:\n" + addProc.readAllStandardError());
-        }
-
-        return;
-    }
-
-    // For a partial/failed setup, attempt to repair.
-    else if (status == 2) {
-        // If the local chaotic-mirrorlist does not exist, clean any broken entries.
-        if (!QFile::exists("/etc/pacman.d/chaotic-mirrorlist")) {
-            QProcess removeRepo;
-            qDebug() << "Executing: pkexec sed -i '/[chaotic-aur]/,+1d' /etc/pacman.conf'";
-
-            removeRepo.start("pkexec", QStringList() << "bash" << "-c" << QString("sed -i '/\\[chaotic-aur\\]/,+1d' /etc/pacman.conf"));
-            removeRepo.waitForFinished();
-
-            qDebug() << "removeRepo OUTPUT:" << removeRepo.readAllStandardOutput();
-            qDebug() << "removeRepo ERRORS:" << removeRepo.readAllStandardError();
+            QMessageBox::warning(nullptr, "Error", "Something went wrong removing " + title + ":\n" + output);
         }
-
-        // Reinstall packages and re-import the key.
-        progress->setLabelText("Repairing Chaotic AUR...");
-        progress->setValue(50);
-        QCoreApplication::processEvents();
-
-        QProcess repairProc;
-        QString repairCmd =
-            "pkexec pacman-key --recv-key 3056513887B78AEB --keyserver keyserver.ubuntu.com && "
-            "pkexec pacman-key --lsign-key 3056513887B78AEB &&"
-            "pkexec pacman -U https://cdn-mirror.chaotic.cx/chaotic-aur/chaotic-keyring.pkg.tar.zst --noconfirm && "
-            "pkexec pacman -U https://cdn-mirror.chaotic.cx/chaotic-aur/chaotic-mirrorlist.pkg.tar.zst --noconfirm";
-        repairProc.start("bash", QStringList() << "-c" << repairCmd);
-        repairProc.waitForFinished();
-
-        progress->setValue(80);
-        QCoreApplication::processEvents();
-        qDebug() << "repairProc OUTPUT:" << repairProc.readAllStandardOutput();
-        qDebug() << "repairProc ERRORS:" << repairProc.readAllStandardError();
-
-        QProcess checkConf;
-        checkConf.start("bash", QStringList() << "-c" << "grep '[chaotic-aur]' /etc/pacman.conf");
-        checkConf.waitForFinished();
-        qDebug() << "Pacman.conf after removeRepo:" << checkConf.readAllStandardOutput();
-
-        // Restore the pacman.conf from your backup store.
-        progress->setLabelText("Restoring configuration...");
-        progress->setValue(90);
-        QCoreApplication::processEvents();
-
-        QProcess restoreProc;
-        QString homePath = QDir::homePath();
-        // Build the restore command as a single string to avoid splitting issues.
-        QString restoreCmd = QString("cp -r %1/tolitica-home-settings/backups/current-use/pacman.conf /etc/pacman.conf").arg(homePath);
-        qDebug() << "Restore command:" << restoreCmd;
-        restoreProc.start("pkexec", QStringList() << "bash" << "-c" << restoreCmd);
-        restoreProc.waitForFinished();
-
-        progress->setValue(100);
-        QCoreApplication::processEvents();
-        qDebug() << "restoreProc EXIT-CODE:" << restoreProc.exitCode();
-        qDebug() << "restoreProc OUTPUT:" << restoreProc.readAllStandardOutput();
-        qDebug() << "restoreProc ERRORS:" << restoreProc.readAllStandardError();
-
         progress->deleteLater();
+        helper->deleteLater();
+    });
 
-        if (restoreProc.exitCode() == 0) {
-            QMessageBox::information(this, "Restore Complete", "Chaotic AUR has been repaired!");
-        } else {
-            QMessageBox::warning(this, "Error", "Something went wrong restoring pacman.conf:\n" +
-                                                    restoreProc.readAllStandardError());
-        }
-    }
+    helper->start("packages", QList<QVariantMap>() << PrivilegedHelper::removePackagesStep(plan));
 }
 
 ///////////////////////////////////////////////////
@@ -943,15 +479,9 @@ bool Widget::vmwareServiceStatus() {
 
     bool allServicesActive = true;
 
-    QProcess checkEnabled;
-    checkEnabled.start("bash", QStringList() << "-c" << "systemctl is-enabled vmware-usbarbitrator.service");
-    checkEnabled.waitForFinished();
-    bool isEnabled = (checkEnabled.readAllStandardOutput().trimmed() == "enabled");
-
-    QProcess checkActive;
-    checkActive.start("bash", QStringList() << "-c" << "systemctl is-active vmware-usbarbitrator.service");
-    checkActive.waitForFinished();
-    bool isActive = (checkActive.readAllStandardOutput().trimmed() == "active");
+    SystemdUnits::UnitState arbitrator = SystemdUnits::instance().state("vmware-usbarbitrator.service");
+    bool isEnabled = (arbitrator.unitFileState == "enabled");
+    bool isActive = (arbitrator.activeState == "active");
 
     if (!isActive || !isEnabled) {
         allServicesActive = false;
@@ -964,16 +494,7 @@ bool Widget::vmwareServiceStatus() {
 /// ADDONS:: CHECK VMWARE STATUS
 //////////////////////////////////////////////////
 bool Widget::vmwareStatus() {
-    QProcess checkVMware;
-    checkVMware.start("bash", QStringList() << "-c" << "pacman -Q vmware-workstation");
-    checkVMware.waitForFinished();
-
-    if (checkVMware.exitCode() == 0) {
-        return true;
-    }
-    else {
-        return false;
-    }
+    return PackageDatabase::instance().isInstalled("vmware-workstation");
 }
 
 ///////////////////////////////////////////////////
@@ -1056,7 +577,6 @@ void Widget::addVMware(QPushButton *vmwButton) {
 
     // Create process objects and a timer to monitor installation progress
     QProcess *installVMware = new QProcess(this);
-    QTimer *monitorTimer = new QTimer(this);
     QProgressDialog *progress = nullptr;
 
     // Display progress dialog with the message
@@ -1080,36 +600,23 @@ void Widget::addVMware(QPushButton *vmwButton) {
     progress->setCancelButton(nullptr);
     progress->setValue(0);
     progress->show();
-    QCoreApplication::processEvents(); // Force immediate rendering
 
-    int progressValue = 0;
-
-    // Increase the progress bar as process output comes in.
-    connect(installVMware, &QProcess::readyReadStandardOutput, this, [=]() mutable {
-        progressValue += 5;
-        progress->setValue(qMin(progressValue, 95));
-        QCoreApplication::processEvents();
-    });
-
-    // Use a timer to simulate progress in case output is sparse.
-    connect(monitorTimer, &QTimer::timeout, this, [=]() mutable {
-        if (progressValue < 95) {
-            progressValue += 2;
-            progress->setValue(qMin(progressValue, 95));
-        }
-    });
+    // Progress follows pacman's output; the systemctl steps finish quickly
+    ProgressModel *model = new ProgressModel(progress);
+    model->attach(progress);
+    model->follow(installVMware);
 
     // When the installation process finishes;
     connect(installVMware, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished),
     this, [=](int exitCode, QProcess::ExitStatus status) mutable {
-        progress->setValue(100);
-        QCoreApplication::processEvents(); // Force UI to process the update before displayin the message
+        model->finish();
+        qDebug() << "OUTPUT: " << model->transcript();
+        qDebug() << "ERROR: " << installVMware->readAllStandardError();
         progress->close();
 
         // Cleanup dynamic objects.
         progress->deleteLater();
         installVMware->deleteLater();
-        monitorTimer->deleteLater();
 
         bool updatedStatus = vmwareStatus() && vmwareServiceStatus();
         vmwButton->setText(updatedStatus ? "Remove VMware Workstation"
@@ -1126,16 +633,13 @@ void Widget::addVMware(QPushButton *vmwButton) {
     if (!status && !servicesStatus) {
 
         installVMware->start("pkexec", QStringList() << "bash" << "-c" <<
-                                           "pacman -S vmware-workstation --noconfirm &&"
+                                           ProgressModel::pacmanCommand("-S vmware-workstation --noconfirm") + " && "
                                            "pkexec systemctl enable vmware-networks-configuration.service && "
                                            "pkexec systemctl start vmware-networks-configuration.service && "
                                            //"pkexec systemctl enable vmware-networks.service && "
                                            //"pkexec systemctl start vmware-networks.service && "
                                            "pkexec systemctl enable vmware-usbarbitrator.service && "
                                            "pkexec systemctl start vmware-usbarbitrator.service");
-        installVMware->waitForFinished();
-        qDebug() << "OUTPUT: " << installVMware->readAllStandardOutput();
-        qDebug() << "ERROR: " << installVMware->readAllStandardError();
     }
     else if (status && !servicesStatus) {
 
@@ -1146,14 +650,11 @@ void Widget::addVMware(QPushButton *vmwButton) {
                                            //"pkexec systemctl start vmware-networks.service && "
                                            "pkexec systemctl enable vmware-usbarbitrator.service && "
                                            "pkexec systemctl start vmware-usbarbitrator.service");
-        installVMware->waitForFinished();
-        qDebug() << "OUTPUT: " << installVMware->readAllStandardOutput();
-        qDebug() << "ERROR: " << installVMware->readAllStandardError();
 
     } else {
         // Removing the package also disable the services.. (no need for manual adjustment)
         installVMware->start("pkexec", QStringList() << "bash" << "-c" <<
-                                           "pacman -Rns vmware-workstation --noconfirm && "
+                                           ProgressModel::pacmanCommand("-Rns vmware-workstation --noconfirm") + " && "
                                            //"systemctl stop vmware-networks.service && "
                                            "systemctl stop vmware-usbarbitrator.service && "
                                            "rm -rf /etc/systemd/system/vmware-networks.service && "
@@ -1163,154 +664,31 @@ void Widget::addVMware(QPushButton *vmwButton) {
                                            // "sudo mkinitcpio -P"
                                            "systemctl daemon-reload && "
                                            "systemctl reset-failed");
-        installVMware->waitForFinished();
-        qDebug() << "OUTPUT: " << installVMware->readAllStandardOutput();
-        qDebug() << "ERROR: " << installVMware->readAllStandardError();
 
     }
 
     // bool newStatus = (vmwareStatus() && vmwareServiceStatus());
     // vmwButton->setText(newStatus ? "Remove VMware Workstation"
     //                              : "Install/Enable VMware Workstation");
-
-    monitorTimer->start(250);
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
 /// FUNCTIONS FOR THE TERMINAL PAGE /////////////////////// /////////////////////// ////////////////
 //////////////////////////////////////////////////////////////////////////////////////////////////
 
-///////////////////////////////////////////////////
-/// TERMINAL: CHECK TERMINAL-THEMING STATUS
-//////////////////////////////////////////////////
-int Widget::checkTermThemingStatus(){
-    QString termConfigFile = QDir::homePath() + "/.config/fish/config.fish";
-    QFile configFile(termConfigFile);
-
-    if (!configFile.exists()) {
-        return 0; // File not found
-    }
-    if (!configFile.open(QIODevice::ReadOnly | QIODevice::Text)) {
-        return 0; // Treat as not found due to error
-    }
-
-    QString targetLine = "oh-my-posh init fish --config $HOME/.config/oh-my-posh-themes/arch-atomic.omp.json";
-    QTextStream in(&configFile);
-
-    while (!in.atEnd()) {
-        QString line = in.readLine();
-        if (line.contains(targetLine)) {
-            configFile.close();
-            return line.startsWith("#") ? 2 : 1; // 2 if commented, 1 if uncommented
-        }
-    }
-
-    configFile.close();
-    return 0; // Line not found
-}
-
-////////////////////////////////////////////////////////
-/// TERMINAL: DISABLE/ENABLE TERMINAL THEMING FUNCTION
-//////////////////////////////////////////////////////
-void Widget::disableTermTheme(QPushButton *terminalThemeButton) {
-    QString termConfigFile = QDir::homePath() + "/.config/fish/config.fish";
-    QFile configFile(termConfigFile);
-
-    int status = checkTermThemingStatus(); // Get the current line status
-
-    // Handle the case were the file or target line is missing
-    if (status == 0) {
-        terminalThemeButton->setText("No config.fish found");
-        QMessageBox::warning(this, "No Oh-My-Posh theme Found!",
-                                    "No current config.fish file was found in '$HOME/.config/fish'");
-        return;
-    }
-
-    // If there is no actual arch-atomic.omp.json file
-    if (!QFile::exists(QDir::homePath() + "/.config/oh-my-posh-themes/arch-atomic.omp.json")) {
-        QMessageBox::warning(this, "arch-atomic.omp.json is Missing!",
-                                   "arch-atomic.omp.json is missing from /.config/oh-my-posh-themes");
-        return;
-    }
-
-    // Confirm action with the user
-    QMessageBox msgBox;
-    msgBox.setWindowTitle("Terminal Theming");
-    msgBox.setIcon(QMessageBox::Information);
-
-    if (status == 1) {
-        msgBox.setText("Terminal theming is currently enabled.\nWould you like to disable it?");
-    } else if (status == 2) {
-        msgBox.setText("Terminal theming is currently disabled\nWould you like to enable it?");
-    }
-
-    msgBox.setStandardButtons(QMessageBox::Yes | QMessageBox::No);
-    int userChoice = msgBox.exec();
-
-    if (userChoice != QMessageBox::Yes) {
-        return; // User canceled the action
-    }
-
-    // Attempt to open the file for reading
-    if (!configFile.open(QIODevice::ReadOnly | QIODevice::Text)) {
-        QMessageBox::critical(this, "Error", "Failed to read configuration file.");
-        return;
-    }
-
-    QStringList lines;
-    QString targetLine = "oh-my-posh init fish --config $HOME/.config/oh-my-posh-themes/arch-atomic.omp.json";
-
-    QTextStream in(&configFile);
-    while (!in.atEnd()) {
-        QString line = in.readLine();
-
-        if (line.contains(targetLine)) {
-            line = (status == 1) ? "#" + line : line.mid(1); // Comment or uncomment
-        }
-
-        lines.append(line);
-    }
-    configFile.close();
-
-    // Attempt to open the file for writing
-    if (!configFile.open(QIODevice::WriteOnly | QIODevice::Text | QIODevice::Truncate)) {
-        QMessageBox::critical(this, "Error", "Failed to modify configuration file.");
-        return;
-    }
-
-    QTextStream out(&configFile);
-    for (const QString &line : lines) {
-        out << line << "\n";
-    }
-    configFile.close();
-
-    // Update the button text after successful modification
-    terminalThemeButton->setText(status == 1 ? "Enable Terminal Theming (Fish ONLY)" : "Disable Terminal Theming (Fish ONLY)");
-    QMessageBox::information(this, "Success", "Terminal theming successfully updated");
-}
-
 ////////////////////////////////////////////////////////
 /// GENERAL: ASCII LOGO STATUS
 //////////////////////////////////////////////////////
 int Widget::asciiLogoStatus() {
-    QFile configFile("/usr/lib/os-release");
+    QSharedPointer<const SystemFacts> facts = SystemFacts::snapshot();
 
-    if(!configFile.open(QIODevice::ReadOnly | QIODevice::Text)) {
+    if (!facts->hasOsRelease()) {
         return -1;
     }
 
-    QTextStream in(&configFile);
-    while (!in.atEnd()) {
-        QString line = in.readLine().trimmed();
-        if (line.startsWith("ID=")) {
-            QString value = line.mid(3).trimmed(); // get everything after "ID="
-            value.remove('"'); // Remove quotes if present
-            if (value == "xray_os") {
-                return 0;
-            }
-        }
-    }
-    return 1;
+    QString value = facts->osReleaseValue("ID").trimmed();
+    value.remove('"'); // Remove quotes if present
+    return (value == "xray_os") ? 0 : 1;
 }
 
 ////////////////////////////////////////////////////////
@@ -1336,6 +714,8 @@ void Widget::enableAsciiLogo() {
     qDebug() << "Standard output:" << process.readAllStandardOutput();
     qDebug() << "Standard error:" << process.readAllStandardError();
 
+    SystemFacts::gather(SystemFacts::OsRelease);
+
     if (process.exitCode() != 0) {
         QMessageBox::critical(this, "Error",
             QString("Failed to modify os-release. Exit code: %1\nError: %2")
@@ -1400,6 +780,7 @@ Widget::Widget(QWidget *parent)
 {
     ui->setupUi(this);
     coreFunctions = new CoreFunctions(this);
+    coreServices = new CoreServices(this);
 
     setWindowTitle("Tolitica Xray_OS Assistant");
     resize(800,600);
@@ -1410,11 +791,7 @@ Widget::Widget(QWidget *parent)
     //////////////////////////////////////
     /// CALAMARES UI ---------////////////
     //////////////////////////////////////
-    QProcess process;
-    process.start("bash", QStringList() << "-c" << "grep -q '/cow' /proc/mounts || [ -f /run/live/medium ]");
-    process.waitForFinished();
-
-    bool isLiveEnv = (process.exitCode() == 0);
+    bool isLiveEnv = SystemFacts::snapshot()->isLiveEnv();
     QString word = "tolitica";
 
     if (isLiveEnv && word == "tolitica") {
@@ -1438,25 +815,30 @@ Widget::Widget(QWidget *parent)
         //////////////////////////////////////
 
         // Create a stacked widget to hold the different pages
-        QStackedWidget *stackedWidget = new QStackedWidget(this);
-        // Setting initial index to 0 (regular UI)
-        stackedWidget->setCurrentIndex(0);
+        m_stackedWidget = new QStackedWidget(this);
 
-        // Create all pages
-        // Use fixed width for mainPage to force 800px width.
+        // Only the main page is built here. The other pages are registered with
+        // their builders and are built (and probed) the first time they're opened.
         QWidget *mainPage = new QWidget();
-        QWidget *tweaksPage = new QWidget();
-        QWidget *addonsPage = new QWidget();
-        QWidget *terminalPage = new QWidget();
-
-        // Add pages to the stacked widget
-        stackedWidget->addWidget(mainPage);
-        stackedWidget->addWidget(tweaksPage);
-        stackedWidget->addWidget(addonsPage);
-        stackedWidget->addWidget(terminalPage);
+        m_pages.insert(MainPage, mainPage);
+        m_stackedWidget->addWidget(mainPage);
+
+        registerPage(TweaksPage, [this]() { return buildTweaksPage(); });
+        registerPage(AddonsPage, [this]() { return buildAddonsPage(); });
+        registerPage(TerminalPage, [this]() { return buildTerminalPage(); });
+        registerPage(MountDrivesPage, [this]() { return buildMountDrivesPage(); });
+
+        // Background download of pending updates, when the user opted in
+        m_updatePrefetcher = new UpdatePrefetcher(this);
+        if (UpdatePrefetcher::isEnabled()) {
+            m_updatePrefetcher->start();
+        } else {
+            m_updatePrefetcher->refresh();
+        }
 
         // Add stackedWidget to main layout
-        mainWidgetLayout->addWidget(stackedWidget);
+        mainWidgetLayout->addWidget(m_stackedWidget);
+
 
         // ==== Main Page Content ====
         QVBoxLayout *mainLayout = new QVBoxLayout(mainPage);
@@ -1598,236 +980,309 @@ Widget::Widget(QWidget *parent)
             disabledStartup->setChecked(newState);
         });
 
-        ///////////////////////////////////////////////////////////////////////////////////////////////
-        // ==== Tweaks Page =====
-        ///////////////////////////////////////////////////////////////////////////////////////////////
-        QGridLayout *tweaksLayout = new QGridLayout(tweaksPage);
-        QPushButton *backButton = new QPushButton("Back", this);
-
-        // Functional Buttons Tweaks Layout
-        QPushButton *cleanOrphansButton = new QPushButton("Clean Unused Packages", this);
-        QPushButton *cleanPkgCacheButton = new QPushButton("Clean Package Cache", this);
-        QPushButton *updateSystemButton = new QPushButton("Update Xray_OS", this);
-        QPushButton *removeDBLockButton = new QPushButton("Remove DB Lock", this);
-        QPushButton *rankMirrorsButton = new QPushButton("Rank Mirrors", this);
-
-        // ** Bluetooth Toggle CheckBox ** //
-        QCheckBox *bluetoothToggle = new QCheckBox("Enable Bluetooth", this);
-        tweaksLayout->addWidget(bluetoothToggle, 3, 0, Qt::AlignLeft);
-        // ** Bluetooth: set initial state based on Bluetooth status ** //
-        bool bluetoothEnabled = (CoreFunctions::bluetoothStatus() == 0);
-        bluetoothToggle->setChecked(bluetoothEnabled);
-        bluetoothToggle->setText(bluetoothEnabled ? "Disable Bluetooth" : "Enable Bluetooth");
-
-
-        // ** AppArmor Toggle CheckBox
-        QCheckBox *apparmorToggle = new QCheckBox(this);
-        tweaksLayout->addWidget(apparmorToggle, 3, 0, Qt::AlignRight);
-        // ** AppArmor: set initial state base on AppArmor statud ** //
-        int aaStatus = CoreFunctions::apparmorStatus();
-        qDebug() << "Initial AppArmor status:" << aaStatus;
-
-        if (aaStatus == 0) {
-            // Not supported – leave unchecked and prompt text "Enable AppArmor"
-            apparmorToggle->setChecked(false);
-            apparmorToggle->setText("Enable AppArmor");
-        } else if (aaStatus == 1) {
-            // AppArmor is enabled
-            apparmorToggle->setChecked(true);
-            apparmorToggle->setText("Disable AppArmor");
-        } else if (aaStatus == 2) {
-            // AppArmor is disabled
-            apparmorToggle->setChecked(false);
-            apparmorToggle->setText("Enable AppArmor");
-        } else {
-            // For any other status (e.g., 3 means partially enabled or custom) – decide on a default:
-            apparmorToggle->setChecked(false);
-            apparmorToggle->setText("Enable AppArmor");
+
+        // === Page navigation === //
+        connect(tweaksButton, &QPushButton::clicked, this, [this]() {
+            showPage(TweaksPage);
+        });
+        connect(addonsButton, &QPushButton::clicked, this, [this]() {
+            showPage(AddonsPage);
+        });
+        connect(terminalButton, &QPushButton::clicked, this, [this]() {
+            showPage(TerminalPage);
+        });
+        mountDrivesSetupConnections(mountDriveButton);
+    }
+
+}
+// == I LOVE CPP ==================================
+///////////////////////////////////////////////////
+/// END MAIN FUNCTION
+//////////////////////////////////////////////////
+// == I LOVE C++ ==================================
+
+///////////////////////////////////////////////////
+/// PAGE REGISTRY
+//////////////////////////////////////////////////
+void Widget::registerPage(Page page, std::function<QWidget *()> factory) {
+    m_pageFactories.insert(page, std::move(factory));
+}
+
+void Widget::showPage(Page page) {
+    QWidget *pageWidget = m_pages.value(page, nullptr);
+
+    if (!pageWidget) {
+        auto factory = m_pageFactories.constFind(page);
+        if (factory == m_pageFactories.constEnd()) {
+            qWarning() << "No builder registered for page" << page;
+            return;
         }
 
-        /* === Positioning Buttons === */
-        tweaksLayout->addWidget(cleanOrphansButton, 1, 0, Qt::AlignLeft);
-        tweaksLayout->addWidget(cleanPkgCacheButton, 1, 0, Qt::AlignRight);
-        tweaksLayout->addWidget(rankMirrorsButton, 2, 0, Qt::AlignRight);
-        tweaksLayout->addWidget(updateSystemButton, 2, 0, Qt::AlignCenter);
-        tweaksLayout->addWidget(removeDBLockButton, 2, 0, Qt::AlignLeft);
+        pageWidget = (*factory)();
+        m_pages.insert(page, pageWidget);
+        m_stackedWidget->addWidget(pageWidget);
+    }
+    m_stackedWidget->setCurrentWidget(pageWidget);
+}
 
-        // Push Back-button to bottom dynamically
-        tweaksLayout->setRowStretch(4, 1);
-        tweaksLayout->addWidget(backButton, 5, 0, Qt::AlignLeft);
-        tweaksPage->setLayout(tweaksLayout);
+///////////////////////////////////////////////////
+/// TWEAKS PAGE
+//////////////////////////////////////////////////
+QWidget *Widget::buildTweaksPage() {
+    QWidget *tweaksPage = new QWidget();
+    QGridLayout *tweaksLayout = new QGridLayout(tweaksPage);
+    QPushButton *backButton = new QPushButton("Back", tweaksPage);
+
+    // Functional Buttons Tweaks Layout
+    QPushButton *cleanOrphansButton = new QPushButton("Clean Unused Packages", tweaksPage);
+    QPushButton *cleanPkgCacheButton = new QPushButton("Clean Package Cache", tweaksPage);
+    QPushButton *updateSystemButton = new QPushButton("Update Xray_OS", tweaksPage);
+
+    // ** Update prefetch: opt-in, and shows what is already downloaded ** //
+    QCheckBox *prefetchToggle = new QCheckBox("Download updates in background", tweaksPage);
+    prefetchToggle->setChecked(UpdatePrefetcher::isEnabled());
+    tweaksLayout->addWidget(prefetchToggle, 3, 0, Qt::AlignCenter);
+
+    auto showStaged = [updateSystemButton](int packages, qint64 bytes) {
+        updateSystemButton->setText(packages > 0
+            ? QString("Update Xray_OS (%1 staged, %2)").arg(packages)
+                  .arg(QLocale().formattedDataSize(bytes))
+            : "Update Xray_OS");
+    };
+    showStaged(m_updatePrefetcher->stagedPackages(), m_updatePrefetcher->stagedBytes());
+    connect(m_updatePrefetcher, &UpdatePrefetcher::stagedChanged, updateSystemButton, showStaged);
 
-        tweaksSetupConnections(stackedWidget, tweaksButton, backButton, cleanOrphansButton,
-                               cleanPkgCacheButton, updateSystemButton, removeDBLockButton, bluetoothToggle,
-                               apparmorToggle, rankMirrorsButton);
+    connect(prefetchToggle, &QCheckBox::toggled, this, [this](bool enabled) {
+        UpdatePrefetcher::setEnabled(enabled);
+        if (enabled) {
+            m_updatePrefetcher->start();
+        } else {
+            m_updatePrefetcher->stop();
+        }
+    });
+    QPushButton *removeDBLockButton = new QPushButton("Remove DB Lock", tweaksPage);
+    QPushButton *rankMirrorsButton = new QPushButton("Rank Mirrors", tweaksPage);
+
+    // ** Bluetooth Toggle CheckBox ** //
+    QCheckBox *bluetoothToggle = new QCheckBox("Enable Bluetooth", tweaksPage);
+    tweaksLayout->addWidget(bluetoothToggle, 3, 0, Qt::AlignLeft);
+    // ** Bluetooth: set initial state based on Bluetooth status ** //
+    bool bluetoothEnabled = (CoreFunctions::bluetoothStatus() == 0);
+    bluetoothToggle->setChecked(bluetoothEnabled);
+    bluetoothToggle->setText(bluetoothEnabled ? "Disable Bluetooth" : "Enable Bluetooth");
+
+    // ** Bluetooth: follow the service when it changes outside Tolitica ** //
+    SystemdUnits::instance().watch(QStringList() << "bluetooth.service");
+    connect(&SystemdUnits::instance(), &SystemdUnits::unitChanged, bluetoothToggle,
+            [bluetoothToggle](const QString &unit, const SystemdUnits::UnitState &state) {
+        if (unit != "bluetooth.service") {
+            return;
+        }
+        bool enabled = state.isEnabled() && state.isActive();
+        QSignalBlocker blocker(bluetoothToggle);
+        bluetoothToggle->setChecked(enabled);
+        bluetoothToggle->setText(enabled ? "Disable Bluetooth" : "Enable Bluetooth");
+    });
 
-        ///////////////////////////////////////////////////////////////////////////////////////////////
-        // ==== Terminal Page =====
-        ///////////////////////////////////////////////////////////////////////////////////////////////
-        QGridLayout *terminalLayout = new QGridLayout(terminalPage);
-        QPushButton *terminalBackButton = new QPushButton("Back", this);
+    // ** AppArmor Toggle CheckBox
+    QCheckBox *apparmorToggle = new QCheckBox(tweaksPage);
+    tweaksLayout->addWidget(apparmorToggle, 3, 0, Qt::AlignRight);
+    // ** AppArmor: set initial state base on AppArmor statud ** //
+    int aaStatus = CoreFunctions::apparmorStatus();
+    qDebug() << "Initial AppArmor status:" << aaStatus;
+
+    if (aaStatus == 0) {
+        // Not supported – leave unchecked and prompt text "Enable AppArmor"
+        apparmorToggle->setChecked(false);
+        apparmorToggle->setText("Enable AppArmor");
+    } else if (aaStatus == 1) {
+        // AppArmor is enabled
+        apparmorToggle->setChecked(true);
+        apparmorToggle->setText("Disable AppArmor");
+    } else if (aaStatus == 2) {
+        // AppArmor is disabled
+        apparmorToggle->setChecked(false);
+        apparmorToggle->setText("Enable AppArmor");
+    } else {
+        // For any other status (e.g., 3 means partially enabled or custom) – decide on a default:
+        apparmorToggle->setChecked(false);
+        apparmorToggle->setText("Enable AppArmor");
+    }
 
-        // ** Functional Buttons Terminal Layout ** //
-        // *Enable/Disable Terminal Theming
+    /* === Positioning Buttons === */
+    tweaksLayout->addWidget(cleanOrphansButton, 1, 0, Qt::AlignLeft);
+    tweaksLayout->addWidget(cleanPkgCacheButton, 1, 0, Qt::AlignRight);
+    tweaksLayout->addWidget(rankMirrorsButton, 2, 0, Qt::AlignRight);
+    tweaksLayout->addWidget(updateSystemButton, 2, 0, Qt::AlignCenter);
+    tweaksLayout->addWidget(removeDBLockButton, 2, 0, Qt::AlignLeft);
 
-        QString shell = CoreFunctions::getCurrentShell();
-        bool isFsh = (shell == "/bin/fish");
+    // Push Back-button to bottom dynamically
+    tweaksLayout->setRowStretch(4, 1);
+    tweaksLayout->addWidget(backButton, 5, 0, Qt::AlignLeft);
+    tweaksPage->setLayout(tweaksLayout);
 
-        QPushButton *terminalThemeButton = new QPushButton("Disable Terminal Theming (Fish ONLY)", this);
-        terminalThemeButton->setEnabled(isFsh);
+    tweaksSetupConnections(backButton, cleanOrphansButton,
+                           cleanPkgCacheButton, updateSystemButton, removeDBLockButton, bluetoothToggle,
+                           apparmorToggle, rankMirrorsButton);
 
-        if (isFsh) {
-            int checkTermStatus = checkTermThemingStatus();
+    return tweaksPage;
+}
 
-            if (checkTermStatus == 0) {
-                terminalThemeButton->setText("No config.fish found");
-            } else {
-                terminalThemeButton->setText(checkTermStatus == 1 ? "Disable Terminal Theming (Fish ONLY)" :
-                                             "Enable Terminal Theming");
-            }
-        }
+///////////////////////////////////////////////////
+/// TERMINAL PAGE
+//////////////////////////////////////////////////
+QWidget *Widget::buildTerminalPage() {
+    QWidget *terminalPage = new QWidget();
+    QGridLayout *terminalLayout = new QGridLayout(terminalPage);
+    QPushButton *terminalBackButton = new QPushButton("Back", terminalPage);
 
-        // *Change the shell
-        QPushButton *changeShellButton = new QPushButton("Change Shell", this);
-        QComboBox *shellComboBox = new QComboBox(this); // Added for shell selection
-        QStringList shells = CoreFunctions::getInstalledShells(); // Call to get installed shells
-        QLabel *shellLabel = new QLabel("Current Shell: Unknown", this); // Add sehll label
-        QGroupBox *shellGroupBox = new QGroupBox("Shell Options", this);
-        QVBoxLayout *shellBoxGroupLayout = new QVBoxLayout(shellGroupBox);
-
-        // Fetch and isplay the current shell
-        QString currentShell = CoreFunctions::getCurrentShell();
-        shellLabel->setText("Current Shell: " + currentShell);
-
-        if (shells.isEmpty()) {
-            shellComboBox->addItem("No shells detected");
-            changeShellButton->setEnabled(false); // Disable button if no shells detected
-        } else {
-            shellComboBox->addItems(shells);
-        }
+    // ** Functional Buttons Terminal Layout ** //
+    // *Enable/Disable Terminal Theming
 
-        /* === Positioning Buttons === */
-        terminalLayout->addWidget(terminalThemeButton);
-        terminalLayout->addWidget(changeShellButton);
-        /* === Boxes === */
-        terminalLayout->addWidget(shellComboBox); // Dropdown for shell selection
-        // Widgets for current shell-box
-        shellBoxGroupLayout->addWidget(shellLabel);
-        shellBoxGroupLayout->addWidget(shellComboBox);
-        shellBoxGroupLayout->addWidget(changeShellButton);
-        shellGroupBox->setLayout(shellBoxGroupLayout);
-        shellGroupBox->setAlignment(Qt::AlignCenter);
-
-        /* === Others === */
-        terminalLayout->addWidget(shellGroupBox, 5, 0, Qt::AlignRight);
-
-        // Push back button to bottom dynamically
-        terminalLayout->setRowStretch(4, 1);
-        terminalLayout->addWidget(terminalBackButton, 5, 0, Qt::AlignLeft);
-        terminalPage->setLayout(terminalLayout);
-
-        terminalSetupConnections(stackedWidget, terminalButton, terminalBackButton, terminalThemeButton, changeShellButton, shellComboBox, shellLabel);
-
-        ///////////////////////////////////////////////////////////////////////////////////////////////
-        // ==== Addons Page =====
-        ///////////////////////////////////////////////////////////////////////////////////////////////
-        QGridLayout *addonsLayout = new QGridLayout(addonsPage);
-        QPushButton *addonsBackButton = new QPushButton("Back", this);
-
-        // ** Functional Buttons Addons Layout ** //
-        // *Arch7 Gaming Meta
-        QPushButton *archZGamingMetaButton = new QPushButton(this);
-        QProcess checkAGMinstalled;
-        checkAGMinstalled.start("bash", QStringList() << "-c" << "pacman -Q arch7z-gaming-meta");
-        checkAGMinstalled.waitForFinished();
-
-        if (checkAGMinstalled.exitCode() == 0) {
-            archZGamingMetaButton->setText("Remove Arch7z Gaming Meta");
-        } else {
-            archZGamingMetaButton->setText("Install Arch7z Gaming Meta");
-        }
-        // *Arch7z Development Meta
-        QPushButton *arch7zDevelopmentMetaButton = new QPushButton(this);
+    QString shell = CoreFunctions::getCurrentShell();
+    bool isFsh = (shell == "/bin/fish");
 
-        QProcess checkADMinstalled;
-        checkADMinstalled.start("bash", QStringList() << "-c" << "pacman -Q arch7z-development-meta");
-        checkADMinstalled.waitForFinished();
+    QPushButton *terminalThemeButton = new QPushButton("Disable Terminal Theming (Fish ONLY)", terminalPage);
+    terminalThemeButton->setEnabled(isFsh);
 
-        if (checkADMinstalled.exitCode() == 0) {
-            arch7zDevelopmentMetaButton->setText("Remove Arch7z Development Meta");
+    if (isFsh) {
+        int checkTermStatus = CoreServices::checkTermThemingStatus();
+
+        if (checkTermStatus == 0) {
+            terminalThemeButton->setText("No config.fish found");
         } else {
-            arch7zDevelopmentMetaButton->setText("Install Arch7z Development Meta");
+            terminalThemeButton->setText(checkTermStatus == 1 ? "Disable Terminal Theming (Fish ONLY)" :
+                                         "Enable Terminal Theming");
         }
-        // *ChaoticAUR Button
-        QPushButton *chaoticAURbutton = new QPushButton(this);
-        int chaoticStatus = checkChaoticAURStatus();
-        chaoticAURbutton->setText(chaoticStatus == 0 ? "Remove Chaotic AUR" :
-                                      chaoticStatus == 1 ? "Add Chaotic AUR" :
-                                      "Repair Chaotic AUR");
-        // **Add VMware Support**//
-        QPushButton *vmwButton = new QPushButton(this);
-        bool vmStatus = vmwareStatus() && vmwareServiceStatus();
-
-        vmwButton->setText((vmStatus) ? "Remove VMware Workstation" : "Install/Enable VMware Workstation");
-
-        // ** Flatpak Toggle CheckBox ** //
-        QCheckBox *flatpakToggle = new QCheckBox(this);
-        addonsLayout->addWidget(flatpakToggle, 5, 0, Qt::AlignCenter);
-        /* Flatpak set initial state based on Flatpak-Status */
-        bool flatpakEnabled = (CoreFunctions::flatpakStatus() == 0);
-        flatpakToggle->setChecked(flatpakEnabled);
-        flatpakToggle->setText(flatpakEnabled ? "Disable/Remove Flatpak" : "Enable/Install Flatpak");
-
-        // ** Snapd Toggle CheckBox ** //
-        QCheckBox *snapdToggle = new QCheckBox(this);
-        addonsLayout->addWidget(snapdToggle, 5, 0, Qt::AlignRight);
-        /*Snapd set initial state based on Flatpak-status*/
-        bool snapdEnabled = (coreFunctions->snapdStatus() == 0);
-        snapdToggle->setChecked(snapdEnabled);
-        snapdToggle->setText(snapdEnabled ? "Disable/Remove SNAPD" : "Enable/Install SNAPD");
-
-        /* === Positioning Buttons === */
-        addonsLayout->addWidget(archZGamingMetaButton, 1, 0, Qt::AlignLeft);
-        addonsLayout->addWidget(arch7zDevelopmentMetaButton, 1, 0, Qt::AlignCenter);
-        addonsLayout->addWidget(chaoticAURbutton, 1, 0, Qt::AlignRight);
-        addonsLayout->addWidget(vmwButton, 2, 0, Qt::AlignCenter);
-
-        // Push Back-button to bottom dynamically
-        addonsLayout->setRowStretch(4, 1);
-        addonsLayout->addWidget(addonsBackButton, 5, 0, Qt::AlignLeft);
-        addonsPage->setLayout(addonsLayout);
-
-        /* === Connections === */
-        addonsSetupConnections(stackedWidget, addonsButton, addonsBackButton, archZGamingMetaButton,
-                               arch7zDevelopmentMetaButton, chaoticAURbutton, vmwButton, flatpakToggle, snapdToggle);
-
-        ///////////////////////////////////////////////////////////////////////////////////////////////
-        // ==== Mount Drives Page =====
-        ///////////////////////////////////////////////////////////////////////////////////////////////
-
-        mountDrivesSetupConnections(stackedWidget, mountDriveButton);
     }
 
+    // *Change the shell
+    QPushButton *changeShellButton = new QPushButton("Change Shell", terminalPage);
+    QComboBox *shellComboBox = new QComboBox(terminalPage); // Added for shell selection
+    QStringList shells = CoreFunctions::getInstalledShells(); // Call to get installed shells
+    QLabel *shellLabel = new QLabel("Current Shell: Unknown", terminalPage); // Add sehll label
+    QGroupBox *shellGroupBox = new QGroupBox("Shell Options", terminalPage);
+    QVBoxLayout *shellBoxGroupLayout = new QVBoxLayout(shellGroupBox);
+
+    // Fetch and isplay the current shell
+    QString currentShell = CoreFunctions::getCurrentShell();
+    shellLabel->setText("Current Shell: " + currentShell);
+
+    if (shells.isEmpty()) {
+        shellComboBox->addItem("No shells detected");
+        changeShellButton->setEnabled(false); // Disable button if no shells detected
+    } else {
+        shellComboBox->addItems(shells);
+    }
+
+    /* === Positioning Buttons === */
+    terminalLayout->addWidget(terminalThemeButton);
+    terminalLayout->addWidget(changeShellButton);
+    /* === Boxes === */
+    terminalLayout->addWidget(shellComboBox); // Dropdown for shell selection
+    // Widgets for current shell-box
+    shellBoxGroupLayout->addWidget(shellLabel);
+    shellBoxGroupLayout->addWidget(shellComboBox);
+    shellBoxGroupLayout->addWidget(changeShellButton);
+    shellGroupBox->setLayout(shellBoxGroupLayout);
+    shellGroupBox->setAlignment(Qt::AlignCenter);
+
+    /* === Others === */
+    terminalLayout->addWidget(shellGroupBox, 5, 0, Qt::AlignRight);
+
+    // Push back button to bottom dynamically
+    terminalLayout->setRowStretch(4, 1);
+    terminalLayout->addWidget(terminalBackButton, 5, 0, Qt::AlignLeft);
+    terminalPage->setLayout(terminalLayout);
+
+    terminalSetupConnections(terminalBackButton, terminalThemeButton, changeShellButton, shellComboBox, shellLabel);
+
+    return terminalPage;
 }
-// == I LOVE CPP ==================================
+
 ///////////////////////////////////////////////////
-/// END MAIN FUNCTION
+/// ADDONS PAGE
 //////////////////////////////////////////////////
-// == I LOVE C++ ==================================
+QWidget *Widget::buildAddonsPage() {
+    QWidget *addonsPage = new QWidget();
+    QGridLayout *addonsLayout = new QGridLayout(addonsPage);
+    QPushButton *addonsBackButton = new QPushButton("Back", addonsPage);
+
+    // ** Functional Buttons Addons Layout ** //
+    // *Arch7 Gaming Meta
+    QPushButton *archZGamingMetaButton = new QPushButton(addonsPage);
+    const QHash<QString, bool> metaInstalled = PackageDatabase::instance().installed(
+        {"arch7z-gaming-meta", "arch7z-development-meta"});
+
+    if (metaInstalled.value("arch7z-gaming-meta")) {
+        archZGamingMetaButton->setText("Remove Arch7z Gaming Meta");
+    } else {
+        archZGamingMetaButton->setText("Install Arch7z Gaming Meta");
+    }
+    // *Arch7z Development Meta
+    QPushButton *arch7zDevelopmentMetaButton = new QPushButton(addonsPage);
+
+    if (metaInstalled.value("arch7z-development-meta")) {
+        arch7zDevelopmentMetaButton->setText("Remove Arch7z Development Meta");
+    } else {
+        arch7zDevelopmentMetaButton->setText("Install Arch7z Development Meta");
+    }
+    // *ChaoticAUR Button
+    QPushButton *chaoticAURbutton = new QPushButton(addonsPage);
+    int chaoticStatus = CoreServices::checkChaoticAURStatus();
+    chaoticAURbutton->setText(chaoticStatus == 0 ? "Remove Chaotic AUR" :
+                                  chaoticStatus == 1 ? "Add Chaotic AUR" :
+                                  "Repair Chaotic AUR");
+    // **Add VMware Support**//
+    QPushButton *vmwButton = new QPushButton(addonsPage);
+    bool vmStatus = vmwareStatus() && vmwareServiceStatus();
+
+    vmwButton->setText((vmStatus) ? "Remove VMware Workstation" : "Install/Enable VMware Workstation");
+
+    // ** Flatpak Toggle CheckBox ** //
+    QCheckBox *flatpakToggle = new QCheckBox(addonsPage);
+    addonsLayout->addWidget(flatpakToggle, 5, 0, Qt::AlignCenter);
+    /* Flatpak set initial state based on Flatpak-Status */
+    bool flatpakEnabled = (CoreFunctions::flatpakStatus() == 0);
+    flatpakToggle->setChecked(flatpakEnabled);
+    flatpakToggle->setText(flatpakEnabled ? "Disable/Remove Flatpak" : "Enable/Install Flatpak");
+
+    // ** Snapd Toggle CheckBox ** //
+    QCheckBox *snapdToggle = new QCheckBox(addonsPage);
+    addonsLayout->addWidget(snapdToggle, 5, 0, Qt::AlignRight);
+    /*Snapd set initial state based on Flatpak-status*/
+    bool snapdEnabled = (coreFunctions->snapdStatus() == 0);
+    snapdToggle->setChecked(snapdEnabled);
+    snapdToggle->setText(snapdEnabled ? "Disable/Remove SNAPD" : "Enable/Install SNAPD");
+
+    /* === Positioning Buttons === */
+    addonsLayout->addWidget(archZGamingMetaButton, 1, 0, Qt::AlignLeft);
+    addonsLayout->addWidget(arch7zDevelopmentMetaButton, 1, 0, Qt::AlignCenter);
+    addonsLayout->addWidget(chaoticAURbutton, 1, 0, Qt::AlignRight);
+    addonsLayout->addWidget(vmwButton, 2, 0, Qt::AlignCenter);
+
+    // Push Back-button to bottom dynamically
+    addonsLayout->setRowStretch(4, 1);
+    addonsLayout->addWidget(addonsBackButton, 5, 0, Qt::AlignLeft);
+    addonsPage->setLayout(addonsLayout);
+
+    /* === Connections === */
+    addonsSetupConnections(addonsBackButton, archZGamingMetaButton,
+                           arch7zDevelopmentMetaButton, chaoticAURbutton, vmwButton, flatpakToggle, snapdToggle);
+
+    return addonsPage;
+}
 
 ///////////////////////////////////////////////////
 /// TWEAK SETUP CONNECTIONS FUNCTION
 //////////////////////////////////////////////////
-void Widget::tweaksSetupConnections(QStackedWidget *stackedWidget, QPushButton *tweaksButton, QPushButton *backButton,
+void Widget::tweaksSetupConnections(QPushButton *backButton,
                                     QPushButton *cleanOrphansButton, QPushButton *cleanPkgCacheButton,
                                     QPushButton *updateSystemButton, QPushButton *removeDBLockButton,
                                     QCheckBox *bluetoothToggle, QCheckBox *appArmorToggle, QPushButton *rankMirrorsButton){
     // Navigation connections
-    connect(tweaksButton, &QPushButton::clicked, this, [stackedWidget]() {
-        stackedWidget->setCurrentIndex(1); // Switch to Tweaks page
-    });
-    connect(backButton, &QPushButton::clicked, this, [stackedWidget]() {
-        stackedWidget->setCurrentIndex(0); // Switch back to Main page
+    connect(backButton, &QPushButton::clicked, this, [this]() {
+        showPage(MainPage); // Switch back to Main page
     });
 
     connect(cleanOrphansButton, &QPushButton::clicked, this, &Widget::cleanOrphans);
@@ -1864,15 +1319,12 @@ void Widget::tweaksSetupConnections(QStackedWidget *stackedWidget, QPushButton *
 ///////////////////////////////////////////////////
 /// ADDONS SETUP CONNECTIONS FUNCTION
 //////////////////////////////////////////////////
-void Widget::addonsSetupConnections(QStackedWidget *stackedWidget, QPushButton *addonsButton, QPushButton *addonsBackButton,
+void Widget::addonsSetupConnections(QPushButton *addonsBackButton,
                                     QPushButton *archZGamingMetaButton, QPushButton *arch7zDevelopmentButton, QPushButton *chaoticAURbutton,
                                     QPushButton *vmwButton, QCheckBox *flatpakToggle, QCheckBox *snapdToggle) {
         // Navigation connections
-        connect(addonsButton, &QPushButton::clicked, this, [stackedWidget]() {
-        stackedWidget->setCurrentIndex(2); // Switch to Addons page
-    });
-        connect(addonsBackButton, &QPushButton::clicked, this, [stackedWidget]() {
-        stackedWidget->setCurrentIndex(0); // Switch back to Main page
+        connect(addonsBackButton, &QPushButton::clicked, this, [this]() {
+        showPage(MainPage); // Switch back to Main page
     });
 
         // Connecting Buttons to their respective Functions
@@ -1899,12 +1351,12 @@ void Widget::addonsSetupConnections(QStackedWidget *stackedWidget, QPushButton *
 
         //** Chaotic AUR **//
         connect(chaoticAURbutton, &QPushButton::clicked, this, [=]() mutable {
-            int chaoticStatus = checkChaoticAURStatus();
+            int chaoticStatus = CoreServices::checkChaoticAURStatus();
 
-            chaoticAUR();
+            coreServices->chaoticAUR();
 
             // **Recheck status after operation**
-            chaoticStatus = checkChaoticAURStatus();
+            chaoticStatus = CoreServices::checkChaoticAURStatus();
             chaoticAURbutton->setText(chaoticStatus == 0 ? "Remove Chaotic AUR" :
                                           chaoticStatus == 1 ? "Add Chaotic AUR" :
                                           "Repair Chaotic AUR");
@@ -1943,25 +1395,22 @@ void Widget::addonsSetupConnections(QStackedWidget *stackedWidget, QPushButton *
 ///////////////////////////////////////////////////
 /// TERMINAL SETUP CONNECTIONS FUNCTION
 //////////////////////////////////////////////////
-void Widget::terminalSetupConnections(QStackedWidget *stackedWidget, QPushButton *terminalButton, QPushButton *terminalBackButton,
+void Widget::terminalSetupConnections(QPushButton *terminalBackButton,
                                       QPushButton *terminalThemeButton, QPushButton *changeShellButton, QComboBox *shellComboBox,
                                       QLabel *shellLabel) {
     // Navigation connections
-    connect(terminalButton, &QPushButton::clicked, this, [stackedWidget] () {
-        stackedWidget->setCurrentIndex(3); // Switch to Terminal page
-    });
-    connect(terminalBackButton, &QPushButton::clicked, this, [stackedWidget]() {
-        stackedWidget->setCurrentIndex(0); // Switch back to Main page
+    connect(terminalBackButton, &QPushButton::clicked, this, [this]() {
+        showPage(MainPage); // Switch back to Main page
     });
 
     //** Enable/Disable Terminal theming **//
     connect(terminalThemeButton, &QPushButton::clicked, this, [=]() mutable {
-        int termStatus = checkTermThemingStatus();
+        int termStatus = CoreServices::checkTermThemingStatus();
 
-        if(checkTermThemingStatus() == 0) {
-            disableTermTheme(terminalThemeButton);
+        if(CoreServices::checkTermThemingStatus() == 0) {
+            coreServices->disableTermTheme(terminalThemeButton);
         } else {
-            disableTermTheme(terminalThemeButton);
+            coreServices->disableTermTheme(terminalThemeButton);
         }
     });
 
@@ -1978,100 +1427,102 @@ void Widget::terminalSetupConnections(QStackedWidget *stackedWidget, QPushButton
 }
 
 ///////////////////////////////////////////////////
-/// MOUNT DRIVES SETUP CONNECTION
+/// MOUNT DRIVES PAGE
 //////////////////////////////////////////////////
-void Widget::mountDrivesSetupConnections(QStackedWidget *stackedWidget,
-                                         QToolButton *mountDriveButton) {
-    connect(mountDriveButton, &QToolButton::clicked, this, [this, stackedWidget]() {
-        if (!mountDrivesPage) {
-            mountDrivesPage = new QWidget(this);
-            QVBoxLayout *mainLayout = new QVBoxLayout(mountDrivesPage);
-            mainLayout->setContentsMargins(0, 0, 0, 0);
-
-            // INITIALIZE OR REFRESH THE DRIVES PAGE
-            if (!drivesPage) {
-                drivesPage = new drive_list_widget(mountDrivesPage);
-            } else {
-                drivesPage->refresh();
-            }
-            mainLayout->addWidget(drivesPage, 1);
-
-            QHBoxLayout *bottomLayout = new QHBoxLayout();
-            QPushButton *mountDrivesBackButton = new QPushButton("Back", mountDrivesPage);
-            bottomLayout->addWidget(mountDrivesBackButton, 0, Qt::AlignLeft);
-            bottomLayout->addStretch();
-            QPushButton *showAdditionalButton = new QPushButton("Show Additional Partitions", mountDrivesPage);
-            bottomLayout->addWidget(showAdditionalButton, 0, Qt::AlignCenter);
-            bottomLayout->addStretch();
-            QPushButton *mountUnmountButton = new QPushButton("Mount/Unmount", mountDrivesPage);
-            mountUnmountButton->setObjectName("mountUnmountButton");
+QWidget *Widget::buildMountDrivesPage() {
+    mountDrivesPage = new QWidget(this);
+    QVBoxLayout *mainLayout = new QVBoxLayout(mountDrivesPage);
+    mainLayout->setContentsMargins(0, 0, 0, 0);
+
+    // INITIALIZE THE DRIVES PAGE
+    drivesPage = new drive_list_widget(mountDrivesPage);
+    mainLayout->addWidget(drivesPage, 1);
+
+    QHBoxLayout *bottomLayout = new QHBoxLayout();
+    QPushButton *mountDrivesBackButton = new QPushButton("Back", mountDrivesPage);
+    bottomLayout->addWidget(mountDrivesBackButton, 0, Qt::AlignLeft);
+    bottomLayout->addStretch();
+    QPushButton *showAdditionalButton = new QPushButton("Show Additional Partitions", mountDrivesPage);
+    bottomLayout->addWidget(showAdditionalButton, 0, Qt::AlignCenter);
+    bottomLayout->addStretch();
+    QPushButton *mountUnmountButton = new QPushButton("Mount/Unmount", mountDrivesPage);
+    mountUnmountButton->setObjectName("mountUnmountButton");
+    mountUnmountButton->setEnabled(false);
+    bottomLayout->addWidget(mountUnmountButton, 0, Qt::AlignRight);
+
+    mainLayout->addLayout(bottomLayout);
+    mountDrivesPage->setLayout(mainLayout);
+
+    connect(mountDrivesBackButton, &QPushButton::clicked, this, [this]() {
+        showPage(MainPage);
+    });
+
+    // CONNECT SELECTION CHANGED SIGNAL TO UPDATE THE MOUNT/UNMOUNT BUTTON
+    connect(drivesPage, &drive_list_widget::selectionChanged, this, [this, mountUnmountButton]() {
+        bool mod = drivesPage->isModified();
+        qDebug() << "SELECTION CHANGED CALLED - isModified():" << mod;
+        bool dangerous = drivesPage->isDangerousModified();
+        qDebug() << "DANGEROUS STATE:" << dangerous;
+        if (mod) {
+            mountUnmountButton->setEnabled(true);
+            mountUnmountButton->setProperty("dangerousState", dangerous);
+        } else {
             mountUnmountButton->setEnabled(false);
-            bottomLayout->addWidget(mountUnmountButton, 0, Qt::AlignRight);
+            mountUnmountButton->setProperty("dangerousState", false);
+        }
+        // APPLY STYLING BASED ON DANGEROUS STATE
+        if (mountUnmountButton->property("dangerousState").toBool())
+            mountUnmountButton->setStyleSheet("background-color: red;");
+        else
+            mountUnmountButton->setStyleSheet("");
+        qDebug() << "MOUNT/UNMOUNT BUTTON ENABLED:" << mountUnmountButton->isEnabled();
+    });
 
-            mainLayout->addLayout(bottomLayout);
-            mountDrivesPage->setLayout(mainLayout);
-            stackedWidget->insertWidget(4, mountDrivesPage);
+    connect(showAdditionalButton, &QPushButton::clicked, this, [this]() {
+        drivesPage->showAdditionalPartitionsDialog();
+    });
 
-            connect(mountDrivesBackButton, &QPushButton::clicked, this, [stackedWidget]() {
-                stackedWidget->setCurrentIndex(0);
-            });
+    // MOUNT/UNMOUNT BUTTON CLICK HANDLER
+    connect(mountUnmountButton, &QPushButton::clicked, this, [this, mountUnmountButton]() {
+        QMessageBox::StandardButton reply;
+        reply = QMessageBox::question(this, "Mount/Unmount", "Are you sure you want to proceed?",
+                                      QMessageBox::Yes | QMessageBox::No);
+        if (reply == QMessageBox::Yes) {
+            // Stays disabled while the polkit prompt is open
+            mountUnmountButton->setEnabled(false);
+            drivesPage->applyMountSelection();
+        }
+    });
 
-            // CONNECT SELECTION CHANGED SIGNAL TO UPDATE THE MOUNT/UNMOUNT BUTTON
-            connect(drivesPage, &drive_list_widget::selectionChanged, this, [this, mountUnmountButton]() {
-                bool mod = drivesPage->isModified();
-                qDebug() << "SELECTION CHANGED CALLED - isModified():" << mod;
-                bool dangerous = drivesPage->isDangerousModified();
-                qDebug() << "DANGEROUS STATE:" << dangerous;
-                if (mod) {
-                    mountUnmountButton->setEnabled(true);
-                    mountUnmountButton->setProperty("dangerousState", dangerous);
-                } else {
-                    mountUnmountButton->setEnabled(false);
-                    mountUnmountButton->setProperty("dangerousState", false);
-                }
-                // APPLY STYLING BASED ON DANGEROUS STATE
-                if (mountUnmountButton->property("dangerousState").toBool())
-                    mountUnmountButton->setStyleSheet("background-color: red;");
-                else
-                    mountUnmountButton->setStyleSheet("");
-                qDebug() << "MOUNT/UNMOUNT BUTTON ENABLED:" << mountUnmountButton->isEnabled();
-            });
+    connect(drivesPage, &drive_list_widget::applyFinished, this, [this, mountUnmountButton](bool ok) {
+        // If the operation was canceled (for example, pkexec cancelled), or
+        // failed, simply revert the edits instead of displaying error dialogs.
+        if (!ok || drivesPage->operationCancelled()) {
+            drivesPage->revertChanges();
+            return;
+        }
+        // Rows follow the daemon's MountChanged / MountFailed signals from here,
+        // no need to rebuild the list.
 
-            connect(showAdditionalButton, &QPushButton::clicked, this, [this]() {
-                drivesPage->showAdditionalPartitionsDialog();
-            });
+        bool mod = drivesPage->isModified();
+        mountUnmountButton->setEnabled(mod);
+        bool dangerous = drivesPage->isDangerousModified();
+        mountUnmountButton->setProperty("dangerousState", dangerous);
+        mountUnmountButton->setStyleSheet(dangerous ? "background-color: red;" : "");
 
-            // MOUNT/UNMOUNT BUTTON CLICK HANDLER
-            connect(mountUnmountButton, &QPushButton::clicked, this, [this, mountUnmountButton]() {
-                QMessageBox::StandardButton reply;
-                reply = QMessageBox::question(this, "Mount/Unmount", "Are you sure you want to proceed?",
-                                              QMessageBox::Yes | QMessageBox::No);
-                if (reply == QMessageBox::Yes) {
-                    if (drivesPage->applyMountSelection()) {
-                        // If the operation was canceled (for example, pkexec cancelled),
-                        // simply refresh and exit silently.
-                        if (drivesPage->operationCancelled()) {
-                            drivesPage->refresh();
-                            return;
-                        }
-                        drivesPage->refresh();
-
-                        bool mod = drivesPage->isModified();
-                        mountUnmountButton->setEnabled(mod);
-                        bool dangerous = drivesPage->isDangerousModified();
-                        mountUnmountButton->setProperty("dangerousState", dangerous);
-                        mountUnmountButton->setStyleSheet(dangerous ? "background-color: red;" : "");
-
-                        QMessageBox::information(this, "Mount/Unmount",
-                                                 "The process has been successfully completed!");
-                    } else {
-                        // Instead of displaying error dialogs, just refresh the drive page.
-                        drivesPage->refresh();
-                    }
-                }
-            });
+        QMessageBox::information(this, "Mount/Unmount",
+                                 "The process has been successfully completed!");
+    });
 
-        } else {
+    return mountDrivesPage;
+}
+
+///////////////////////////////////////////////////
+/// MOUNT DRIVES SETUP CONNECTION
+//////////////////////////////////////////////////
+void Widget::mountDrivesSetupConnections(QToolButton *mountDriveButton) {
+    connect(mountDriveButton, &QToolButton::clicked, this, [this]() {
+        if (mountDrivesPage) {
             // IF THE PAGE ALREADY EXISTS, REFRESH THE DRIVE PAGE
             drivesPage->refresh();
 
@@ -2094,7 +1545,7 @@ void Widget::mountDrivesSetupConnections(QStackedWidget *stackedWidget,
                 qDebug() << "MOUNT/UNMOUNT BUTTON (EXISTING PAGE) ENABLED:" << mountUnmountButton->isEnabled();
             }
         }
-        stackedWidget->setCurrentIndex(4);
+        showPage(MountDrivesPage);
     });
 }
 
@@ -9,9 +9,13 @@
 #include <QLabel>
 #include <QCheckBox>
 #include "core_functions.h"
+#include "core_services.h"
 #include "drive_list_widget.h"
+#include "update_prefetcher.h"
 #include <QToolButton>
 #include <QBoxLayout>
+#include <QMap>
+#include <functional>
 
 QT_BEGIN_NAMESPACE
 namespace Ui {
@@ -22,12 +26,10 @@ QT_END_NAMESPACE
 class Widget : public QWidget
 {
     Q_OBJECT
-    friend class Widget_Initial;
 
 public:
     Widget(QWidget *parent = nullptr);
     ~Widget();
-    void cleanCache();
 
 private slots:
     // TERMINAL
@@ -42,8 +44,7 @@ private slots:
     void cleanPkgCache();
     void systemUpdate();
     void removeDBLock();
-    void tweaksSetupConnections(QStackedWidget *stackedWidget, QPushButton *tweaksButton, QPushButton *backButton,
-                                QPushButton *cleanOrphansButton, QPushButton *cleanPkgCacheButton,
+    void tweaksSetupConnections(QPushButton *backButton, QPushButton *cleanOrphansButton, QPushButton *cleanPkgCacheButton,
                                 QPushButton *updateSystemButton, QPushButton *removeDBLockButton, QCheckBox *bluetoothToggle,
                                 QCheckBox *appArmorToggle, QPushButton *rankMirrorsButton);
     // ADDONS
@@ -51,31 +52,46 @@ private slots:
     void removeArchZGamingMeta();
     void arch7zDevelopmentMeta();
     void removeArch7zDevelopmentMeta();
-    void chaoticAUR();
-    void removeChaoticAUR();
-    bool runCommand(const QString &cmd);
-    int checkChaoticAURStatus();
-    void backupPacmanConfig();
+    void removeMetaPackage(const QString &metaPackage, const QString &title);
     void addVMware(QPushButton *vmwButton);
     bool vmwareStatus();
     bool vmwareServiceStatus();
-    void addonsSetupConnections(QStackedWidget *stackedWidget, QPushButton *addonsButton, QPushButton *addonsBackButton,
-                                QPushButton *archZGamingMetaButton, QPushButton *archZDevelopmentButton, QPushButton *chaoticAURButton,
+    void addonsSetupConnections(QPushButton *addonsBackButton, QPushButton *archZGamingMetaButton, QPushButton *archZDevelopmentButton, QPushButton *chaoticAURButton,
                                 QPushButton *vmwButton, QCheckBox *flatpakToggle, QCheckBox *snapdToggle);
     // TERMINAL
-    void terminalSetupConnections(QStackedWidget *stackedWidget, QPushButton *terminalButton, QPushButton *terminalBackButton,
-                                  QPushButton *terminalThemeButton, QPushButton *changeShellButton, QComboBox *shellComboBox, QLabel *shellLabel);
-    void disableTermTheme(QPushButton *terminalThemeButton);
-    int checkTermThemingStatus();
+    void terminalSetupConnections(QPushButton *terminalBackButton, QPushButton *terminalThemeButton, QPushButton *changeShellButton, QComboBox *shellComboBox, QLabel *shellLabel);
     int asciiLogoStatus();
     void enableAsciiLogo();
     // MOUNT/UNMOUNT DRIVES
-    void mountDrivesSetupConnections(QStackedWidget *stackedWidget, QToolButton *mountDriveButton);
+    void mountDrivesSetupConnections(QToolButton *mountDriveButton);
 
 private:
+    // Pages of the main stacked widget. Everything but MainPage is built
+    // on first use through the builder registered for it.
+    enum Page {
+        MainPage,
+        TweaksPage,
+        AddonsPage,
+        TerminalPage,
+        MountDrivesPage
+    };
+
     Ui::Widget *ui;
 
+    QStackedWidget *m_stackedWidget = nullptr;
+    QMap<Page, std::function<QWidget *()>> m_pageFactories;
+    QMap<Page, QWidget *> m_pages;
+
+    void registerPage(Page page, std::function<QWidget *()> factory);
+    void showPage(Page page);
+    QWidget *buildTweaksPage();
+    QWidget *buildAddonsPage();
+    QWidget *buildTerminalPage();
+    QWidget *buildMountDrivesPage();
+
     CoreFunctions* coreFunctions;
+    CoreServices* coreServices;
+    UpdatePrefetcher *m_updatePrefetcher = nullptr;
     QWidget *mountDrivesPage = nullptr;
     drive_list_widget* drivesPage = nullptr;
 
@@ -1,7 +1,8 @@
 #include "widgetInitial.h"
 #include "core_functions.h"
 #include "core_initial.h"
-#include "widget.h"
+#include "core_services.h"
+#include "status_prober.h"
 #include <QDir>
 #include <QDebug>
 #include <QProgressDialog>
@@ -18,6 +19,7 @@
 #include <QSettings>
 #include <QProcess>
 #include <QImageReader>
+#include <QGridLayout>
 
 // for links to work
 #include <QDesktopServices>
@@ -30,10 +32,57 @@ Widget_Initial::Widget_Initial(QWidget *parent)
     // ui->setupUi(this); // Commented out - no UI file
 
     coreFunctions = new CoreFunctions(this);
-    widget = new Widget(this);
-    widget->hide();
+    coreServices = new CoreServices(this);
     coreInitial = new CoreInitial();
 
+    // Fire every toggle's status probe at once. The pages below are built with
+    // placeholder toggles that settle as each result comes back.
+    statusProber = new StatusProber(this);
+
+    QFuture<bool> flatpakProbe = statusProber->probe<bool>([]() {
+        return CoreFunctions::flatpakStatus() == 0;
+    });
+    QFuture<bool> snapdProbe = statusProber->probe<bool>([]() {
+        return CoreFunctions::snapdStatus() == 0;
+    });
+    QFuture<bool> chaoticProbe = statusProber->probe<bool>([]() {
+        return CoreServices::checkChaoticAURStatus() == 0;
+    });
+    QFuture<bool> xrayThemingProbe = statusProber->probe<bool>([this]() {
+        return coreInitial->xrayThemeStatus();
+    });
+    QFuture<bool> terminalThemingProbe = statusProber->probe<bool>([this]() {
+        return coreInitial->osreleaseStatus() && coreInitial->konsoleProfStatus() &&
+            CoreServices::checkTermThemingStatus() == 1;
+    });
+    QFuture<bool> grubThemingProbe = statusProber->probe<bool>([this]() {
+        return coreInitial->grubThemeStatus();
+    });
+    QFuture<bool> yayProbe = statusProber->probe<bool>([this]() {
+        return coreInitial->aurStatus(QString("yay"));
+    });
+    QFuture<bool> paruProbe = statusProber->probe<bool>([this]() {
+        return coreInitial->aurStatus(QString("paru"));
+    });
+    QFuture<bool> tolitoProbe = statusProber->probe<bool>([this]() {
+        return coreInitial->aurStatus(QString("tolito"));
+    });
+    QFuture<bool> discoverProbe = statusProber->probe<bool>([this]() {
+        return coreInitial->storeStatus(QString("discover"));
+    });
+    QFuture<bool> pamacProbe = statusProber->probe<bool>([this]() {
+        return coreInitial->storeStatus(QString("pamac-all"));
+    });
+    QFuture<bool> octopiProbe = statusProber->probe<bool>([this]() {
+        return coreInitial->storeStatus(QString("octopi"));
+    });
+    QFuture<bool> bazaarProbe = statusProber->probe<bool>([this]() {
+        return coreInitial->storeStatus(QString("bazaar"));
+    });
+    QFuture<bool> gamingMetaProbe = statusProber->probe<bool>([this]() {
+        return coreInitial->gamingMetaStatus();
+    });
+
     setWindowTitle("Tolitica Xray_OS Assistant");
     resize(800,600);
     setWindowIcon(QIcon(":/icons/resources/icons/tolitica-icon.png"));
@@ -138,29 +187,16 @@ Widget_Initial::Widget_Initial(QWidget *parent)
     //flatpakLabel->setStyleSheet("font-size: 14px; color: white;");
 
     // Toggle switch
-    bool isEnabled = (CoreFunctions::flatpakStatus() == 0);
-
     QWidget *toggleSwitch = new QWidget(this);
     toggleSwitch->setFixedSize(60, 30);
 
-    if (isEnabled) {
-        toggleSwitch->setStyleSheet("QWidget { background-color: #4a9eff; border-radius: 15px; }");
-    } else {
-        toggleSwitch->setStyleSheet("QWidget { background-color: #666666; border-radius: 15px; }");
-    }
-
     QPushButton *toggleButton = new QPushButton(toggleSwitch);
     toggleButton->setFixedSize(26, 26);
-    if (isEnabled)
-    {
-        toggleButton->move(32, 2); // Start in enabled position
-    } else {
-        toggleButton->move(2, 2);
-    }
-
     toggleButton->setStyleSheet("QPushButton { background-color: white; border-radius: 13px; border: none; }");
 
-    flatpakLabel->setText(isEnabled ? "Disable/Remove Flatpak" : "Enable/Install Flatpak");
+    // Placeholder until the flatpak probe reports back
+    setToggleLoading(toggleSwitch, toggleButton);
+    flatpakLabel->setText("Checking Flatpak...");
 
     QPropertyAnimation *toggleAnimation = new QPropertyAnimation(toggleButton, "pos");
     toggleAnimation->setDuration(500);
@@ -181,35 +217,38 @@ Widget_Initial::Widget_Initial(QWidget *parent)
         flatpakToggleAnim->start();
     });
 
-    // Toggle effect on click and Logic
-    connect(toggleButton, &QPushButton::clicked, this, [=]() mutable {
-        // Temporary QCheckBox that mimics the toggle state
-        QCheckBox *tempCheckBox = new QCheckBox();
-        tempCheckBox->setChecked(isEnabled);
-
-        // Pass callback to handle UI updates when async operation completes
-        CoreFunctions::enableFlatpak(this, tempCheckBox, [=](bool success) mutable {
-            if (success) {
-                isEnabled = tempCheckBox->isChecked();
-
-                if (isEnabled) {
-                    toggleAnimation->setEndValue(QPoint(32, 2));
-                    toggleSwitch->setStyleSheet("QWidget { background-color: #4a9eff; border-radius: 15px; }");
-                } else {
-                    toggleAnimation->setEndValue(QPoint(2, 2));
-                    toggleSwitch->setStyleSheet("QWidget { background-color: #666666; border-radius: 15px; }");
+    statusProber->whenReady(flatpakProbe, this, [=](bool isEnabled) {
+        flatpakLabel->setText(isEnabled ? "Disable/Remove Flatpak" : "Enable/Install Flatpak");
+        settleToggle(toggleSwitch, toggleButton, toggleAnimation, isEnabled);
+
+        // Toggle effect on click and Logic
+        connect(toggleButton, &QPushButton::clicked, this, [=]() mutable {
+            // Temporary QCheckBox that mimics the toggle state
+            QCheckBox *tempCheckBox = new QCheckBox();
+            tempCheckBox->setChecked(isEnabled);
+
+            // Pass callback to handle UI updates when async operation completes
+            CoreFunctions::enableFlatpak(this, tempCheckBox, [=](bool success) mutable {
+                if (success) {
+                    isEnabled = tempCheckBox->isChecked();
+
+                    if (isEnabled) {
+                        toggleAnimation->setEndValue(QPoint(32, 2));
+                        toggleSwitch->setStyleSheet("QWidget { background-color: #4a9eff; border-radius: 15px; }");
+                    } else {
+                        toggleAnimation->setEndValue(QPoint(2, 2));
+                        toggleSwitch->setStyleSheet("QWidget { background-color: #666666; border-radius: 15px; }");
+                    }
+                    flatpakLabel->setText(isEnabled ? "Disable/Remove Flatpak" : "Enable/Install Flatpak");
+                    toggleAnimation->start();
                 }
-                flatpakLabel->setText(isEnabled ? "Disable/Remove Flatpak" : "Enable/Install Flatpak");
-                toggleAnimation->start();
-            }
 
-            // Now it's safe to delete
-            tempCheckBox->deleteLater();
+                // Now it's safe to delete
+                tempCheckBox->deleteLater();
+            });
         });
     });
 
-    flatpakLabel->setText(isEnabled ? "Disable/Remove Flatpak" : "Enable/Install Flatpak");
-
     flatpakContainer->setFixedWidth(500);
 
     flatpakLayout->addWidget(flatpakIconLabel);
@@ -233,30 +272,15 @@ Widget_Initial::Widget_Initial(QWidget *parent)
     QLabel *snapdLabel = new QLabel("Enable/Disable Snapd", this);
     // snapdLabel->setStyleSheet("font-size: 14px; color: white");
 
-    bool isSnapdEnabled = (coreFunctions->snapdStatus() == 0);
-
     QWidget *snapdToggleSwitch = new QWidget(this);
     snapdToggleSwitch->setFixedSize(60, 30);
 
-    if (isSnapdEnabled) {
-        snapdToggleSwitch->setStyleSheet(
-            "QWidget { background-color: #4a9eff; border-radius: 15px; }");
-    }
-    else {
-        snapdToggleSwitch->setStyleSheet(
-            "QWidget { background-color: #666666; border-radius: 15px; }");
-    }
-
     QPushButton *snapdToggleButton = new QPushButton(snapdToggleSwitch);
     snapdToggleButton->setFixedSize(26, 26);
-    if (isSnapdEnabled) {
-        snapdToggleButton->move(32, 2);
-    } else {
-        snapdToggleButton->move(2, 2);
-    }
 
     snapdToggleButton->setStyleSheet("QPushButton { background-color: white; border-radius: 13px; border: none; }");
-    snapdLabel->setText(isSnapdEnabled ? "Disable/Remove Snapd" : "Enable/Install Snapd");
+    setToggleLoading(snapdToggleSwitch, snapdToggleButton);
+    snapdLabel->setText("Checking Snapd...");
 
     QPropertyAnimation *snapdToggleAnim = new QPropertyAnimation(snapdToggleButton, "pos");
     snapdToggleAnim->setDuration(500);
@@ -277,30 +301,33 @@ Widget_Initial::Widget_Initial(QWidget *parent)
         snapdIconAnim->start();
     });
 
-    // Toggle effect on click and Logic
-    connect(snapdToggleButton, &QPushButton::clicked, this, [=]() mutable {
-        QCheckBox *snapdTempCheckBox = new QCheckBox();
-        snapdTempCheckBox->setChecked(isSnapdEnabled);
-
-        coreFunctions->enableSnapd(this, snapdTempCheckBox, [=](bool snapdSuccess) mutable {
-            if (snapdSuccess) {
-                isSnapdEnabled = snapdTempCheckBox->isChecked();
-
-                if (isSnapdEnabled) {
-                    snapdToggleAnim->setEndValue(QPoint(32, 2));
-                    snapdToggleSwitch->setStyleSheet("QWidget { background-color: #4a9eff; border-radius: 15px; }");
-                } else {
-                    snapdToggleAnim->setEndValue(QPoint(2, 2));
-                    snapdToggleSwitch->setStyleSheet("QWidget { background-color: #666666; border-radius: 15px; }");
+    statusProber->whenReady(snapdProbe, this, [=](bool isSnapdEnabled) {
+        snapdLabel->setText(isSnapdEnabled ? "Disable/Remove Snapd" : "Enable/Install Snapd");
+        settleToggle(snapdToggleSwitch, snapdToggleButton, snapdToggleAnim, isSnapdEnabled);
+
+        // Toggle effect on click and Logic
+        connect(snapdToggleButton, &QPushButton::clicked, this, [=]() mutable {
+            QCheckBox *snapdTempCheckBox = new QCheckBox();
+            snapdTempCheckBox->setChecked(isSnapdEnabled);
+
+            coreFunctions->enableSnapd(this, snapdTempCheckBox, [=](bool snapdSuccess) mutable {
+                if (snapdSuccess) {
+                    isSnapdEnabled = snapdTempCheckBox->isChecked();
+
+                    if (isSnapdEnabled) {
+                        snapdToggleAnim->setEndValue(QPoint(32, 2));
+                        snapdToggleSwitch->setStyleSheet("QWidget { background-color: #4a9eff; border-radius: 15px; }");
+                    } else {
+                        snapdToggleAnim->setEndValue(QPoint(2, 2));
+                        snapdToggleSwitch->setStyleSheet("QWidget { background-color: #666666; border-radius: 15px; }");
+                    }
+                    snapdLabel->setText(isSnapdEnabled ? "Disable/Remove Snapd" : "Enable/Install Snapd");
+                    snapdToggleAnim->start();
                 }
-                snapdLabel->setText(isSnapdEnabled ? "Disable/Remove Snapd" : "Enable/Install Snapd");
-                snapdToggleAnim->start();
-            }
-            snapdTempCheckBox->deleteLater();
+                snapdTempCheckBox->deleteLater();
+            });
         });
     });
-
-    snapdLabel->setText(isSnapdEnabled ? "Disable/Remove Snapd" : "Enable/Install Snapd");
     snapdContainer->setFixedWidth(500);
 
     snapdContainerLayout->addWidget(snapdIconLabel);
@@ -324,31 +351,16 @@ Widget_Initial::Widget_Initial(QWidget *parent)
 
     QLabel *chaoticLabel = new QLabel("Enable/Disable Chaotic-AUR", this);
 
-    bool isChaoticEnabled = (widget->checkChaoticAURStatus() == 0);
-
     QWidget *chaoticToggleSwitch = new QWidget(this);
     chaoticToggleSwitch->setFixedSize(60, 30);
 
-    if (isChaoticEnabled) {
-        chaoticToggleSwitch->setStyleSheet(
-            "QWidget { background-color: #4a9eff; border-radius: 15px; }");
-    } else {
-        chaoticToggleSwitch->setStyleSheet(
-            "QWidget { background-color: #666666; border-radius: 15px; }");
-    }
-
     QPushButton *chaoticToggleButton = new QPushButton(chaoticToggleSwitch);
     chaoticToggleButton->setFixedSize(26, 26);
-    if (isChaoticEnabled) {
-        chaoticToggleButton->move(32, 2);
-    } else {
-        chaoticToggleButton->move(2, 2);
-    }
 
     chaoticToggleButton->setStyleSheet(
         "QPushButton { background-color: white; border-radius: 13px; border: none }");
-    chaoticLabel->setText(isChaoticEnabled ?
-        "Disable/Remove Chaotic AUR" : "Enable/Install Chaotic AUR");
+    setToggleLoading(chaoticToggleSwitch, chaoticToggleButton);
+    chaoticLabel->setText("Checking Chaotic-AUR...");
 
     QPropertyAnimation *chaoticToggleAnim = new QPropertyAnimation(chaoticToggleButton, "pos");
     chaoticToggleAnim->setDuration(500);
@@ -371,10 +383,10 @@ Widget_Initial::Widget_Initial(QWidget *parent)
 
     // Toggle effect on click and logic
     connect(chaoticToggleButton, &QPushButton::clicked, this, [=]() mutable {
-    widget->chaoticAUR();
+    coreServices->chaoticAUR();
 
     // Update UI after operation
-    isChaoticEnabled = (widget->checkChaoticAURStatus() == 0);
+    bool isChaoticEnabled = (CoreServices::checkChaoticAURStatus() == 0);
     if (isChaoticEnabled) {
         chaoticToggleAnim->setEndValue(QPoint(32, 2));
         chaoticToggleSwitch->setStyleSheet(
@@ -389,8 +401,11 @@ Widget_Initial::Widget_Initial(QWidget *parent)
     chaoticToggleAnim->start();
     });
 
-    chaoticLabel->setText(isChaoticEnabled ? "Disable/Remove Chaotic-AUR" :
-        "Enable/Install Chaotic-AUR");
+    statusProber->whenReady(chaoticProbe, this, [=](bool isChaoticEnabled) {
+        chaoticLabel->setText(isChaoticEnabled ? "Disable/Remove Chaotic-AUR" :
+            "Enable/Install Chaotic-AUR");
+        settleToggle(chaoticToggleSwitch, chaoticToggleButton, chaoticToggleAnim, isChaoticEnabled);
+    });
     chaoticContainer->setFixedWidth(500);
 
     chaoticLayout->addWidget(chaoticIconLabel);
@@ -479,35 +494,18 @@ Widget_Initial::Widget_Initial(QWidget *parent)
     xrayThemingIconLabel->setPixmap(xrayThemingIconScaled);
     QLabel *xrayThemingLabel = new QLabel("Enable/Disable Xray Theming", this);
 
-    bool isXrayThemingEnabled = coreInitial->xrayThemeStatus();
-
     // Toggle switch
     QWidget *xrayThemingToggleSwitch = new QWidget(this);
     xrayThemingToggleSwitch->setFixedSize(60, 30);
 
-    if (isXrayThemingEnabled) {
-        xrayThemingToggleSwitch->setStyleSheet(
-            "QWidget { background-color: #4a9eff; border-radius: 15px; }"
-        );
-    } else {
-        xrayThemingToggleSwitch->setStyleSheet(
-            "QWidget { background-color: #666666; border-radius: 15px; }"
-        );
-    }
-
     QPushButton *xrayThemingToggleButton = new QPushButton(xrayThemingToggleSwitch);
     xrayThemingToggleButton->setFixedSize(26, 26);
-    if (isXrayThemingEnabled) {
-        xrayThemingToggleButton->move(32, 2);
-    } else {
-        xrayThemingToggleButton->move(2, 2);
-    }
 
     xrayThemingToggleButton->setStyleSheet(
         "QPushButton { background-color: white; border-radius: 13px; border: none; }"
     );
-    xrayThemingLabel->setText(isXrayThemingEnabled ? "Go back default Breeze Dark" :
-        "Switch to Xray_OS theming");
+    setToggleLoading(xrayThemingToggleSwitch, xrayThemingToggleButton);
+    xrayThemingLabel->setText("Checking Xray_OS theming...");
 
     QPropertyAnimation *xrayThemingToggleAnim = new QPropertyAnimation(xrayThemingToggleButton, "pos");
     xrayThemingToggleAnim->setDuration(500);
@@ -530,24 +528,31 @@ Widget_Initial::Widget_Initial(QWidget *parent)
     });
 
 
-    connect(xrayThemingToggleButton, &QPushButton::clicked, this, [=]() mutable {
-        coreInitial->applyGlobalTheme(isXrayThemingEnabled ? "org.kde.breezedark.desktop" : "XRAY-DARK.desktop");
-
-        QTimer::singleShot(1000, [=]() {
-            coreInitial->reloadPlasmaByReplace();
-        });
-
-        isXrayThemingEnabled = !isXrayThemingEnabled;
-        if (isXrayThemingEnabled) {
-            xrayThemingToggleAnim->setEndValue(QPoint(32, 2));
-            xrayThemingToggleSwitch->setStyleSheet("QWidget { background-color: #4a9eff; border-radius: 15px; }");
-        } else {
-            xrayThemingToggleAnim->setEndValue(QPoint(2, 2));
-            xrayThemingToggleSwitch->setStyleSheet("QWidget { background-color: #666666; border-radius: 15px; }");
-        }
+    statusProber->whenReady(xrayThemingProbe, this, [=](bool isXrayThemingEnabled) {
         xrayThemingLabel->setText(isXrayThemingEnabled ? "Go back default Breeze Dark" :
             "Switch to Xray_OS theming");
-        xrayThemingToggleAnim->start();
+        settleToggle(xrayThemingToggleSwitch, xrayThemingToggleButton, xrayThemingToggleAnim,
+            isXrayThemingEnabled);
+
+        connect(xrayThemingToggleButton, &QPushButton::clicked, this, [=]() mutable {
+            coreInitial->applyGlobalTheme(isXrayThemingEnabled ? "org.kde.breezedark.desktop" : "XRAY-DARK.desktop");
+
+            QTimer::singleShot(1000, [=]() {
+                coreInitial->reloadPlasmaByReplace();
+            });
+
+            isXrayThemingEnabled = !isXrayThemingEnabled;
+            if (isXrayThemingEnabled) {
+                xrayThemingToggleAnim->setEndValue(QPoint(32, 2));
+                xrayThemingToggleSwitch->setStyleSheet("QWidget { background-color: #4a9eff; border-radius: 15px; }");
+            } else {
+                xrayThemingToggleAnim->setEndValue(QPoint(2, 2));
+                xrayThemingToggleSwitch->setStyleSheet("QWidget { background-color: #666666; border-radius: 15px; }");
+            }
+            xrayThemingLabel->setText(isXrayThemingEnabled ? "Go back default Breeze Dark" :
+                "Switch to Xray_OS theming");
+            xrayThemingToggleAnim->start();
+        });
     });
     xrayThemingContainer->setFixedWidth(500);
 
@@ -570,41 +575,17 @@ Widget_Initial::Widget_Initial(QWidget *parent)
 
     terminalThemingIconLabel->setPixmap(terminalThemingIconScaled);
     QLabel *terminalThemingLabel = new QLabel("Enable/Disable Terminal Theming", this);
-    bool osReleaseStatus = coreInitial->osreleaseStatus();
-    bool konsoleProfStatus = coreInitial->konsoleProfStatus();
-    int termThemStatus = widget->checkTermThemingStatus();
-
-    bool isTerminalThemingEnabled = (osReleaseStatus &&
-        konsoleProfStatus && termThemStatus == 1);
-
-    qDebug() << "isTerminalThemingEnabled: " << isTerminalThemingEnabled;
-
     QWidget *terminalThemingToggleSwitch = new QWidget(this);
     terminalThemingToggleSwitch->setFixedSize(60, 30);
 
-    if (isTerminalThemingEnabled) {
-        terminalThemingToggleSwitch->setStyleSheet(
-            "QWidget { background-color: #4a9eff; border-radius: 15px; }"
-        );
-    } else {
-        terminalThemingToggleSwitch->setStyleSheet(
-            "QWidget { background-color: #666666; border-radius: 15px; }"
-        );
-    }
-
     QPushButton *terminalThemingToggleButton = new QPushButton(terminalThemingToggleSwitch);
     terminalThemingToggleButton->setFixedSize(26, 26);
-    if (isTerminalThemingEnabled) {
-        terminalThemingToggleButton->move(32, 2);
-    } else {
-        terminalThemingToggleButton->move(2, 2);
-    }
 
     terminalThemingToggleButton->setStyleSheet(
         "QPushButton { background-color: white; border-radius: 13px; border: none; }"
     );
-    terminalThemingLabel->setText(isTerminalThemingEnabled ? "Disable terminal theming" :
-        "Enable terminal theming");
+    setToggleLoading(terminalThemingToggleSwitch, terminalThemingToggleButton);
+    terminalThemingLabel->setText("Checking terminal theming...");
 
     QPropertyAnimation *terminalThemingToggleAnimation = new
     QPropertyAnimation(terminalThemingToggleButton, "pos");
@@ -627,52 +608,61 @@ Widget_Initial::Widget_Initial(QWidget *parent)
         terminalThemingIconAnim->start();
     });
 
-    connect(terminalThemingToggleButton, &QPushButton::clicked, this, [=]() mutable {
-        // Get CURRENT status
-        bool currentOSreleaseStatus = coreInitial->osreleaseStatus();
-        bool osreleaseStatus = coreInitial->osreleaseStatus();
-        bool konsoleProfStatus = coreInitial->konsoleProfStatus();
-        int currentTermStatus = widget->checkTermThemingStatus();
+    statusProber->whenReady(terminalThemingProbe, this, [=](bool isTerminalThemingEnabled) {
+        qDebug() << "isTerminalThemingEnabled: " << isTerminalThemingEnabled;
 
-        if (!isTerminalThemingEnabled) {
-            if (!osreleaseStatus) {
-                coreInitial->setOSrelease();
-            }
-            if (!konsoleProfStatus) {
-                coreInitial->setKonsoleProfile();
+        terminalThemingLabel->setText(isTerminalThemingEnabled ? "Disable terminal theming" :
+            "Enable terminal theming");
+        settleToggle(terminalThemingToggleSwitch, terminalThemingToggleButton,
+            terminalThemingToggleAnimation, isTerminalThemingEnabled);
+
+        connect(terminalThemingToggleButton, &QPushButton::clicked, this, [=]() mutable {
+            // Get CURRENT status
+            bool currentOSreleaseStatus = coreInitial->osreleaseStatus();
+            bool osreleaseStatus = coreInitial->osreleaseStatus();
+            bool konsoleProfStatus = coreInitial->konsoleProfStatus();
+            int currentTermStatus = CoreServices::checkTermThemingStatus();
+
+            if (!isTerminalThemingEnabled) {
+                if (!osreleaseStatus) {
+                    coreInitial->setOSrelease();
+                }
+                if (!konsoleProfStatus) {
+                    coreInitial->setKonsoleProfile();
+                }
+                if (currentTermStatus != 1) {
+                    QPushButton *dummyButton = new QPushButton();
+                    coreServices->disableTermTheme(dummyButton);
+                    dummyButton->deleteLater();
+                }
             }
-            if (currentTermStatus != 1) {
+
+            if (isTerminalThemingEnabled) {
                 QPushButton *dummyButton = new QPushButton();
-                widget->disableTermTheme(dummyButton);
+                coreServices->disableTermTheme(dummyButton);
+
+                coreInitial->setOSrelease();
+                coreInitial->setKonsoleProfile();
                 dummyButton->deleteLater();
             }
-        }
-
-        if (isTerminalThemingEnabled) {
-            QPushButton *dummyButton = new QPushButton();
-            widget->disableTermTheme(dummyButton);
-
-            coreInitial->setOSrelease();
-            coreInitial->setKonsoleProfile();
-            dummyButton->deleteLater();
-        }
 
-        isTerminalThemingEnabled = !isTerminalThemingEnabled;
-
-        if (isTerminalThemingEnabled) {
-            terminalThemingToggleAnimation->setEndValue(QPoint(32, 2));
-            terminalThemingToggleSwitch->setStyleSheet(
-                "QWidget { background-color: #4a9eff; border-radius: 15px; }"
-            );
-        } else {
-            terminalThemingToggleAnimation->setEndValue(QPoint(2, 2));
-            terminalThemingToggleSwitch->setStyleSheet(
-                "QWidget { background-color: #666666; border-radius: 15px; }"
-            );
-        }
-        terminalThemingLabel->setText(isTerminalThemingEnabled ? "Disable terminal theming" :
-            "Enable terminal theming");
-        terminalThemingToggleAnimation->start();
+            isTerminalThemingEnabled = !isTerminalThemingEnabled;
+
+            if (isTerminalThemingEnabled) {
+                terminalThemingToggleAnimation->setEndValue(QPoint(32, 2));
+                terminalThemingToggleSwitch->setStyleSheet(
+                    "QWidget { background-color: #4a9eff; border-radius: 15px; }"
+                );
+            } else {
+                terminalThemingToggleAnimation->setEndValue(QPoint(2, 2));
+                terminalThemingToggleSwitch->setStyleSheet(
+                    "QWidget { background-color: #666666; border-radius: 15px; }"
+                );
+            }
+            terminalThemingLabel->setText(isTerminalThemingEnabled ? "Disable terminal theming" :
+                "Enable terminal theming");
+            terminalThemingToggleAnimation->start();
+        });
     });
     terminalThemingContainer->setFixedWidth(500);
 
@@ -695,35 +685,18 @@ Widget_Initial::Widget_Initial(QWidget *parent)
 
     grubThemingIconLabel->setPixmap(grubThemingIconScaled);
     QLabel *grubThemingLabel = new QLabel("Enable/Disable Grub Theming", this);
-    bool isGrubThemeEnabled = coreInitial->grubThemeStatus();
-    qDebug() << "grubThemeStatus: " << isGrubThemeEnabled;
-
     QWidget *grubThemingToggleSwitch = new QWidget(this);
     grubThemingToggleSwitch->setFixedSize(60, 30);
 
-    if (isGrubThemeEnabled) {
-        grubThemingToggleSwitch->setStyleSheet(
-            "QWidget { background-color: #4a9eff; border-radius: 15px; }");
-    } else {
-        grubThemingToggleSwitch->setStyleSheet(
-            "QWidget { background-color: #666666; border-radius: 15px; }"
-        );
-    }
-
     QPushButton *grubThemingToggleButton = new
     QPushButton(grubThemingToggleSwitch);
     grubThemingToggleButton->setFixedSize(26, 26);
-    if (isGrubThemeEnabled) {
-        grubThemingToggleButton->move(32, 2);
-    } else {
-        grubThemingToggleButton->move(2, 2);
-    }
 
     grubThemingToggleButton->setStyleSheet(
         "QPushButton { background-color: white; border-radius: 13px; border: none; }"
     );
-    grubThemingLabel->setText(isGrubThemeEnabled ? "Disable Grub theming" :
-        "Enable Grub theming");
+    setToggleLoading(grubThemingToggleSwitch, grubThemingToggleButton);
+    grubThemingLabel->setText("Checking Grub theming...");
 
     QPropertyAnimation *grubThemingToggleAnimation = new
     QPropertyAnimation(grubThemingToggleButton, "pos");
@@ -746,21 +719,30 @@ Widget_Initial::Widget_Initial(QWidget *parent)
        grubThemingIconAnim->start();
     });
 
-    connect(grubThemingToggleButton, &QPushButton::clicked, [=]() mutable {
-        isGrubThemeEnabled = !isGrubThemeEnabled;
-
-        coreInitial->setGrubTheme();
+    statusProber->whenReady(grubThemingProbe, this, [=](bool isGrubThemeEnabled) {
+        qDebug() << "grubThemeStatus: " << isGrubThemeEnabled;
 
-        if (isGrubThemeEnabled) {
-            grubThemingToggleAnimation->setEndValue(QPoint(32, 2));
-            grubThemingToggleSwitch->setStyleSheet("QWidget { background-color: #4a9eff; border-radius: 15px; }");
-        } else {
-            grubThemingToggleAnimation->setEndValue(QPoint(2, 2));
-            grubThemingToggleSwitch->setStyleSheet("QWidget { background-color: #666666; border-radius: 15px; }");
-        }
-        grubThemingLabel->setText(isGrubThemeEnabled ? "Disabled Grub theming" :
+        grubThemingLabel->setText(isGrubThemeEnabled ? "Disable Grub theming" :
             "Enable Grub theming");
-        grubThemingToggleAnimation->start();
+        settleToggle(grubThemingToggleSwitch, grubThemingToggleButton,
+            grubThemingToggleAnimation, isGrubThemeEnabled);
+
+        connect(grubThemingToggleButton, &QPushButton::clicked, [=]() mutable {
+            isGrubThemeEnabled = !isGrubThemeEnabled;
+
+            coreInitial->setGrubTheme();
+
+            if (isGrubThemeEnabled) {
+                grubThemingToggleAnimation->setEndValue(QPoint(32, 2));
+                grubThemingToggleSwitch->setStyleSheet("QWidget { background-color: #4a9eff; border-radius: 15px; }");
+            } else {
+                grubThemingToggleAnimation->setEndValue(QPoint(2, 2));
+                grubThemingToggleSwitch->setStyleSheet("QWidget { background-color: #666666; border-radius: 15px; }");
+            }
+            grubThemingLabel->setText(isGrubThemeEnabled ? "Disabled Grub theming" :
+                "Enable Grub theming");
+            grubThemingToggleAnimation->start();
+        });
     });
     grubThemingContainer->setFixedWidth(500);
 
@@ -986,9 +968,7 @@ Widget_Initial::Widget_Initial(QWidget *parent)
         Qt::SmoothTransformation);
     yayIconLabel->setPixmap(yayIconScaled);
 
-    bool isYayEnabled = coreInitial->aurStatus(QString("yay"));
-    QLabel *yayLabel = new QLabel((isYayEnabled) ? "Disable/Remove Yay" :
-        "Enable/Install Yay", this);
+    QLabel *yayLabel = new QLabel("Checking Yay...", this);
     QWidget *yayToggleSwitch = new QWidget(this);
     yayToggleSwitch->setFixedSize(60, 30);
     QPushButton *yayToggleButton = new QPushButton(yayToggleSwitch);
@@ -997,13 +977,7 @@ Widget_Initial::Widget_Initial(QWidget *parent)
         "QPushButton { background-color: white; border-radius: 13px; border: none; }"
     );
 
-    if (isYayEnabled) {
-        yayToggleSwitch->setStyleSheet("QWidget { background-color: #4a9eff; border-radius: 15px; }");
-        yayToggleButton->move(32, 2);
-    } else {
-        yayToggleSwitch->setStyleSheet("QWidget { background-color: #666666; border-radius: 15px; }");
-        yayToggleButton->move(2, 2);
-    }
+    setToggleLoading(yayToggleSwitch, yayToggleButton);
 
     QPropertyAnimation *yayToggleAnimation = new QPropertyAnimation(yayToggleButton, "pos");
     yayToggleAnimation->setDuration(500);
@@ -1028,7 +1002,7 @@ Widget_Initial::Widget_Initial(QWidget *parent)
     connect(yayToggleButton, &QPushButton::clicked, [=]() mutable {
         coreInitial->getRemoveAUR(this, QString("yay"), [=](bool success) mutable {
             if (success) {
-                isYayEnabled = coreInitial->aurStatus(QString("yay"));
+                bool isYayEnabled = coreInitial->aurStatus(QString("yay"));
 
                 if (isYayEnabled) {
                     yayToggleAnimation->setEndValue(QPoint(32, 2));
@@ -1047,6 +1021,11 @@ Widget_Initial::Widget_Initial(QWidget *parent)
         });
     });
 
+    statusProber->whenReady(yayProbe, this, [=](bool isYayEnabled) {
+        yayLabel->setText(isYayEnabled ? "Disable/Remove Yay" : "Enable/Install Yay");
+        settleToggle(yayToggleSwitch, yayToggleButton, yayToggleAnimation, isYayEnabled);
+    });
+
     yayContainer->setFixedWidth(500);
     yayLayout->addWidget(yayIconLabel);
     yayLayout->addWidget(yayLabel);
@@ -1065,9 +1044,7 @@ Widget_Initial::Widget_Initial(QWidget *parent)
         Qt::SmoothTransformation);
     paruIconLabel->setPixmap(paruIconScaled);
 
-    bool isParuEnabled = coreInitial->aurStatus(QString("paru"));
-    QLabel *paruLabel = new QLabel((isParuEnabled) ? "Disable/Remove Paru" :
-        "Enable/Install Paru", this);
+    QLabel *paruLabel = new QLabel("Checking Paru...", this);
     QWidget *paruToggleSwitch = new QWidget(this);
     paruToggleSwitch->setFixedSize(60, 30);
     QPushButton *paruToggleButton = new QPushButton(paruToggleSwitch);
@@ -1076,17 +1053,7 @@ Widget_Initial::Widget_Initial(QWidget *parent)
         "QPushButton { background-color: white; border-radius: 13px; border: none; }"
     );
 
-    if (isParuEnabled) {
-        paruToggleSwitch->setStyleSheet(
-            "QWidget { background-color: #4a9eff; border-radius: 15px; }"
-        );
-        paruToggleButton->move(32, 2);
-    } else {
-        paruToggleSwitch->setStyleSheet(
-            "QWidget { background-color: #666666; border-radius: 15px; }"
-        );
-        paruToggleButton->move(2, 2);
-    }
+    setToggleLoading(paruToggleSwitch, paruToggleButton);
 
     QPropertyAnimation *paruToggleAnimation = new QPropertyAnimation(paruToggleButton, "pos");
     paruToggleAnimation->setDuration(500);
@@ -1111,7 +1078,7 @@ Widget_Initial::Widget_Initial(QWidget *parent)
     connect(paruToggleButton, &QPushButton::clicked, [=]() mutable {
         coreInitial->getRemoveAUR(this, QString("paru"), [=](bool success) mutable {
             if (success) {
-                isParuEnabled = coreInitial->aurStatus(QString("paru"));
+                bool isParuEnabled = coreInitial->aurStatus(QString("paru"));
 
                 if (isParuEnabled) {
                     paruToggleAnimation->setEndValue(QPoint(32, 2));
@@ -1131,6 +1098,11 @@ Widget_Initial::Widget_Initial(QWidget *parent)
         });
     });
 
+    statusProber->whenReady(paruProbe, this, [=](bool isParuEnabled) {
+        paruLabel->setText(isParuEnabled ? "Disable/Remove Paru" : "Enable/Install Paru");
+        settleToggle(paruToggleSwitch, paruToggleButton, paruToggleAnimation, isParuEnabled);
+    });
+
     paruContainer->setFixedWidth(500);
 
     paruContainerLayout->addWidget(paruIconLabel);
@@ -1151,9 +1123,7 @@ Widget_Initial::Widget_Initial(QWidget *parent)
         Qt::SmoothTransformation);
     tolitoIconLabel->setPixmap(tolitoIconScaled);
 
-    bool isTolitoEnabled = coreInitial->aurStatus(QString("tolito"));
-    QLabel *tolitoLabel = new QLabel((isTolitoEnabled) ? "Disable/Remove Tolito" :
-        "Enable/Install Tolito", this);
+    QLabel *tolitoLabel = new QLabel("Checking Tolito...", this);
 
     QWidget *tolitoToggleSwitch = new QWidget(this);
     tolitoToggleSwitch->setFixedSize(60, 30);
@@ -1163,17 +1133,7 @@ Widget_Initial::Widget_Initial(QWidget *parent)
         "QPushButton { background-color: white; border-radius: 13px; border: none }"
     );
 
-    if (isTolitoEnabled) {
-        tolitoToggleSwitch->setStyleSheet(
-            "QWidget { background-color: #4a9eff; border-radius: 15px; }"
-        );
-        tolitoToggleButton->move(32, 2);
-    } else {
-        tolitoToggleSwitch->setStyleSheet(
-            "QWidget { background-color: #666666; border-radius: 15px; }"
-        );
-        paruToggleButton->move(2, 2);
-    }
+    setToggleLoading(tolitoToggleSwitch, tolitoToggleButton);
 
     QPropertyAnimation *tolitoToggleAnimation = new QPropertyAnimation(tolitoToggleButton, "pos");
     tolitoToggleAnimation->setDuration(500);
@@ -1198,7 +1158,7 @@ Widget_Initial::Widget_Initial(QWidget *parent)
     connect(tolitoToggleButton, &QPushButton::clicked, [=]() mutable {
         coreInitial->getRemoveAUR(this, QString("tolito"), [=](bool success) mutable {
            if (success) {
-               isTolitoEnabled = coreInitial->aurStatus(QString("tolito"));
+               bool isTolitoEnabled = coreInitial->aurStatus(QString("tolito"));
 
                if (isTolitoEnabled) {
                    tolitoToggleAnimation->setEndValue(QPoint(32, 2));
@@ -1218,6 +1178,11 @@ Widget_Initial::Widget_Initial(QWidget *parent)
         });
     });
 
+    statusProber->whenReady(tolitoProbe, this, [=](bool isTolitoEnabled) {
+        tolitoLabel->setText(isTolitoEnabled ? "Disable/Remove Tolito" : "Enable/Install Tolito");
+        settleToggle(tolitoToggleSwitch, tolitoToggleButton, tolitoToggleAnimation, isTolitoEnabled);
+    });
+
     tolitoContainer->setMinimumWidth(500);
 
     tolitoContainerLayout->addWidget(tolitoIconLabel);
@@ -1300,9 +1265,7 @@ Widget_Initial::Widget_Initial(QWidget *parent)
         Qt::SmoothTransformation);
     discoverIconLabel->setPixmap(discoverIconScaled);
 
-    bool isDiscoverEnabled = coreInitial->storeStatus(QString("discover"));
-    QLabel *discoverLabel = new QLabel((isDiscoverEnabled) ? "Disable/Remove Discover" :
-        "Enable/Install Discover", this);
+    QLabel *discoverLabel = new QLabel("Checking Discover...", this);
 
     QWidget *discoverToggleSwitch = new QWidget(this);
     discoverToggleSwitch->setFixedSize(60, 30);
@@ -1313,17 +1276,7 @@ Widget_Initial::Widget_Initial(QWidget *parent)
         "QPushButton { background-color: white; border-radius: 13px; border: none; }"
     );
 
-    if (isDiscoverEnabled) {
-        discoverToggleSwitch->setStyleSheet(
-            "QWidget { background-color: #4a9eff; border-radius: 15px; }"
-        );
-        discoverToggleButton->move(32, 2);
-    } else {
-        discoverToggleSwitch->setStyleSheet(
-            "QWidget { background-color: #666666; border-radius: 15px; }"
-        );
-        discoverToggleButton->move(2, 2);
-    }
+    setToggleLoading(discoverToggleSwitch, discoverToggleButton);
 
     QPropertyAnimation *discoverToggleAnimation = new
     QPropertyAnimation(discoverToggleButton, "pos");
@@ -1350,7 +1303,7 @@ Widget_Initial::Widget_Initial(QWidget *parent)
     connect(discoverToggleButton, &QPushButton::clicked, [=]() mutable {
         coreInitial->getRemoveStore(this, QString("discover"), [=](bool success) mutable {
             if (success) {
-                isDiscoverEnabled = coreInitial->storeStatus(QString("discover"));
+                bool isDiscoverEnabled = coreInitial->storeStatus(QString("discover"));
 
                 if (isDiscoverEnabled) {
                     discoverToggleAnimation->setEndValue(QPoint(32, 2));
@@ -1369,6 +1322,11 @@ Widget_Initial::Widget_Initial(QWidget *parent)
             }
         });
     });
+    statusProber->whenReady(discoverProbe, this, [=](bool isDiscoverEnabled) {
+        discoverLabel->setText(isDiscoverEnabled ? "Disable/Remove Discover" : "Enable/Install Discover");
+        settleToggle(discoverToggleSwitch, discoverToggleButton, discoverToggleAnimation, isDiscoverEnabled);
+    });
+
     discoverContainer->setFixedWidth(500);
 
     discoverLayout->addWidget(discoverIconLabel);
@@ -1389,10 +1347,8 @@ Widget_Initial::Widget_Initial(QWidget *parent)
         Qt::SmoothTransformation);
     pamacIconLabel->setPixmap(pamacIconScaled);
 
-    bool isPamacEnabled = coreInitial->storeStatus("pamac-all");
 
-    QLabel *pamacLabel = new QLabel((isPamacEnabled) ? "Disable/Remove Pamac All" :
-    "Enable/Install Pamac All", this);
+    QLabel *pamacLabel = new QLabel("Checking Pamac All...", this);
 
     QWidget *pamacToggleSwitch = new QWidget(this);
     pamacToggleSwitch->setFixedSize(60, 30);
@@ -1402,16 +1358,7 @@ Widget_Initial::Widget_Initial(QWidget *parent)
         "QPushButton { background-color: white; border-radius: 13px; border: none; }"
     );
 
-    if (isPamacEnabled) {
-        pamacToggleSwitch->setStyleSheet(
-            "QWidget { background-color: #4a9eff; border-radius: 15px; }");
-        pamacToggleButton->move(32, 2);
-    } else {
-        pamacToggleSwitch->setStyleSheet(
-            "QWidget { background-color: #666666; border-radius: 15px; }"
-        );
-        pamacToggleButton->move(2, 2);
-    }
+    setToggleLoading(pamacToggleSwitch, pamacToggleButton);
 
     QPropertyAnimation *pamacToggleAnimation = new
     QPropertyAnimation(pamacToggleButton, "pos");
@@ -1438,7 +1385,7 @@ Widget_Initial::Widget_Initial(QWidget *parent)
     connect(pamacToggleButton, &QPushButton::clicked, [=]() mutable {
         coreInitial->getRemoveStore(this, QString("pamac-all"), [=](bool success) mutable {
             if (success) {
-                isPamacEnabled = coreInitial->storeStatus(QString("pamac-all"));
+                bool isPamacEnabled = coreInitial->storeStatus(QString("pamac-all"));
                 if (isPamacEnabled) {
                     pamacToggleAnimation->setEndValue(QPoint(32, 2));
                     pamacToggleSwitch->setStyleSheet(
@@ -1456,6 +1403,11 @@ Widget_Initial::Widget_Initial(QWidget *parent)
             }
         });
     });
+    statusProber->whenReady(pamacProbe, this, [=](bool isPamacEnabled) {
+        pamacLabel->setText(isPamacEnabled ? "Disable/Remove Pamac All" : "Enable/Install Pamac All");
+        settleToggle(pamacToggleSwitch, pamacToggleButton, pamacToggleAnimation, isPamacEnabled);
+    });
+
     pamacContainer->setFixedWidth(500);
 
     pamacContainerLayout->addWidget(pamacIconLabel);
@@ -1475,9 +1427,7 @@ Widget_Initial::Widget_Initial(QWidget *parent)
         Qt::SmoothTransformation);
     octopiIconLabel->setPixmap(octopiIconScaled);
 
-    bool isOctopiEnabled = coreInitial->storeStatus(QString("octopi"));
-    QLabel *octopiLabel = new QLabel((isOctopiEnabled) ? "Disable/Remove Octopi" :
-       "Enable/Install Octopi", this);
+    QLabel *octopiLabel = new QLabel("Checking Octopi...", this);
 
     QWidget *octopiToggleSwitch = new QWidget(this);
     octopiToggleSwitch->setFixedSize(60, 30);
@@ -1487,16 +1437,7 @@ Widget_Initial::Widget_Initial(QWidget *parent)
         "QPushButton { background-color: white; border-radius: 13px; border: none; }"
     );
 
-    if (isOctopiEnabled) {
-        octopiToggleSwitch->setStyleSheet(
-            "QWidget { background-color: #4a9eff; border-radius: 15px; }");
-        octopiToggleButton->move(32, 2);
-    } else {
-        octopiToggleSwitch->setStyleSheet(
-            "QWidget { background-color: #666666; border-radius: 15px; }"
-        );
-        octopiToggleButton->move(2, 2);
-    }
+    setToggleLoading(octopiToggleSwitch, octopiToggleButton);
 
     QPropertyAnimation *octopiToggleAnimation = new
     QPropertyAnimation(octopiToggleButton, "pos");
@@ -1523,7 +1464,7 @@ Widget_Initial::Widget_Initial(QWidget *parent)
     connect(octopiToggleButton, &QPushButton::clicked, [=]() mutable {
         coreInitial->getRemoveStore(this, QString("octopi"), [=](bool success) mutable {
             if (success) {
-                isOctopiEnabled = coreInitial->storeStatus(QString("octopi"));
+                bool isOctopiEnabled = coreInitial->storeStatus(QString("octopi"));
                 if (isOctopiEnabled) {
                     octopiToggleAnimation->setEndValue(QPoint(32, 2));
                     octopiToggleSwitch->setStyleSheet(
@@ -1541,6 +1482,11 @@ Widget_Initial::Widget_Initial(QWidget *parent)
             }
         });
     });
+    statusProber->whenReady(octopiProbe, this, [=](bool isOctopiEnabled) {
+        octopiLabel->setText(isOctopiEnabled ? "Disable/Remove Octopi" : "Enable/Install Octopi");
+        settleToggle(octopiToggleSwitch, octopiToggleButton, octopiToggleAnimation, isOctopiEnabled);
+    });
+
     octopiContainer->setFixedWidth(500);
 
     octopiContainerLayout->addWidget(octopiIconLabel);
@@ -1561,9 +1507,7 @@ Widget_Initial::Widget_Initial(QWidget *parent)
         Qt::SmoothTransformation);
     bazaarIconLabel->setPixmap(bazaarIconScaled);
 
-    bool isBazaarEnabled = coreInitial->storeStatus(QString("bazaar"));
-    QLabel *bazaarLabel = new QLabel((isBazaarEnabled) ? "Disable/Remove Bazaar" :
-        "Enable/Install Bazaar", this);
+    QLabel *bazaarLabel = new QLabel("Checking Bazaar...", this);
 
     QWidget *bazaarToggleSwitch = new QWidget(this);
     bazaarToggleSwitch->setFixedSize(60, 30);
@@ -1573,17 +1517,7 @@ Widget_Initial::Widget_Initial(QWidget *parent)
         "QPushButton { background-color: white; border-radius: 13px; border: none }"
     );
 
-    if (isBazaarEnabled) {
-        bazaarToggleSwitch->setStyleSheet(
-            "QWidget { background-color: #4a9eff; border-radius: 15px; }"
-        );
-        bazaarToggleButton->move(32, 2);
-    } else {
-        bazaarToggleSwitch->setStyleSheet(
-            "QWidget { background-color: #666666; border-radius: 15px; }"
-        );
-        bazaarToggleButton->move(2, 2);
-    }
+    setToggleLoading(bazaarToggleSwitch, bazaarToggleButton);
 
     QPropertyAnimation *bazaarToggleAnimation = new
     QPropertyAnimation(bazaarToggleButton, "pos");
@@ -1610,7 +1544,7 @@ Widget_Initial::Widget_Initial(QWidget *parent)
     connect(bazaarToggleButton, &QPushButton::clicked, [=]() mutable {
         coreInitial->getRemoveStore(this, QString("bazaar"), [=](bool success) mutable {
             if (success) {
-                isBazaarEnabled = coreInitial->storeStatus(QString("bazaar"));
+                bool isBazaarEnabled = coreInitial->storeStatus(QString("bazaar"));
 
                 if (isBazaarEnabled) {
                     bazaarToggleAnimation->setEndValue(QPoint(32, 2));
@@ -1629,6 +1563,11 @@ Widget_Initial::Widget_Initial(QWidget *parent)
             }
         });
     });
+    statusProber->whenReady(bazaarProbe, this, [=](bool isBazaarEnabled) {
+        bazaarLabel->setText(isBazaarEnabled ? "Disable/Remove Bazaar" : "Enable/Install Bazaar");
+        settleToggle(bazaarToggleSwitch, bazaarToggleButton, bazaarToggleAnimation, isBazaarEnabled);
+    });
+
     bazaarContainer->setFixedWidth(500);
 
     bazaarContainerLayout->addWidget(bazaarIconLabel);
@@ -1715,11 +1654,8 @@ Widget_Initial::Widget_Initial(QWidget *parent)
 
     gamingLayout->addWidget(gamingMetaDesc, 0, Qt::AlignCenter);
 
-    bool gamingMetaStatus = coreInitial->gamingMetaStatus();
-    qDebug() << "gamingMetaStatus-before-logic: " << gamingMetaStatus;
-
-    QPushButton *arch7zGamingButton = new QPushButton((gamingMetaStatus) ?
-        "Remove Arch7z Gaming Meta" : "Get Arch7z Gaming Meta", this);
+    QPushButton *arch7zGamingButton = new QPushButton("Checking Arch7z Gaming Meta...", this);
+    arch7zGamingButton->setEnabled(false);
 
     arch7zGamingButton->setCursor(Qt::PointingHandCursor);
     arch7zGamingButton->setStyleSheet(
@@ -1740,7 +1676,7 @@ Widget_Initial::Widget_Initial(QWidget *parent)
     connect(arch7zGamingButton, &QPushButton::clicked, [=]() mutable {
         coreInitial->getArch7zGamingMeta(this, [=](bool success) mutable {
             if (success) {
-                gamingMetaStatus = coreInitial->gamingMetaStatus();
+                bool gamingMetaStatus = coreInitial->gamingMetaStatus();
 
                 arch7zGamingButton->setText((gamingMetaStatus) ? "Remove Arch7z Gaming Meta" :
                     "Get Arch7z Gaming Meta");
@@ -1748,6 +1684,14 @@ Widget_Initial::Widget_Initial(QWidget *parent)
         });
     });
 
+    statusProber->whenReady(gamingMetaProbe, this, [=](bool gamingMetaStatus) {
+        qDebug() << "gamingMetaStatus-before-logic: " << gamingMetaStatus;
+
+        arch7zGamingButton->setText((gamingMetaStatus) ? "Remove Arch7z Gaming Meta" :
+            "Get Arch7z Gaming Meta");
+        arch7zGamingButton->setEnabled(true);
+    });
+
     gamingLayout->addWidget(arch7zGamingButton, 0, Qt::AlignCenter);
     gamingLayout->addStretch(1);
 
@@ -2212,6 +2156,31 @@ Widget_Initial::Widget_Initial(QWidget *parent)
 Widget_Initial::~Widget_Initial()
 {
     // delete ui; // Commented out - no UI file
+
+    // Probes use coreInitial and this widget; let the pool drain before any
+    // of it (or a child such as coreFunctions) is torn down
+    statusProber->waitForDone();
+}
+
+// * === TOGGLE PLACEHOLDERS
+void Widget_Initial::setToggleLoading(QWidget *toggleSwitch, QPushButton *toggleButton) {
+    // Knob parked in the middle of a dimmed track until the probe answers
+    toggleSwitch->setStyleSheet("QWidget { background-color: #3a3a3a; border-radius: 15px; }");
+    toggleButton->move(17, 2);
+    toggleButton->setEnabled(false);
+}
+
+void Widget_Initial::settleToggle(QWidget *toggleSwitch, QPushButton *toggleButton,
+    QPropertyAnimation *toggleAnimation, bool enabled) {
+    if (enabled) {
+        toggleAnimation->setEndValue(QPoint(32, 2));
+        toggleSwitch->setStyleSheet("QWidget { background-color: #4a9eff; border-radius: 15px; }");
+    } else {
+        toggleAnimation->setEndValue(QPoint(2, 2));
+        toggleSwitch->setStyleSheet("QWidget { background-color: #666666; border-radius: 15px; }");
+    }
+    toggleAnimation->start();
+    toggleButton->setEnabled(true);
 }
 
 void Widget_Initial::closeEvent(QCloseEvent *event) {
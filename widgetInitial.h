@@ -3,7 +3,8 @@
 
 #include "core_functions.h"
 #include "core_initial.h"
-#include "widget.h"
+#include "core_services.h"
+#include "status_prober.h"
 #include <QWidget>
 #include <QIcon>
 #include <QPushButton>
@@ -13,6 +14,7 @@
 #include <QCheckBox>
 #include <QBoxLayout>
 #include <QCloseEvent>
+#include <QPropertyAnimation>
 
 class Widget_Initial : public QWidget
 {
@@ -31,10 +33,14 @@ protected:
 //         QPushButton *flatpakToggleButton);
 
 private:
+    void setToggleLoading(QWidget *toggleSwitch, QPushButton *toggleButton);
+    void settleToggle(QWidget *toggleSwitch, QPushButton *toggleButton,
+        QPropertyAnimation *toggleAnimation, bool enabled);
 
 CoreFunctions* coreFunctions;
-Widget* widget;
+CoreServices* coreServices;
 CoreInitial* coreInitial;
+StatusProber* statusProber;
 
 };
 #endif